@@ -0,0 +1,39 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <nba/integer.hpp>
+#include <stddef.h>
+
+namespace fs = std::filesystem;
+
+namespace nba {
+
+enum class WriteFileResult {
+  CannotOpenFile,
+  CannotWrite,
+  CannotReplaceFile,
+  Success
+};
+
+/**
+ * Replaces the contents of a file. The data is written to a temporary file in the same directory,
+ * which is flushed to disk before it is renamed over the file. After a crash or power loss the file
+ * holds either the old or the new contents. Temporary files are named uniquely per process and call,
+ * so that several writers of the same file do not interfere with each other (the last rename wins).
+ */
+auto WriteFileAtomic(fs::path const& path, void const* data, size_t size) -> WriteFileResult;
+
+// Overwrites part of an existing file and waits until the data has been flushed to disk.
+auto WriteFileInPlace(fs::path const& path, u64 offset, void const* data, size_t size) -> WriteFileResult;
+
+// True for the temporary files created by WriteFileAtomic(), e.g. to clean up after a crash.
+auto IsAtomicWriteTemporaryFile(fs::path const& path) -> bool;
+
+} // namespace nba
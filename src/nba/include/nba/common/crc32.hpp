@@ -5,28 +5,31 @@
  * Refer to the included LICENSE file.
  */
 
+#pragma once
+
 #include <nba/integer.hpp>
+#include <stddef.h>
 
 namespace nba {
 
-inline u32 crc32(u8 const* data, int length) {
-  u32 crc32 = 0xFFFFFFFF;
-
-  while(length-- != 0) {
-    u8 byte = *data++;
-
-    // TODO: speed this up using a lookup table.
-    for(int i = 0; i < 8; i++) {
-      if((crc32 ^ byte) & 1) {
-        crc32 = (crc32 >> 1) ^ 0xEDB88320;
-      } else {
-        crc32 >>= 1;
-      }
-      byte >>= 1;
-    }
-  }
-
-  return ~crc32;
-}
+enum class CRC32Method {
+  Bitwise,   // reference implementation, one bit at a time
+  SliceBy8,  // eight table lookups per eight bytes
+  SliceBy16, // sixteen table lookups per sixteen bytes
+  PCLMUL,    // x86 carry-less multiplication (PCLMULQDQ)
+  ARMv8      // ARMv8 CRC32 instructions
+};
+
+// Returns true if the method is compiled in and supported by the CPU.
+auto IsCRC32MethodSupported(CRC32Method method) -> bool;
+
+// The fastest method supported by the CPU, selected on the first call.
+auto GetCRC32Method() -> CRC32Method;
+
+// CRC-32 (polynomial 0xEDB88320, as used by zlib and PNG) using the given method.
+auto crc32(CRC32Method method, u8 const* data, size_t length) -> u32;
+
+// CRC-32 using the fastest supported method.
+auto crc32(u8 const* data, size_t length) -> u32;
 
 } // namespace nba
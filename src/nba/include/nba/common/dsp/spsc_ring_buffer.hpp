@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+namespace nba {
+
+/**
+ * Lock-free ring buffer for exactly one producer and one consumer thread.
+ * Writes to a full buffer are dropped.
+ */
+template<typename T>
+struct SPSCRingBuffer {
+  SPSCRingBuffer(int min_length) {
+    length = 1;
+    while(length < min_length) length <<= 1;
+    data = std::make_unique<T[]>(length);
+  }
+
+  auto Available() const -> int {
+    return int(wr_ptr.load(std::memory_order_acquire) - rd_ptr.load(std::memory_order_acquire));
+  }
+
+  bool Write(T const& value) {
+    const auto wr = wr_ptr.load(std::memory_order_relaxed);
+
+    if(wr - rd_ptr.load(std::memory_order_acquire) == (size_t)length) {
+      return false;
+    }
+
+    data[wr & (length - 1)] = value;
+    wr_ptr.store(wr + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool Read(T& value) {
+    const auto rd = rd_ptr.load(std::memory_order_relaxed);
+
+    if(rd == wr_ptr.load(std::memory_order_acquire)) {
+      return false;
+    }
+
+    value = data[rd & (length - 1)];
+    rd_ptr.store(rd + 1, std::memory_order_release);
+    return true;
+  }
+
+private:
+  std::unique_ptr<T[]> data;
+  int length;
+
+  std::atomic<size_t> rd_ptr = 0;
+  std::atomic<size_t> wr_ptr = 0;
+};
+
+} // namespace nba
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <nba/common/punning.hpp>
+#include <nba/integer.hpp>
+#include <stddef.h>
+
+namespace nba {
+
+namespace detail {
+
+constexpr u64 kHashPrime1 = 0x9E3779B185EBCA87ULL;
+constexpr u64 kHashPrime2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr u64 kHashPrime3 = 0x165667B19E3779F9ULL;
+constexpr u64 kHashPrime4 = 0x85EBCA77C2B2AE63ULL;
+constexpr u64 kHashPrime5 = 0x27D4EB2F165667C5ULL;
+
+constexpr auto hash_rotl(u64 value, int shift) -> u64 {
+  return (value << shift) | (value >> (64 - shift));
+}
+
+constexpr auto hash_round(u64 value) -> u64 {
+  return hash_rotl(value * kHashPrime2, 31) * kHashPrime1;
+}
+
+} // namespace detail
+
+/**
+ * Fast non-cryptographic 64-bit hash (the short-input path of XXH64).
+ * The result is the same on all hosts of the same endianness.
+ */
+inline auto hash64(void const* data, size_t size, u64 seed = 0) -> u64 {
+  using namespace detail;
+
+  auto bytes = (u8 const*)data;
+  u64 hash = seed + kHashPrime5 + size;
+
+  while(size >= sizeof(u64)) {
+    hash ^= hash_round(read<u64>(bytes, 0));
+    hash = hash_rotl(hash, 27) * kHashPrime1 + kHashPrime4;
+    bytes += sizeof(u64);
+    size -= sizeof(u64);
+  }
+
+  if(size >= sizeof(u32)) {
+    hash ^= read<u32>(bytes, 0) * kHashPrime1;
+    hash = hash_rotl(hash, 23) * kHashPrime2 + kHashPrime3;
+    bytes += sizeof(u32);
+    size -= sizeof(u32);
+  }
+
+  while(size-- != 0) {
+    hash ^= *bytes++ * kHashPrime5;
+    hash = hash_rotl(hash, 11) * kHashPrime1;
+  }
+
+  hash ^= hash >> 33;
+  hash *= kHashPrime2;
+  hash ^= hash >> 29;
+  hash *= kHashPrime3;
+  hash ^= hash >> 32;
+  return hash;
+}
+
+// Combines two hashes, the result depends on the order of the arguments.
+constexpr auto hash_combine(u64 hash, u64 value) -> u64 {
+  using namespace detail;
+
+  hash ^= hash_round(value);
+  return hash_rotl(hash, 27) * kHashPrime1 + kHashPrime4;
+}
+
+} // namespace nba
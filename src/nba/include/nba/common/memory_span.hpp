@@ -0,0 +1,21 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <nba/integer.hpp>
+#include <stddef.h>
+
+namespace nba {
+
+// A read-only view of emulated memory.
+struct MemorySpan {
+  u8 const* data = nullptr;
+  size_t size = 0;
+};
+
+} // namespace nba
@@ -12,6 +12,7 @@
 #include <nba/device/input_device.hpp>
 #include <nba/device/video_device.hpp>
 #include <nba/integer.hpp>
+#include <nba/stem_capture.hpp>
 #include <string>
 
 namespace nba {
@@ -19,6 +20,16 @@ namespace nba {
 struct Config {
   bool skip_bios = false;
 
+  // Process timer overflows that neither raise an IRQ nor clock another timer lazily and in batches.
+  bool timer_coalescing = true;
+
+  /**
+   * If non-zero, the real-time clock shows this time (seconds since the Unix epoch, UTC) at power-on
+   * and advances with the emulated time. Otherwise it follows the host clock.
+   * A fixed seed makes emulation of games with a real-time clock reproducible.
+   */
+  s64 rtc_seed = 0;
+
   enum class BackupType {
     Detect,
     None,
@@ -30,6 +41,18 @@ struct Config {
     EEPROM_DETECT // for internal use
   };
 
+  struct SaveFile {
+    enum class WriteMode {
+      WriteThrough, // every byte written by the game is written to the file immediately
+      WriteBack,    // writes are collected and the file is replaced atomically (temporary file + rename),
+                    // this breaks symbolic and hard links to the save file and resets its permissions
+      Journaled     // writes are collected and written in place, after saving them to a journal file
+    } write_mode = WriteMode::Journaled;
+
+    // Unsaved changes are written after at most this many milliseconds, even while the game is still saving.
+    int flush_interval = 1000;
+  } save_file;
+
   struct Audio {
     enum class Interpolation {
       Cosine,
@@ -49,6 +72,9 @@ struct Config {
   std::shared_ptr<AudioDevice> audio_dev = std::make_shared<NullAudioDevice>();
   std::shared_ptr<InputDevice> input_dev = std::make_shared<NullInputDevice>();
   std::shared_ptr<VideoDevice> video_dev = std::make_shared<NullVideoDevice>();
+
+  // Optional: receives the individual audio channels before they are mixed.
+  std::shared_ptr<StemCapture> stem_capture;
 };
 
 } // namespace nba
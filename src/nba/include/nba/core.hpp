@@ -8,6 +8,7 @@
 #pragma once
 
 #include <memory>
+#include <nba/common/memory_span.hpp>
 #include <nba/rom/gpio/rtc.hpp>
 #include <nba/rom/gpio/solar_sensor.hpp>
 #include <nba/rom/rom.hpp>
@@ -19,6 +20,21 @@
 
 namespace nba {
 
+/**
+ * Caller-owned storage for CoreBase::Snapshot(). Besides the save state it holds
+ * the MP2K HLE mixer, which is not part of save states.
+ */
+struct SnapshotData {
+  static constexpr size_t kMixerStateSize = 0x10000;
+
+  SaveState state;
+  u8 mixer[kMixerStateSize];
+};
+
+inline auto MakeSnapshotData() -> std::unique_ptr<SnapshotData> {
+  return std::make_unique<SnapshotData>();
+}
+
 struct CoreBase {
   static constexpr int kCyclesPerFrame = 280896;
 
@@ -32,8 +48,52 @@ struct CoreBase {
   virtual auto CreateSolarSensor() -> std::unique_ptr<SolarSensor> = 0;
   virtual void LoadState(SaveState const& state) = 0;
   virtual void CopyState(SaveState& state) = 0;
+
+  /**
+   * Like LoadState() and CopyState(), but only the memory pages that were written
+   * since the last state load or copy are transferred. This requires that `state`
+   * is the same state which the last load or copy operated on.
+   */
+  virtual void LoadStateIncremental(SaveState const& state) = 0;
+  virtual void CopyStateIncremental(SaveState& state) = 0;
+
+  /**
+   * Copies the state of the MP2K HLE mixer from or to SnapshotData::kMixerStateSize bytes.
+   * Loading a save state resets the mixer, so restoring one of these afterwards
+   * continues the audio as if emulation was never interrupted.
+   */
+  virtual void LoadMixerState(u8 const* data) = 0;
+  virtual void CopyMixerState(u8* data) = 0;
   virtual void Run(int cycles) = 0;
 
+  /**
+   * Returns a 64-bit hash of the emulator state, which is equal for two cores
+   * (or the same core at two points in time) if their states are equal.
+   * Memory (work RAM, palette RAM, OAM and VRAM) is hashed with hash trees over 256-byte pages,
+   * which are updated only for the pages written since the last call.
+   * The CPU, I/O registers, scheduler events and the cartridge state (backup memory, GPIO)
+   * are hashed on every call. Events are hashed by their timestamp, class and argument,
+   * but not by their UID, which depends on how many events were scheduled before.
+   */
+  virtual auto StateHash() -> u64 = 0;
+
+  /**
+   * Creates an independent copy of the core, which continues from the current state.
+   * The ROM image is shared between both cores and the cartridge backup of the clone
+   * is kept in memory, i.e. the clone never writes to the save file. The clone continues
+   * the audio of the MP2K HLE mixer, which is not part of save states.
+   * When no config is given, the clone uses a copy of the current config with
+   * null audio, input and video devices.
+   */
+  virtual auto Clone(std::shared_ptr<Config> config = nullptr) -> std::unique_ptr<CoreBase> = 0;
+
+  /**
+   * Suppresses the audio or video output without affecting emulation,
+   * e.g. for frames that are emulated speculatively (run-ahead).
+   */
+  virtual void SetAudioOutputEnable(bool enable) = 0;
+  virtual void SetVideoOutputEnable(bool enable) = 0;
+
   virtual auto GetROM() -> ROM& = 0;
   virtual auto GetPRAM() -> u8* = 0;
   virtual auto GetVRAM() -> u8* = 0;
@@ -46,9 +106,53 @@ struct CoreBase {
 
   virtual core::Scheduler& GetScheduler() = 0;
 
+  enum class MemoryRegion {
+    BIOS,
+    WRAM,
+    IRAM,
+    PRAM,
+    VRAM,
+    OAM,
+    ROM,
+    Backup, // SRAM, FLASH or EEPROM, empty if the cartridge has no backup memory
+    Count
+  };
+
+  /**
+   * Returns a read-only view of a memory region. Views stay valid until a BIOS or ROM is attached.
+   * They are read-only, since writes through them would bypass dirty page tracking.
+   */
+  virtual auto GetMemorySpan(MemoryRegion region) -> MemorySpan = 0;
+
+  struct MemoryRead {
+    u32 address;
+    int size; // 1, 2 or 4 bytes
+  };
+
+  /**
+   * Reads a list of little-endian values by guest address in one call, without bus timing or side effects.
+   * I/O registers are read like with PeekByteIO(). Cartridge backup memory is mapped linearly from 0x0E000000,
+   * regardless of the chip type. Unmapped bytes read as zero.
+   */
+  void Gather(MemoryRead const* reads, u32* values, size_t count);
+
   void RunForOneFrame() {
     Run(kCyclesPerFrame);
   }
+
+  static constexpr size_t kSnapshotSize = sizeof(SnapshotData);
+  static constexpr size_t kSnapshotAlignment = alignof(SnapshotData);
+
+  /**
+   * Serializes the emulator state into caller-owned storage, which must be at least
+   * kSnapshotSize bytes large and aligned to kSnapshotAlignment (see MakeSnapshotData()).
+   * Neither memory is allocated nor is file I/O performed, so that snapshots
+   * can be taken and restored repeatedly (for rewind, run-ahead etc.)
+   * Snapshots include the MP2K HLE mixer, so restoring one does not reset the audio.
+   * See LoadStateIncremental() for the requirements of incremental snapshots.
+   */
+  bool Snapshot(void* buffer, size_t size, bool incremental = false);
+  bool Restore(void const* buffer, size_t size, bool incremental = false);
 };
 
 auto CreateCore(
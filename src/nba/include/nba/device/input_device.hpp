@@ -56,7 +56,7 @@ struct BasicInputDevice : InputDevice {
   }
 private:
   std::function<void(void)> keypress_callback;
-  bool key_status[kKeyCount];
+  bool key_status[kKeyCount]{};
 };
 
 } // namespace nba
@@ -0,0 +1,31 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <nba/common/memory_span.hpp>
+#include <nba/config.hpp>
+#include <nba/integer.hpp>
+
+namespace nba {
+
+/**
+ * Information that can only be found by scanning the whole ROM.
+ * It only depends on the ROM contents, so it can be cached per ROM.
+ */
+struct ROMAnalysis {
+  // Address of the MP2K SoundMainRAM() function or 0xFFFFFFFF if it was not found.
+  u32 sound_main_ram = 0xFFFFFFFF;
+
+  // Backup type indicated by the first backup library ID (e.g. "FLASH1M_V") or Detect if there is none.
+  Config::BackupType backup_type = Config::BackupType::Detect;
+};
+
+// Finds everything in ROMAnalysis in a single pass over the ROM.
+auto AnalyzeROM(MemorySpan rom) -> ROMAnalysis;
+
+} // namespace nba
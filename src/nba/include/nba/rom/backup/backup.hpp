@@ -7,11 +7,16 @@
 
 #pragma once
 
+#include <memory>
+#include <nba/common/memory_span.hpp>
+#include <nba/config.hpp>
 #include <nba/integer.hpp>
 #include <nba/save_state.hpp>
 
 namespace nba { 
 
+struct CoreBase;
+
 struct Backup {
   virtual ~Backup() = default;
 
@@ -19,6 +24,18 @@ struct Backup {
   virtual auto Read (u32 address) -> u8 = 0;
   virtual void Write(u32 address, u8 value) = 0;
 
+  // Creates an in-memory copy of the backup for use with another core (see ROM::Clone).
+  virtual auto Clone(CoreBase& core) const -> std::unique_ptr<Backup> = 0;
+
+  // The raw contents of the backup memory, i.e. without any chip protocol.
+  virtual auto GetMemory() -> MemorySpan = 0;
+
+  // Sets how changes to the backup memory are written to the save file.
+  virtual void SetSaveFileOptions(Config::SaveFile const& options) = 0;
+
+  // Writes unsaved changes to the save file, if the game has finished saving or the flush interval has passed.
+  virtual void FlushIfDue() = 0;
+
   virtual void LoadState(SaveState const& state) = 0;
   virtual void CopyState(SaveState& state) = 0;
 };
@@ -8,63 +8,64 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <memory>
+#include <mutex>
+#include <nba/config.hpp>
 #include <nba/integer.hpp>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace fs = std::filesystem;
 
 namespace nba {
 
+/**
+ * The contents of a backup memory chip and the save file they are kept in.
+ *
+ * Except in WriteThrough mode, writes only mark the written range as dirty. The dirty range is
+ * written to the file once the game has completed saving (see Commit()), after the flush interval
+ * or when the BackupFile is destroyed, either by atomically replacing the file or in place,
+ * protected by a journal (see Config::SaveFile).
+ *
+ * Flushes that are due during emulation (see FlushIfDue()) only copy the dirty range on the
+ * calling thread, the file is written on a background thread, so that slow disks do not stall emulation.
+ */
 struct BackupFile {
-  static auto OpenOrCreate(fs::path const& save_path,
-                           std::vector<size_t> const& valid_sizes,
-                           int& default_size) -> std::unique_ptr<BackupFile> {
-    bool create = true;
-    auto flags = std::ios::binary | std::ios::in | std::ios::out;
+  using WriteMode = Config::SaveFile::WriteMode;
+
+  static auto OpenOrCreate(
+    fs::path const& save_path,
+    std::vector<size_t> const& valid_sizes,
+    int& default_size,
+    Config::SaveFile const& options = {}
+  ) -> std::unique_ptr<BackupFile>;
+
+  // Creates an empty backup which is not backed by a file, i.e. it is never written to disk.
+  static auto CreateInMemory(size_t size) -> std::unique_ptr<BackupFile> {
     std::unique_ptr<BackupFile> file { new BackupFile() };
 
-    // @todo: check file type and permissions?
-    if(fs::is_regular_file(save_path)) {
-      auto file_size = fs::file_size(save_path);
-
-      // allow for some extra/unused data; required for mGBA save compatibility
-      auto save_size = file_size & ~63u;
-
-      auto begin = valid_sizes.begin();
-      auto end = valid_sizes.end();
-
-      if(std::find(begin, end, save_size) != end) {
-        file->stream.open(save_path.c_str(), flags);
-        if(file->stream.fail()) {
-          throw std::runtime_error("BackupFile: unable to open file: " + save_path.string());
-        }
-        default_size = save_size;
-        file->save_size = save_size;
-        file->memory.reset(new u8[file_size]);
-        file->stream.read((char*)file->memory.get(), file_size);
-        create = false;
-      }
-    }
+    file->save_size = size;
+    file->file_size = size;
+    file->memory.reset(new u8[size]);
+    file->auto_update = false;
+    file->MemorySet(0, size, 0xFF);
+    return file;
+  }
 
-    /* A new save file is created either when no file exists yet,
-     * or when the existing file has an invalid size.
-     */
-    if(create) {
-      file->save_size = default_size;
-      file->stream.open(save_path, flags | std::ios::trunc);
-      if(file->stream.fail()) {
-        throw std::runtime_error("BackupFile: unable to create file: " + save_path.string());
-      }
-      file->memory.reset(new u8[default_size]);
-      file->MemorySet(0, default_size, 0xFF);
-    }
+ ~BackupFile();
 
+  auto Clone() const -> std::unique_ptr<BackupFile> {
+    auto file = CreateInMemory(save_size);
+
+    std::memcpy(file->memory.get(), memory.get(), save_size);
     return file;
   }
 
@@ -99,10 +100,40 @@ struct BackupFile {
     if((index + length) > save_size) {
       throw std::runtime_error("BackupFile: out-of-bounds index while updating file.");
     }
-    stream.seekg(index);
-    stream.write((char*)&memory[index], length);
+    if(write_mode == WriteMode::WriteThrough) {
+      UpdateFile(index, length);
+    } else if(dirty_begin >= dirty_end) {
+      dirty_begin = index;
+      dirty_end = index + length;
+      dirty_since = std::chrono::steady_clock::now();
+      committed = false;
+    } else {
+      dirty_begin = std::min(dirty_begin, (size_t)index);
+      dirty_end = std::max(dirty_end, index + length);
+    }
   }
 
+  // Called when the game has completed a write operation, e.g. a FLASH command or an EEPROM block.
+  void Commit() {
+    if(dirty_begin < dirty_end) {
+      commit_time = std::chrono::steady_clock::now();
+      committed = true;
+    }
+  }
+
+  // Queues the dirty range for writing, if the game seems to be done saving or the flush interval has passed.
+  void FlushIfDue() {
+    if(dirty_begin < dirty_end || write_failed) {
+      FlushIfDueSlow();
+    }
+  }
+
+  // Writes the dirty range to the file and returns once all queued writes have completed.
+  void Flush();
+
+  // Changes the write mode and flush interval, flushing unsaved changes first if necessary.
+  void SetOptions(Config::SaveFile const& options);
+
   auto Buffer() -> u8* {
     return memory.get();
   }
@@ -114,11 +145,57 @@ struct BackupFile {
   bool auto_update = true;
 
 private:
+  static constexpr u32 kJournalMagic = 0x4C4A424E; // "NBJL"
+
+  // How long the game must not have completed another write before a commit is flushed.
+  static constexpr auto kCommitDelay = std::chrono::milliseconds{100};
+
   BackupFile() { }
 
+  auto GetJournalPath() const -> fs::path;
+  void UpdateFile(unsigned index, size_t length);
+  void FlushIfDueSlow();
+  void QueueWrite();
+  void RetryFailedWrite();
+  void WaitForWriter();
+  void StopWriter();
+  void WriterThread();
+  auto WriteToFile(WriteMode write_mode, size_t begin, size_t end) -> bool;
+  auto ReplaceFile(u8 const* data) -> bool;
+  auto WriteJournaled(size_t begin, size_t end) -> bool;
+  void ReplayJournal();
+
+  fs::path save_path;
   size_t save_size;
+  size_t file_size; // may be larger than save_size, the extra data is kept as-is
   std::fstream stream;
   std::unique_ptr<u8[]> memory;
+
+  WriteMode write_mode = WriteMode::WriteThrough;
+  std::chrono::milliseconds flush_interval{1000};
+  size_t dirty_begin = 0;
+  size_t dirty_end = 0;
+  std::chrono::steady_clock::time_point dirty_since;
+  std::chrono::steady_clock::time_point commit_time;
+  bool committed = false;
+
+  // State shared with the writer thread, which is started by the first queued write.
+  std::thread writer_thread;
+  std::mutex writer_mutex;
+  std::condition_variable writer_cv_work;
+  std::condition_variable writer_cv_idle;
+  WriteMode queued_mode;
+  size_t queued_begin = 0;
+  size_t queued_end = 0;
+  std::vector<u8> queued_data; // copy of the queued range
+  size_t failed_begin = 0;
+  size_t failed_end = 0;
+  std::atomic_bool write_failed = false;
+  bool writer_busy = false;
+  bool writer_quit = false;
+
+  // The contents of the file as written by the writer thread, only accessed by that thread.
+  std::unique_ptr<u8[]> file_image;
 };
 
 } // namespace nba
@@ -26,6 +26,10 @@ struct EEPROM : Backup {
   void Reset() final;
   auto Read (u32 address) -> u8 final;
   void Write(u32 address, u8 value) final;
+  auto Clone(CoreBase& core) const -> std::unique_ptr<Backup> final;
+  auto GetMemory() -> MemorySpan final;
+  void SetSaveFileOptions(Config::SaveFile const& options) final;
+  void FlushIfDue() final;
   
   void LoadState(SaveState const& state) final;
   void CopyState(SaveState& state) final;
@@ -45,12 +49,15 @@ private:
     STATE_BUSY           = 1 << 8
   };
   
+  EEPROM(EEPROM const& other, core::Scheduler& scheduler);
+
   void ResetSerialBuffer();
 
   void OnReadyAfterWrite();
 
   int size;
   fs::path save_path;
+  Config::SaveFile save_file_options;
   std::unique_ptr<BackupFile> file;
 
   core::Scheduler& scheduler;
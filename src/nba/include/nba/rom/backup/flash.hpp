@@ -24,11 +24,16 @@ struct FLASH : Backup {
   void Reset() final;
   auto Read (u32 address) -> u8 final;
   void Write(u32 address, u8 value) final;
+  auto Clone(CoreBase& core) const -> std::unique_ptr<Backup> final;
+  auto GetMemory() -> MemorySpan final;
+  void SetSaveFileOptions(Config::SaveFile const& options) final;
+  void FlushIfDue() final;
 
   void LoadState(SaveState const& state) final;
   void CopyState(SaveState& state) final;
 
 private:
+  FLASH(FLASH const& other);
   
   enum Command {
     READ_CHIP_ID = 0x90,
@@ -47,6 +52,7 @@ private:
   
   Size size;
   fs::path save_path;
+  Config::SaveFile save_file_options;
   std::unique_ptr<BackupFile> file;
   
   int current_bank;
@@ -19,12 +19,19 @@ struct SRAM : Backup {
   void Reset() final;  
   auto Read (u32 address) -> u8 final;
   void Write(u32 address, u8 value) final;
+  auto Clone(CoreBase& core) const -> std::unique_ptr<Backup> final;
+  auto GetMemory() -> MemorySpan final;
+  void SetSaveFileOptions(Config::SaveFile const& options) final;
+  void FlushIfDue() final;
   
   void LoadState(SaveState const& state) final;
   void CopyState(SaveState& state) final;
 
 private:
+  SRAM(SRAM const& other);
+
   fs::path save_path;
+  Config::SaveFile save_file_options;
   std::unique_ptr<BackupFile> file;
 };
 
@@ -7,11 +7,14 @@
 
 #pragma once
 
+#include <memory>
 #include <nba/integer.hpp>
 #include <nba/save_state.hpp>
 
 namespace nba {
 
+struct CoreBase;
+
 struct GPIODevice {
   enum class PortDirection {
     In  = 0, // GPIO -> GBA
@@ -24,6 +27,9 @@ struct GPIODevice {
   virtual auto Read() -> int = 0;
   virtual void Write(int value) = 0;
 
+  // Creates a copy of the device that is connected to another core (see ROM::Clone).
+  virtual auto Clone(CoreBase& core) const -> std::unique_ptr<GPIODevice> = 0;
+
   virtual void LoadState(SaveState const& state) {}
   virtual void CopyState(SaveState& state) {}
   
@@ -43,6 +43,8 @@ struct GPIO {
   auto Read (u32 address) -> u8;
   void Write(u32 address, u8 value);
 
+  auto Clone(CoreBase& core) const -> std::unique_ptr<GPIO>;
+
   void LoadState(SaveState const& state);
   void CopyState(SaveState& state);
 
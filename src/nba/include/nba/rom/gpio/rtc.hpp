@@ -7,7 +7,11 @@
 
 #pragma once
 
+#include <ctime>
+#include <memory>
 #include <nba/rom/gpio/device.hpp>
+#include <nba/config.hpp>
+#include <nba/scheduler.hpp>
 
 namespace nba {
 
@@ -40,16 +44,18 @@ struct RTC final : GPIODevice {
     Free = 7
   };
 
-  RTC(core::IRQ& irq);
+  RTC(core::IRQ& irq, core::Scheduler& scheduler, std::shared_ptr<Config> config);
 
   void Reset() override;
   auto Read() -> int override;
   void Write(int value) override;
+  auto Clone(CoreBase& core) const -> std::unique_ptr<GPIODevice> override;
 
   void LoadState(SaveState const& state) override;
   void CopyState(SaveState& state) override;
 
 private:
+  auto GetTime() const -> std::tm;
   bool ReadSIO();
   void ReceiveCommandSIO();
   void ReceiveBufferSIO();
@@ -94,6 +100,8 @@ private:
   } control;
 
   core::IRQ& irq;
+  core::Scheduler& scheduler;
+  std::shared_ptr<Config> config;
 
   static constexpr int s_argument_count[8] = {
     0, // ForceReset
@@ -17,6 +17,7 @@ struct SolarSensor final : GPIODevice {
   void Reset() override;
   auto Read() -> int override;
   void Write(int value) override;
+  auto Clone(CoreBase& core) const -> std::unique_ptr<GPIODevice> override;
   void SetLightLevel(u8 level);
 
   void LoadState(SaveState const& state) override;
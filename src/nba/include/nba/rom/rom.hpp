@@ -10,15 +10,20 @@
 #include <algorithm>
 #include <memory>
 #include <nba/integer.hpp>
+#include <nba/rom/analysis.hpp>
 #include <nba/rom/backup/eeprom.hpp>
 #include <nba/rom/gpio/gpio.hpp>
 #include <nba/common/compiler.hpp>
+#include <nba/common/memory_span.hpp>
 #include <nba/common/punning.hpp>
 #include <nba/save_state.hpp>
+#include <optional>
 #include <vector>
 
 namespace nba {
 
+struct CoreBase;
+
 /**
  * TODO:
  *  - emulate the EEPROM being selected and deselected at the start/end of burst transfers?
@@ -33,14 +38,29 @@ struct ROM {
     std::unique_ptr<Backup>&& backup,
     std::unique_ptr<GPIO>&& gpio,
     u32 rom_mask = 0x01FF'FFFF
+  )   : ROM(MakeShared(std::move(rom)), std::move(backup), std::move(gpio), rom_mask) {
+  }
+
+  /**
+   * Creates a cartridge from ROM bytes that are owned elsewhere, e.g. a memory-mapped file.
+   * The bytes are never written to and stay alive for as long as any cartridge references them,
+   * so the same ROM can be shared by any number of cores.
+   */
+  ROM(
+    std::shared_ptr<MemorySpan const> rom,
+    std::unique_ptr<Backup>&& backup,
+    std::unique_ptr<GPIO>&& gpio,
+    u32 rom_mask = 0x01FF'FFFF
   )   : rom(std::move(rom))
+      , rom_data(this->rom->data)
+      , rom_size(this->rom->size)
       , gpio(std::move(gpio))
       , rom_mask(rom_mask) {
     if(backup != nullptr) {
       if(typeid(*backup.get()) == typeid(EEPROM)) {
         backup_eeprom = std::move(backup);
 
-        if(this->rom.size() >= 0x0100'0001) {
+        if(rom_size >= 0x0100'0001) {
           eeprom_mask = 0x01FF'FF00;
         } else {
           eeprom_mask = 0x0100'0000;
@@ -61,18 +81,72 @@ struct ROM {
 
   auto operator=(ROM&& other) -> ROM& {
     std::swap(rom, other.rom);
+    std::swap(rom_data, other.rom_data);
+    std::swap(rom_size, other.rom_size);
     std::swap(backup_sram, other.backup_sram);
     std::swap(backup_eeprom, other.backup_eeprom);
     std::swap(gpio, other.gpio);
     std::swap(rom_mask, other.rom_mask);
     std::swap(eeprom_mask, other.eeprom_mask);
+    std::swap(analysis, other.analysis);
     return *this;
   }
 
-  auto GetRawROM() -> std::vector<u8>& {
-    return rom;
+  auto GetRawROM() const -> MemorySpan {
+    return {rom_data, rom_size};
+  }
+
+  // Analyzes the ROM on first use, unless the result has been provided with SetAnalysis().
+  auto GetAnalysis() -> ROMAnalysis const& {
+    if(!analysis.has_value()) {
+      analysis = AnalyzeROM(GetRawROM());
+    }
+    return analysis.value();
+  }
+
+  void SetAnalysis(ROMAnalysis const& analysis) {
+    this->analysis = analysis;
+  }
+
+  auto GetBackupMemory() -> MemorySpan {
+    if(backup_sram) {
+      return backup_sram->GetMemory();
+    }
+
+    if(backup_eeprom) {
+      return backup_eeprom->GetMemory();
+    }
+
+    return {};
+  }
+
+  void SetSaveFileOptions(Config::SaveFile const& options) {
+    if(backup_sram) {
+      backup_sram->SetSaveFileOptions(options);
+    }
+
+    if(backup_eeprom) {
+      backup_eeprom->SetSaveFileOptions(options);
+    }
   }
 
+  void FlushBackupIfDue() {
+    if(backup_sram) {
+      backup_sram->FlushIfDue();
+    }
+
+    if(backup_eeprom) {
+      backup_eeprom->FlushIfDue();
+    }
+  }
+
+  /**
+   * Creates a copy of the cartridge for another core. The ROM bytes are shared
+   * (not copied) between both cartridges. The copied backup is kept in memory only,
+   * so that the clone never writes to the save file of the original cartridge.
+   */
+  auto Clone(CoreBase& core) const -> ROM;
+
   template<typename T>
   auto GetGPIODevice() -> T* {
     if(gpio) {
@@ -136,8 +210,8 @@ struct ROM {
       rom_address_latch = address & rom_mask;
     }
 
-    if(likely(rom_address_latch < rom.size())) {
-      data = read<u16>(rom.data(), rom_address_latch);
+    if(likely(rom_address_latch < rom_size)) {
+      data = read<u16>(rom_data, rom_address_latch);
     } else {
       data = (u16)(rom_address_latch >> 1);
     }
@@ -167,8 +241,8 @@ struct ROM {
       rom_address_latch = address & rom_mask;
     }
 
-    if(likely(rom_address_latch < rom.size())) {
-      data = read<u32>(rom.data(), rom_address_latch);
+    if(likely(rom_address_latch < rom_size)) {
+      data = read<u32>(rom_data, rom_address_latch);
     } else {
       const u16 lsw = (u16)(rom_address_latch >> 1);
       const u16 msw = (u16)(lsw + 1);
@@ -208,6 +282,20 @@ struct ROM {
     }
   }
 
+  // Moves ROM bytes into a reference-counted span, which can be passed to the constructor above.
+  static auto MakeShared(std::vector<u8>&& rom) -> std::shared_ptr<MemorySpan const> {
+    struct VectorSpan : MemorySpan {
+      VectorSpan(std::vector<u8>&& bytes) : bytes(std::move(bytes)) {
+        data = this->bytes.data();
+        size = this->bytes.size();
+      }
+
+      std::vector<u8> bytes;
+    };
+
+    return std::make_shared<VectorSpan>(std::move(rom));
+  }
+
 private:
   bool ALWAYS_INLINE IsGPIO(u32 address) {
     return gpio && address >= 0xC4 && address <= 0xC8;
@@ -217,7 +305,11 @@ private:
     return backup_eeprom && (address & eeprom_mask) == eeprom_mask;
   }
 
-  std::vector<u8> rom;
+  // Keeps the ROM bytes alive, the hot path only uses the cached pointer and size.
+  std::shared_ptr<MemorySpan const> rom;
+  u8 const* rom_data = nullptr;
+  size_t rom_size = 0;
+
   std::unique_ptr<Backup> backup_sram;
   std::unique_ptr<Backup> backup_eeprom;
   std::unique_ptr<GPIO> gpio;
@@ -225,6 +317,8 @@ private:
   u32 rom_address_latch = 0;
   u32 rom_mask = 0;
   u32 eeprom_mask = 0;
+
+  std::optional<ROMAnalysis> analysis;
 };
 
 } // namespace nba
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <array>
+#include <memory>
 #include <nba/integer.hpp>
 
 namespace nba {
@@ -16,7 +17,7 @@ namespace nba {
 
 struct SaveState {
   static constexpr u32 kMagicNumber = 0x5353424E; // NBSS
-  static constexpr u32 kCurrentVersion = 9;
+  static constexpr u32 kCurrentVersion = 10;
 
   u32 magic;
   u32 version;
@@ -160,7 +161,10 @@ struct SaveState {
           u8 step;
         } sweep;
 
-        u64 event_uid;
+        struct SynthesisClock {
+          bool running;
+          u64 timestamp_next;
+        } clock;
       };
 
       struct QuadChannel : PSG {
@@ -190,6 +194,7 @@ struct SaveState {
 
       u32 soundcnt;
       u16 soundbias;
+      bool master_enable;
     } io;
 
     struct FIFO {
@@ -216,6 +221,7 @@ struct SaveState {
       u16 control;
     } pending;
 
+    s32 prescaler_phase;
     u64 event_uid;
   } timer[4];
 
@@ -317,4 +323,9 @@ struct SaveState {
   } scheduler;
 };
 
+// SaveState is too large to be put on the stack, so it is always allocated through this helper.
+inline auto MakeSaveState() -> std::unique_ptr<SaveState> {
+  return std::make_unique<SaveState>();
+}
+
 } // namespace nba
@@ -44,10 +44,6 @@ struct Scheduler {
     // APU
     APU_mixer,
     APU_sequencer,
-    APU_PSG1_generate,
-    APU_PSG2_generate,
-    APU_PSG3_generate,
-    APU_PSG4_generate,
 
     // IRQ controller
     IRQ_write_io,
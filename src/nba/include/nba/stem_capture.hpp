@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <nba/common/dsp/spsc_ring_buffer.hpp>
+#include <nba/integer.hpp>
+
+namespace nba {
+
+/**
+ * Receives the output of each individual audio channel before it is mixed.
+ * Samples are written by the emulator thread at the mixer's sample rate and
+ * can be consumed from any (single) other thread.
+ */
+struct StemCapture {
+  enum class Stem {
+    PSG1,
+    PSG2,
+    PSG3,
+    PSG4,
+    FIFO_A,
+    FIFO_B,
+    Count
+  };
+
+  static constexpr int kStemCount = (int)Stem::Count;
+
+  // One sample of each stem, indexed by Stem.
+  using Frame = std::array<float, kStemCount>;
+
+  StemCapture(int min_length = 65536) : frames{min_length} {
+  }
+
+  auto Available() const -> int {
+    return frames.Available();
+  }
+
+  // Reads one frame and the sample rate it was captured at, which changes e.g. with SOUNDBIAS.
+  bool Read(Frame& frame, int& sample_rate) {
+    Entry entry;
+
+    if(!frames.Read(entry)) {
+      return false;
+    }
+
+    frame = entry.frame;
+    sample_rate = entry.sample_rate;
+    return true;
+  }
+
+  // The number of frames that were dropped because the ring was full, i.e. the capture is incomplete.
+  auto GetDroppedFrameCount() const -> u64 {
+    return dropped_frames.load(std::memory_order_relaxed);
+  }
+
+  // The stems are kept in a single ring, so that a full ring drops whole frames and they stay aligned.
+  void Write(Frame const& frame, int sample_rate) {
+    if(!frames.Write({frame, sample_rate})) {
+      dropped_frames.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+private:
+  struct Entry {
+    Frame frame;
+    int sample_rate;
+  };
+
+  SPSCRingBuffer<Entry> frames;
+  std::atomic<u64> dropped_frames = 0;
+};
+
+} // namespace nba
@@ -31,6 +31,8 @@ void Bus::Reset() {
   memory.wram.fill(0);
   memory.iram.fill(0);
   memory.latch = {};
+  dirty_pages.wram.MarkAll();
+  dirty_pages.iram.MarkAll();
   hw.waitcnt = {};
   hw.haltcnt = Hardware::HaltControl::Run;
   hw.siocnt = 0;
@@ -198,12 +200,14 @@ void Bus::Write(u32 address, int access, T value) {
     case 0x02: {
       Step(is_u32 ? 6 : 3);
       write<T>(memory.wram.data(), Align<T>(address) & 0x3FFFF, value);
+      dirty_pages.wram.Mark(address & 0x3FFFF);
       break;
     }
     // IWRAM (internal work RAM)
     case 0x03: {
       Step(1);
       write<T>(memory.iram.data(), Align<T>(address) & 0x7FFF,  value);
+      dirty_pages.iram.Mark(address & 0x7FFF);
       break;
     }
     // MMIO
@@ -356,10 +360,18 @@ auto Bus::ReadOpenBus(u32 address) -> u32 {
 }
 
 auto Bus::GetHostAddress(u32 address, size_t size) -> u8* {
+  auto host_address = TryGetHostAddress(address, size);
+
+  Assert(host_address != nullptr, "Bus: cannot get host address for 0x{:08X} ({} bytes)", address, size);
+
+  return host_address;
+}
+
+auto Bus::TryGetHostAddress(u32 address, size_t size) -> u8* {
   auto& bios = memory.bios;
   auto& wram = memory.wram;
   auto& iram = memory.iram;
-  auto& rom = memory.rom.GetRawROM();
+  auto rom = memory.rom.GetRawROM();
 
   auto page = address >> 24;
 
@@ -391,14 +403,15 @@ auto Bus::GetHostAddress(u32 address, size_t size) -> u8* {
     // ROM (WS0, WS1, WS2)
     case 0x08 ... 0x0D: {
       auto offset = address & 0x01FF'FFFF;
-      if(offset + size <= rom.size()) {
-        return rom.data() + offset;
+      // The ROM may be a read-only file mapping, it must never be written through the host address.
+      if(offset + size <= rom.size) {
+        return (u8*)rom.data + offset;
       }
       break;
     }
   }
 
-  Assert(false, "Bus: cannot get host address for 0x{:08X} ({} bytes)", address, size);
+  return nullptr;
 }
 
 } // namespace nba::core
@@ -19,6 +19,8 @@
 #include "hw/irq/irq.hpp"
 #include "hw/keypad/keypad.hpp"
 #include "hw/timer/timer.hpp"
+#include "dirty_page_map.hpp"
+#include "page_hash_tree.hpp"
 
 namespace nba::core {
 
@@ -62,6 +64,16 @@ struct Bus {
     ROM rom;
   } memory;
 
+  struct DirtyPages {
+    DirtyPageMap<0x40000> wram;
+    DirtyPageMap<0x08000> iram;
+  } dirty_pages;
+
+  struct PageHashes {
+    PageHashTree<0x40000> wram;
+    PageHashTree<0x08000> iram;
+  } page_hashes;
+
   struct Hardware {
     arm::ARM7TDMI& cpu;
     IRQ& irq;
@@ -252,8 +264,10 @@ struct Bus {
   void Step(int cycles);
   void UpdateWaitStateTable();
 
-  void LoadState(SaveState const& state);
-  void CopyState(SaveState& state);
+  void LoadState(SaveState const& state, bool incremental = false);
+  void CopyState(SaveState& state, bool incremental = false);
+  void CopyRegisterState(SaveState& state);
+  auto GetMemoryHash() -> u64;
  
   int wait16[2][16] {
     { 1, 1, 3, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 1 },
@@ -268,12 +282,19 @@ struct Bus {
 public:
   Bus(Scheduler& scheduler, Hardware&& hw);
 
+  // Note: writes through host pointers bypass the dirty page tracking.
   auto GetHostAddress(u32 address, size_t size) -> u8*;
+  auto TryGetHostAddress(u32 address, size_t size) -> u8*;
 
   template<typename T>
   auto GetHostAddress(u32 address, size_t count = 1) -> T* {
     return (T*)GetHostAddress(address, sizeof(T) * count);
   }
+
+  template<typename T>
+  auto TryGetHostAddress(u32 address, size_t count = 1) -> T* {
+    return (T*)TryGetHostAddress(address, sizeof(T) * count);
+  }
 };
 
 } // namespace nba::core
@@ -234,11 +234,25 @@ auto Bus::Hardware::ReadWord(u32 address) -> u32 {
   return ReadHalf(address) | (ReadHalf(address + 2) << 16);
 }
 
+/**
+ * Writes to the sound FIFOs and their control bits change the state that
+ * (coalesced) timer overflows operate on, see Timer::Sync().
+ */
+static bool IsTimerFIFOAddress(u32 address) {
+  return (address >= SOUNDCNT_H && address < SOUNDCNT_X + 2) ||
+         (address >= FIFO_A && address < FIFO_B + 4);
+}
+
 void Bus::Hardware::WriteByte(u32 address,  u8 value) {
   auto& apu_io = apu.mmio;
   auto& ppu_io = ppu.mmio;
 
   const bool apu_enable = apu_io.soundcnt.master_enable;
+  const bool timer_fifo_write = IsTimerFIFOAddress(address);
+
+  if(timer_fifo_write) {
+    timer.Sync();
+  }
 
   switch(address) {
     // PPU
@@ -572,12 +586,21 @@ void Bus::Hardware::WriteByte(u32 address,  u8 value) {
       break;
     }
   }
+
+  if(timer_fifo_write) {
+    timer.Reschedule();
+  }
 }
 
 void Bus::Hardware::WriteHalf(u32 address, u16 value) {
   auto& apu_io = apu.mmio;
 
   const bool apu_enable = apu_io.soundcnt.master_enable;
+  const bool timer_fifo_write = IsTimerFIFOAddress(address);
+
+  if(timer_fifo_write) {
+    timer.Sync();
+  }
 
   switch(address) {
     case FIFO_A+0: if(apu_enable) apu_io.fifo[0].WriteHalf(0, value); break;
@@ -652,12 +675,21 @@ void Bus::Hardware::WriteHalf(u32 address, u16 value) {
       break;
     }
   }
+
+  if(timer_fifo_write) {
+    timer.Reschedule();
+  }
 }
 
 void Bus::Hardware::WriteWord(u32 address, u32 value) {
   auto& apu_io = apu.mmio;
 
   const bool apu_enable = apu_io.soundcnt.master_enable;
+  const bool timer_fifo_write = IsTimerFIFOAddress(address);
+
+  if(timer_fifo_write) {
+    timer.Sync();
+  }
 
   switch(address) {
     case FIFO_A: if(apu_enable) apu_io.fifo[0].WriteWord(value); break;
@@ -675,6 +707,10 @@ void Bus::Hardware::WriteWord(u32 address, u32 value) {
       break;
     }
   }
+
+  if(timer_fifo_write) {
+    timer.Reschedule();
+  }
 }
 
 void Bus::SIOTransferDone() {
@@ -9,9 +9,18 @@
 
 namespace nba::core {
 
-void Bus::LoadState(SaveState const& state) {
-  memory.wram = state.bus.memory.wram;
-  memory.iram = state.bus.memory.iram;
+void Bus::LoadState(SaveState const& state, bool incremental) {
+  if(incremental) {
+    dirty_pages.wram.CopyDirtyPages(memory.wram.data(), state.bus.memory.wram.data());
+    dirty_pages.iram.CopyDirtyPages(memory.iram.data(), state.bus.memory.iram.data());
+  } else {
+    memory.wram = state.bus.memory.wram;
+    memory.iram = state.bus.memory.iram;
+    dirty_pages.wram.Clear();
+    dirty_pages.iram.Clear();
+    dirty_pages.wram.MarkAllForHashing();
+    dirty_pages.iram.MarkAllForHashing();
+  }
   memory.latch.bios = state.bus.memory.latch.bios;
   memory.rom.LoadState(state);
 
@@ -33,6 +42,7 @@ void Bus::LoadState(SaveState const& state) {
 
   prefetch.active = state.bus.prefetch.active;
   prefetch.head_address = state.bus.prefetch.head_address;
+  prefetch.last_address = state.bus.prefetch.last_address;
   prefetch.count = state.bus.prefetch.count;
   prefetch.countdown = state.bus.prefetch.countdown;
   prefetch.thumb = state.bus.prefetch.thumb;
@@ -51,12 +61,24 @@ void Bus::LoadState(SaveState const& state) {
   parallel_internal_cpu_cycle_limit = state.bus.parallel_internal_cpu_cycle_limit;
 }
 
-void Bus::CopyState(SaveState& state) {
-  state.bus.memory.wram = memory.wram;
-  state.bus.memory.iram = memory.iram;
-  state.bus.memory.latch.bios = memory.latch.bios;
+void Bus::CopyState(SaveState& state, bool incremental) {
+  if(incremental) {
+    dirty_pages.wram.CopyDirtyPages(state.bus.memory.wram.data(), memory.wram.data());
+    dirty_pages.iram.CopyDirtyPages(state.bus.memory.iram.data(), memory.iram.data());
+  } else {
+    state.bus.memory.wram = memory.wram;
+    state.bus.memory.iram = memory.iram;
+    dirty_pages.wram.Clear();
+    dirty_pages.iram.Clear();
+  }
   memory.rom.CopyState(state);
 
+  CopyRegisterState(state);
+}
+
+void Bus::CopyRegisterState(SaveState& state) {
+  state.bus.memory.latch.bios = memory.latch.bios;
+
   state.bus.io.waitcnt.sram = hw.waitcnt.sram;
   for(int i = 0; i < 2; i++) {
     state.bus.io.waitcnt.ws0[i] = hw.waitcnt.ws0[i];
@@ -74,6 +96,7 @@ void Bus::CopyState(SaveState& state) {
 
   state.bus.prefetch.active = prefetch.active;
   state.bus.prefetch.head_address = prefetch.head_address;
+  state.bus.prefetch.last_address = prefetch.last_address;
   state.bus.prefetch.count = prefetch.count;
   state.bus.prefetch.countdown = prefetch.countdown;
   state.bus.prefetch.thumb = prefetch.thumb;
@@ -83,4 +106,11 @@ void Bus::CopyState(SaveState& state) {
   state.bus.parallel_internal_cpu_cycle_limit = parallel_internal_cpu_cycle_limit;
 }
 
+auto Bus::GetMemoryHash() -> u64 {
+  const u64 wram_hash = page_hashes.wram.Update(memory.wram.data(), dirty_pages.wram);
+  const u64 iram_hash = page_hashes.iram.Update(memory.iram.data(), dirty_pages.iram);
+
+  return hash_combine(wram_hash, iram_hash);
+}
+
 } // namespace nba::core
\ No newline at end of file
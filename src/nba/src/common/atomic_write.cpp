@@ -0,0 +1,195 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <fmt/format.h>
+#include <nba/common/atomic_write.hpp>
+
+#ifdef _WIN32
+  #define WIN32_LEAN_AND_MEAN
+  #include <windows.h>
+#else
+  #include <cerrno>
+  #include <fcntl.h>
+  #include <unistd.h>
+#endif
+
+namespace nba {
+
+static auto GetTemporaryPath(fs::path const& path) -> fs::path {
+  static std::atomic<u64> counter{0};
+
+#ifdef _WIN32
+  const auto process_id = (u64)GetCurrentProcessId();
+#else
+  const auto process_id = (u64)getpid();
+#endif
+
+  return fs::path{path}.concat(fmt::format(".{}-{}.tmp", process_id, counter++));
+}
+
+auto IsAtomicWriteTemporaryFile(fs::path const& path) -> bool {
+  return path.extension() == ".tmp";
+}
+
+#ifdef _WIN32
+
+static auto WriteAll(HANDLE file, void const* data, size_t size) -> bool {
+  auto bytes = (u8 const*)data;
+
+  while(size > 0) {
+    DWORD written;
+    DWORD chunk = (DWORD)std::min<size_t>(size, 0x4000'0000);
+
+    if(!WriteFile(file, bytes, chunk, &written, nullptr)) {
+      return false;
+    }
+
+    bytes += written;
+    size -= written;
+  }
+
+  return true;
+}
+
+auto WriteFileAtomic(fs::path const& path, void const* data, size_t size) -> WriteFileResult {
+  const auto temporary_path = GetTemporaryPath(path);
+
+  HANDLE file = CreateFileW(temporary_path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+  if(file == INVALID_HANDLE_VALUE) {
+    return WriteFileResult::CannotOpenFile;
+  }
+
+  const bool success = WriteAll(file, data, size) && FlushFileBuffers(file);
+
+  CloseHandle(file);
+
+  if(!success) {
+    DeleteFileW(temporary_path.c_str());
+    return WriteFileResult::CannotWrite;
+  }
+
+  if(!MoveFileExW(temporary_path.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+    DeleteFileW(temporary_path.c_str());
+    return WriteFileResult::CannotReplaceFile;
+  }
+
+  return WriteFileResult::Success;
+}
+
+auto WriteFileInPlace(fs::path const& path, u64 offset, void const* data, size_t size) -> WriteFileResult {
+  HANDLE file = CreateFileW(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+  if(file == INVALID_HANDLE_VALUE) {
+    return WriteFileResult::CannotOpenFile;
+  }
+
+  LARGE_INTEGER position;
+
+  position.QuadPart = (LONGLONG)offset;
+
+  const bool success = SetFilePointerEx(file, position, nullptr, FILE_BEGIN) &&
+                       WriteAll(file, data, size) && FlushFileBuffers(file);
+
+  CloseHandle(file);
+
+  return success ? WriteFileResult::Success : WriteFileResult::CannotWrite;
+}
+
+#else
+
+static auto WriteAll(int fd, void const* data, size_t size, off_t offset) -> bool {
+  auto bytes = (u8 const*)data;
+
+  while(size > 0) {
+    ssize_t written = pwrite(fd, bytes, size, offset);
+
+    if(written < 0) {
+      if(errno == EINTR) continue;
+      return false;
+    }
+
+    bytes += written;
+    size -= (size_t)written;
+    offset += (off_t)written;
+  }
+
+  return true;
+}
+
+static auto SyncFile(int fd) -> bool {
+#ifdef __APPLE__
+  // fsync() does not flush the drive's write cache on macOS.
+  if(fcntl(fd, F_FULLFSYNC) == 0) {
+    return true;
+  }
+#endif
+  return fsync(fd) == 0;
+}
+
+// Makes a rename durable, which is a change to the directory rather than to the file.
+static void SyncDirectory(fs::path const& path) {
+  auto directory = path.parent_path();
+
+  if(directory.empty()) {
+    directory = ".";
+  }
+
+  int fd = open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+
+  if(fd != -1) {
+    fsync(fd);
+    close(fd);
+  }
+}
+
+auto WriteFileAtomic(fs::path const& path, void const* data, size_t size) -> WriteFileResult {
+  const auto temporary_path = GetTemporaryPath(path);
+
+  int fd = open(temporary_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+
+  if(fd == -1) {
+    return WriteFileResult::CannotOpenFile;
+  }
+
+  const bool success = WriteAll(fd, data, size, 0) && SyncFile(fd);
+
+  if(close(fd) != 0 || !success) {
+    unlink(temporary_path.c_str());
+    return WriteFileResult::CannotWrite;
+  }
+
+  if(rename(temporary_path.c_str(), path.c_str()) != 0) {
+    unlink(temporary_path.c_str());
+    return WriteFileResult::CannotReplaceFile;
+  }
+
+  SyncDirectory(path);
+  return WriteFileResult::Success;
+}
+
+auto WriteFileInPlace(fs::path const& path, u64 offset, void const* data, size_t size) -> WriteFileResult {
+  int fd = open(path.c_str(), O_WRONLY | O_CLOEXEC);
+
+  if(fd == -1) {
+    return WriteFileResult::CannotOpenFile;
+  }
+
+  const bool success = WriteAll(fd, data, size, (off_t)offset) && SyncFile(fd);
+
+  if(close(fd) != 0 || !success) {
+    return WriteFileResult::CannotWrite;
+  }
+
+  return WriteFileResult::Success;
+}
+
+#endif
+
+} // namespace nba
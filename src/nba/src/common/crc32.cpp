@@ -0,0 +1,360 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <nba/common/crc32.hpp>
+#include <nba/common/punning.hpp>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+  #define CRC32_X86
+
+  #include <emmintrin.h>
+  #include <wmmintrin.h>
+
+  #ifdef _MSC_VER
+    #include <intrin.h>
+    #define TARGET_PCLMUL
+  #else
+    #include <cpuid.h>
+    #define TARGET_PCLMUL __attribute__((target("pclmul")))
+  #endif
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+  #define CRC32_ARM64
+
+  #if defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+    #define TARGET_CRC
+  #else
+    #include <arm_acle.h>
+
+    #if defined(__clang__)
+      #define TARGET_CRC __attribute__((target("crc")))
+    #else
+      #define TARGET_CRC __attribute__((target("+crc")))
+    #endif
+  #endif
+
+  #if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+  #elif defined(__linux__)
+    #include <asm/hwcap.h>
+    #include <sys/auxv.h>
+  #endif
+#endif
+
+namespace nba {
+
+/**
+ * All methods work on the CRC register, which starts out as 0xFFFFFFFF
+ * and is inverted to get the final CRC.
+ */
+using UpdateFunction = u32 (*)(u32 crc, u8 const* data, size_t length);
+
+struct CRC32Tables {
+  // table[n][byte] is the CRC of the byte followed by n zero bytes.
+  u32 table[16][256];
+};
+
+static constexpr auto GenerateTables() -> CRC32Tables {
+  CRC32Tables tables{};
+
+  for(u32 byte = 0; byte < 256; byte++) {
+    u32 crc = byte;
+
+    for(int bit = 0; bit < 8; bit++) {
+      crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+    tables.table[0][byte] = crc;
+  }
+
+  for(int byte = 0; byte < 256; byte++) {
+    for(int n = 1; n < 16; n++) {
+      const u32 crc = tables.table[n - 1][byte];
+
+      tables.table[n][byte] = (crc >> 8) ^ tables.table[0][crc & 0xFF];
+    }
+  }
+
+  return tables;
+}
+
+static constexpr CRC32Tables kTables = GenerateTables();
+
+static auto UpdateBitwise(u32 crc, u8 const* data, size_t length) -> u32 {
+  while(length-- != 0) {
+    u8 byte = *data++;
+
+    for(int i = 0; i < 8; i++) {
+      if((crc ^ byte) & 1) {
+        crc = (crc >> 1) ^ 0xEDB88320;
+      } else {
+        crc >>= 1;
+      }
+      byte >>= 1;
+    }
+  }
+
+  return crc;
+}
+
+static auto UpdateBytewise(u32 crc, u8 const* data, size_t length) -> u32 {
+  auto& table = kTables.table[0];
+
+  while(length-- != 0) {
+    crc = (crc >> 8) ^ table[(crc ^ *data++) & 0xFF];
+  }
+  return crc;
+}
+
+// The slicing methods assume a little-endian host, like the rest of the emulator.
+static auto UpdateSliceBy8(u32 crc, u8 const* data, size_t length) -> u32 {
+  auto& t = kTables.table;
+
+  while(length >= 8) {
+    const u32 word0 = read<u32>(data, 0) ^ crc;
+    const u32 word1 = read<u32>(data, 4);
+
+    crc = t[7][word0 & 0xFF] ^ t[6][(word0 >> 8) & 0xFF] ^ t[5][(word0 >> 16) & 0xFF] ^ t[4][word0 >> 24] ^
+          t[3][word1 & 0xFF] ^ t[2][(word1 >> 8) & 0xFF] ^ t[1][(word1 >> 16) & 0xFF] ^ t[0][word1 >> 24];
+
+    data += 8;
+    length -= 8;
+  }
+
+  return UpdateBytewise(crc, data, length);
+}
+
+static auto UpdateSliceBy16(u32 crc, u8 const* data, size_t length) -> u32 {
+  auto& t = kTables.table;
+
+  while(length >= 16) {
+    const u32 word0 = read<u32>(data,  0) ^ crc;
+    const u32 word1 = read<u32>(data,  4);
+    const u32 word2 = read<u32>(data,  8);
+    const u32 word3 = read<u32>(data, 12);
+
+    crc = t[15][word0 & 0xFF] ^ t[14][(word0 >> 8) & 0xFF] ^ t[13][(word0 >> 16) & 0xFF] ^ t[12][word0 >> 24] ^
+          t[11][word1 & 0xFF] ^ t[10][(word1 >> 8) & 0xFF] ^ t[ 9][(word1 >> 16) & 0xFF] ^ t[ 8][word1 >> 24] ^
+          t[ 7][word2 & 0xFF] ^ t[ 6][(word2 >> 8) & 0xFF] ^ t[ 5][(word2 >> 16) & 0xFF] ^ t[ 4][word2 >> 24] ^
+          t[ 3][word3 & 0xFF] ^ t[ 2][(word3 >> 8) & 0xFF] ^ t[ 1][(word3 >> 16) & 0xFF] ^ t[ 0][word3 >> 24];
+
+    data += 16;
+    length -= 16;
+  }
+
+  return UpdateSliceBy8(crc, data, length);
+}
+
+#ifdef CRC32_X86
+
+/**
+ * Folds the data in 128-bit lanes with carry-less multiplication and reduces the result with a Barrett reduction.
+ * See "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction" (Intel, 2009).
+ * The constants are the bit-reflected constants for the CRC-32 polynomial from the end of the paper.
+ * Requires at least 64 bytes and a length that is a multiple of 16 bytes.
+ */
+TARGET_PCLMUL static auto FoldPCLMUL(u32 crc, u8 const* data, size_t length) -> u32 {
+  const __m128i k1k2 = _mm_set_epi64x(0x01C6E41596, 0x0154442BD4);
+  const __m128i k3k4 = _mm_set_epi64x(0x00CCAA009E, 0x01751997D0);
+  const __m128i k5k0 = _mm_set_epi64x(0x0000000000, 0x0163CD6124);
+  const __m128i poly = _mm_set_epi64x(0x01F7011641, 0x01DB710641);
+  const __m128i mask = _mm_setr_epi32(~0, 0, ~0, 0);
+
+  __m128i x1 = _mm_loadu_si128((__m128i const*)&data[0x00]);
+  __m128i x2 = _mm_loadu_si128((__m128i const*)&data[0x10]);
+  __m128i x3 = _mm_loadu_si128((__m128i const*)&data[0x20]);
+  __m128i x4 = _mm_loadu_si128((__m128i const*)&data[0x30]);
+  __m128i x5;
+
+  x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int)crc));
+
+  data += 64;
+  length -= 64;
+
+  // Fold four lanes in parallel.
+  while(length >= 64) {
+    x5 = _mm_clmulepi64_si128(x1, k1k2, 0x00);
+    const __m128i x6 = _mm_clmulepi64_si128(x2, k1k2, 0x00);
+    const __m128i x7 = _mm_clmulepi64_si128(x3, k1k2, 0x00);
+    const __m128i x8 = _mm_clmulepi64_si128(x4, k1k2, 0x00);
+
+    x1 = _mm_clmulepi64_si128(x1, k1k2, 0x11);
+    x2 = _mm_clmulepi64_si128(x2, k1k2, 0x11);
+    x3 = _mm_clmulepi64_si128(x3, k1k2, 0x11);
+    x4 = _mm_clmulepi64_si128(x4, k1k2, 0x11);
+
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128((__m128i const*)&data[0x00]));
+    x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128((__m128i const*)&data[0x10]));
+    x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128((__m128i const*)&data[0x20]));
+    x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128((__m128i const*)&data[0x30]));
+
+    data += 64;
+    length -= 64;
+  }
+
+  // Fold the four lanes into one.
+  const __m128i lanes[3] { x2, x3, x4 };
+
+  for(__m128i lane : lanes) {
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, lane), x5);
+  }
+
+  // Fold the remaining 16 byte blocks.
+  while(length >= 16) {
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, _mm_loadu_si128((__m128i const*)data)), x5);
+
+    data += 16;
+    length -= 16;
+  }
+
+  // Fold 128 bits into 64 bits.
+  x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+  x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+
+  x2 = _mm_srli_si128(x1, 4);
+  x1 = _mm_and_si128(x1, mask);
+  x1 = _mm_clmulepi64_si128(x1, k5k0, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+
+  // Barrett reduction to 32 bits.
+  x2 = _mm_and_si128(x1, mask);
+  x2 = _mm_clmulepi64_si128(x2, poly, 0x10);
+  x2 = _mm_and_si128(x2, mask);
+  x2 = _mm_clmulepi64_si128(x2, poly, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+
+  return (u32)_mm_cvtsi128_si32(_mm_srli_si128(x1, 4));
+}
+
+static auto UpdatePCLMUL(u32 crc, u8 const* data, size_t length) -> u32 {
+  if(length >= 64) {
+    const size_t fold_length = length & ~(size_t)15;
+
+    crc = FoldPCLMUL(crc, data, fold_length);
+    data += fold_length;
+    length -= fold_length;
+  }
+
+  return UpdateSliceBy8(crc, data, length);
+}
+
+static auto HasPCLMUL() -> bool {
+#ifdef _MSC_VER
+  int registers[4];
+
+  __cpuid(registers, 1);
+  return registers[2] & (1 << 1);
+#else
+  unsigned int eax, ebx, ecx, edx;
+
+  return __get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & bit_PCLMUL);
+#endif
+}
+
+#endif // CRC32_X86
+
+#ifdef CRC32_ARM64
+
+TARGET_CRC static auto UpdateARMv8(u32 crc, u8 const* data, size_t length) -> u32 {
+  while(length >= 8) {
+    crc = __crc32d(crc, read<u64>(data, 0));
+    data += 8;
+    length -= 8;
+  }
+
+  while(length-- != 0) {
+    crc = __crc32b(crc, *data++);
+  }
+  return crc;
+}
+
+static auto HasARMv8CRC32() -> bool {
+#if defined(__ARM_FEATURE_CRC32) || defined(__APPLE__)
+  return true;
+#elif defined(_WIN32)
+  return IsProcessorFeaturePresent(PF_ARM_V8_CRC32_INSTRUCTIONS_AVAILABLE);
+#elif defined(__linux__)
+  return getauxval(AT_HWCAP) & HWCAP_CRC32;
+#else
+  return false;
+#endif
+}
+
+#endif // CRC32_ARM64
+
+static auto GetUpdateFunction(CRC32Method method) -> UpdateFunction {
+  switch(method) {
+    case CRC32Method::SliceBy8:  return UpdateSliceBy8;
+    case CRC32Method::SliceBy16: return UpdateSliceBy16;
+#ifdef CRC32_X86
+    case CRC32Method::PCLMUL:    return UpdatePCLMUL;
+#endif
+#ifdef CRC32_ARM64
+    case CRC32Method::ARMv8:     return UpdateARMv8;
+#endif
+    default: return UpdateBitwise;
+  }
+}
+
+auto IsCRC32MethodSupported(CRC32Method method) -> bool {
+  switch(method) {
+    case CRC32Method::Bitwise:
+    case CRC32Method::SliceBy8:
+    case CRC32Method::SliceBy16: return true;
+#ifdef CRC32_X86
+    case CRC32Method::PCLMUL: {
+      static const bool supported = HasPCLMUL();
+      return supported;
+    }
+#endif
+#ifdef CRC32_ARM64
+    case CRC32Method::ARMv8: {
+      static const bool supported = HasARMv8CRC32();
+      return supported;
+    }
+#endif
+    default: return false;
+  }
+}
+
+auto GetCRC32Method() -> CRC32Method {
+  static const CRC32Method method = []() {
+    if(IsCRC32MethodSupported(CRC32Method::ARMv8)) {
+      return CRC32Method::ARMv8;
+    }
+
+    if(IsCRC32MethodSupported(CRC32Method::PCLMUL)) {
+      return CRC32Method::PCLMUL;
+    }
+
+    return CRC32Method::SliceBy16;
+  }();
+
+  return method;
+}
+
+auto crc32(CRC32Method method, u8 const* data, size_t length) -> u32 {
+  if(!IsCRC32MethodSupported(method)) {
+    method = GetCRC32Method();
+  }
+
+  return ~GetUpdateFunction(method)(0xFFFFFFFF, data, length);
+}
+
+auto crc32(u8 const* data, size_t length) -> u32 {
+  static const UpdateFunction update = GetUpdateFunction(GetCRC32Method());
+
+  return ~update(0xFFFFFFFF, data, length);
+}
+
+} // namespace nba
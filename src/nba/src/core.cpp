@@ -5,9 +5,10 @@
  * Refer to the included LICENSE file.
  */
 
-#include <nba/common/crc32.hpp>
+#include <algorithm>
 #include <nba/rom/gpio/rtc.hpp>
 #include <nba/rom/gpio/solar_sensor.hpp>
+#include <type_traits>
 
 #include "core.hpp"
 
@@ -20,9 +21,9 @@ Core::Core(std::shared_ptr<Config> config)
     , cpu(scheduler, bus)
     , irq(cpu, scheduler)
     , dma(bus, irq, scheduler)
-    , apu(scheduler, dma, bus, config)
+    , apu(scheduler, dma, bus, timer, config)
     , ppu(scheduler, irq, dma, config)
-    , timer(scheduler, irq, apu)
+    , timer(scheduler, irq, apu, config)
     , keypad(scheduler, irq, config)
     , bus(scheduler, {cpu, irq, dma, apu, ppu, timer, keypad}) {
   Reset();
@@ -43,15 +44,17 @@ void Core::Reset() {
     SkipBootScreen();
   }
 
+  hooks.Reset();
+
   if(config->audio.mp2k_hle_enable) {
-    apu.GetMP2K().UseCubicFilter() = config->audio.mp2k_hle_cubic;
-    apu.GetMP2K().ForceReverb() = config->audio.mp2k_hle_force_reverb;
-    hle_audio_hook = SearchSoundMainRAM();
-    if(hle_audio_hook != 0xFFFFFFFF) {
-      Log<Info>("Core: detected MP2K audio mixer @ 0x{:08X}", hle_audio_hook);
+    // The ROM is only analyzed once, even if the core is reset many times.
+    const u32 sound_main_ram = bus.memory.rom.GetAnalysis().sound_main_ram;
+
+    if(sound_main_ram != 0xFFFFFFFF) {
+      Log<Info>("Core: detected MP2K audio mixer @ 0x{:08X}", sound_main_ram);
     }
-  } else {
-    hle_audio_hook = 0xFFFFFFFF;
+
+    InstallMP2KHook(sound_main_ram);
   }
 }
 
@@ -61,10 +64,11 @@ void Core::Attach(std::vector<u8> const& bios) {
 
 void Core::Attach(ROM&& rom) {
   bus.Attach(std::move(rom));
+  bus.memory.rom.SetSaveFileOptions(config->save_file);
 }
 
 auto Core::CreateRTC() -> std::unique_ptr<RTC> {
-  return std::make_unique<RTC>(irq);
+  return std::make_unique<RTC>(irq, scheduler, config);
 }
 
 auto Core::CreateSolarSensor() -> std::unique_ptr<SolarSensor> {
@@ -75,16 +79,12 @@ void Core::Run(int cycles) {
   using HaltControl = Bus::Hardware::HaltControl;
 
   const auto limit = scheduler.GetTimestampNow() + cycles;
+  const bool have_hooks = !hooks.Empty();
 
   while(scheduler.GetTimestampNow() < limit) {
     if(bus.hw.haltcnt == HaltControl::Run) {
-      if(cpu.state.r15 == hle_audio_hook) {
-        // @todo: cache the SoundInfo pointer once we have it?
-        apu.GetMP2K().SoundMainRAM(
-          *bus.GetHostAddress<MP2K::SoundInfo>(
-            *bus.GetHostAddress<u32>(0x03007FF0)
-          )
-        );
+      if(have_hooks && unlikely(hooks.MayHaveHook(cpu.state.r15))) {
+        hooks.Call(cpu.state.r15);
       }
 
       cpu.Run();
@@ -104,6 +104,47 @@ void Core::Run(int cycles) {
       }
     }
   }
+
+  // Due save file writes are only queued here, the file is written on a background thread.
+  bus.memory.rom.FlushBackupIfDue();
+}
+
+auto Core::Clone(std::shared_ptr<Config> config) -> std::unique_ptr<CoreBase> {
+  if(!config) {
+    config = std::make_shared<Config>(*this->config);
+    config->audio_dev = std::make_shared<NullAudioDevice>();
+    config->input_dev = std::make_shared<NullInputDevice>();
+    config->video_dev = std::make_shared<NullVideoDevice>();
+    config->stem_capture = nullptr;
+  }
+
+  auto core = std::make_unique<Core>(config);
+
+  core->bus.memory.bios = bus.memory.bios;
+  core->bus.memory.rom = bus.memory.rom.Clone(*core);
+
+  // The clone shares the ROM analysis, so the ROM is not scanned a second time.
+  if(config->audio.mp2k_hle_enable) {
+    core->InstallMP2KHook(core->bus.memory.rom.GetAnalysis().sound_main_ram);
+  }
+
+  if(!clone_state) {
+    clone_state = MakeSaveState();
+  }
+
+  // Scheduler events are looked up by their UID, so they are re-linked to the clone's components.
+  CopyState(*clone_state);
+  core->LoadState(*clone_state);
+
+  // Save states do not include the MP2K mixer, loading one resets it.
+  core->apu.GetMP2K().CopyFrom(apu.GetMP2K());
+
+  // Copying the full state resets the dirty page tracking, which incremental snapshots of this core rely on.
+  bus.dirty_pages.wram.MarkAll();
+  bus.dirty_pages.iram.MarkAll();
+  ppu.MarkAllPagesDirty();
+
+  return core;
 }
 
 void Core::SkipBootScreen() {
@@ -114,38 +155,23 @@ void Core::SkipBootScreen() {
   cpu.state.r15 = 0x08000000;
 }
 
-auto Core::SearchSoundMainRAM() -> u32 {
-  static constexpr u32 kSoundMainCRC32 = 0x27EA7FCF;
-  static constexpr int kSoundMainLength = 48;
+void Core::InstallMP2KHook(u32 sound_main_ram) {
+  auto& mp2k = apu.GetMP2K();
 
-  auto& rom = bus.memory.rom.GetRawROM();
+  mp2k.UseCubicFilter() = config->audio.mp2k_hle_cubic;
+  mp2k.ForceReverb() = config->audio.mp2k_hle_force_reverb;
 
-  if(rom.size() < kSoundMainLength) {
-    return 0xFFFFFFFF;
+  if(sound_main_ram != 0xFFFFFFFF) {
+    hooks.Add(sound_main_ram, [&mp2k]() { mp2k.SoundMainRAM(); });
   }
+}
 
-  u32 address_max = rom.size() - kSoundMainLength;
-
-  for(u32 address = 0; address <= address_max; address += sizeof(u16)) {
-    auto crc = crc32(&rom[address], kSoundMainLength);
-
-    if(crc == kSoundMainCRC32) {
-      /* We have found SoundMain().
-       * The pointer to SoundMainRAM() is stored at offset 0x74.
-       */
-      address = read<u32>(rom.data(), address + 0x74);
-      if(address & 1) {
-        address &= ~1;
-        address += sizeof(u16) * 2;
-      } else {
-        address &= ~3;
-        address += sizeof(u32) * 2;
-      }
-      return address;
-    }
-  }
+void Core::SetAudioOutputEnable(bool enable) {
+  apu.SetOutputEnable(enable);
+}
 
-  return 0xFFFFFFFF;
+void Core::SetVideoOutputEnable(bool enable) {
+  ppu.SetOutputEnable(enable);
 }
 
 auto Core::GetROM() -> ROM& {
@@ -184,8 +210,109 @@ Scheduler& Core::GetScheduler() {
   return scheduler;
 }
 
+auto Core::GetMemorySpan(MemoryRegion region) -> MemorySpan {
+  switch(region) {
+    case MemoryRegion::BIOS: return {bus.memory.bios.data(), bus.memory.bios.size()};
+    case MemoryRegion::WRAM: return {bus.memory.wram.data(), bus.memory.wram.size()};
+    case MemoryRegion::IRAM: return {bus.memory.iram.data(), bus.memory.iram.size()};
+    case MemoryRegion::PRAM: return {ppu.GetPRAM(), 0x400};
+    case MemoryRegion::VRAM: return {ppu.GetVRAM(), 0x18000};
+    case MemoryRegion::OAM:  return {ppu.GetOAM(),  0x400};
+    case MemoryRegion::ROM: return bus.memory.rom.GetRawROM();
+    case MemoryRegion::Backup: return bus.memory.rom.GetBackupMemory();
+    default: return {};
+  }
+}
+
 } // namespace nba::core
 
+static_assert(std::is_trivially_copyable_v<SnapshotData>, "Snapshots must be trivially copyable");
+
+bool CoreBase::Snapshot(void* buffer, size_t size, bool incremental) {
+  if(size < kSnapshotSize || (uintptr_t)buffer % kSnapshotAlignment != 0) {
+    return false;
+  }
+
+  auto& snapshot = *(SnapshotData*)buffer;
+
+  if(incremental) {
+    CopyStateIncremental(snapshot.state);
+  } else {
+    CopyState(snapshot.state);
+  }
+  CopyMixerState(snapshot.mixer);
+  return true;
+}
+
+bool CoreBase::Restore(void const* buffer, size_t size, bool incremental) {
+  if(size < kSnapshotSize || (uintptr_t)buffer % kSnapshotAlignment != 0) {
+    return false;
+  }
+
+  auto const& snapshot = *(SnapshotData const*)buffer;
+  auto const& state = snapshot.state;
+
+  if(state.magic != SaveState::kMagicNumber || state.version != SaveState::kCurrentVersion) {
+    return false;
+  }
+
+  if(incremental) {
+    LoadStateIncremental(state);
+  } else {
+    LoadState(state);
+  }
+  LoadMixerState(snapshot.mixer);
+  return true;
+}
+
+void CoreBase::Gather(MemoryRead const* reads, u32* values, size_t count) {
+  using Region = MemoryRegion;
+
+  MemorySpan spans[(int)Region::Count];
+
+  for(int i = 0; i < (int)Region::Count; i++) {
+    spans[i] = GetMemorySpan((Region)i);
+  }
+
+  const auto read_byte = [&](u32 address) -> u8 {
+    u32 offset = address & 0x00FF'FFFF;
+    MemorySpan* span;
+
+    switch(address >> 24) {
+      case 0x00: span = &spans[(int)Region::BIOS]; break;
+      case 0x02: span = &spans[(int)Region::WRAM]; offset &= 0x3FFFF; break;
+      case 0x03: span = &spans[(int)Region::IRAM]; offset &= 0x7FFF; break;
+      case 0x04: return PeekByteIO(address);
+      case 0x05: span = &spans[(int)Region::PRAM]; offset &= 0x3FF; break;
+      case 0x06: {
+        span = &spans[(int)Region::VRAM];
+        offset &= 0x1FFFF;
+        if(offset >= 0x18000) offset &= ~0x8000;
+        break;
+      }
+      case 0x07: span = &spans[(int)Region::OAM]; offset &= 0x3FF; break;
+      case 0x08 ... 0x0D: span = &spans[(int)Region::ROM]; offset = address & 0x01FF'FFFF; break;
+      case 0x0E ... 0x0F: span = &spans[(int)Region::Backup]; offset = address & 0x01FF'FFFF; break;
+      default: return 0;
+    }
+
+    return offset < span->size ? span->data[offset] : 0;
+  };
+
+  for(size_t i = 0; i < count; i++) {
+    const u32 address = reads[i].address;
+    const int size = std::clamp(reads[i].size, 1, 4);
+
+    u32 value = 0;
+
+    for(int j = 0; j < size; j++) {
+      value |= read_byte(address + j) << (j * 8);
+    }
+
+    values[i] = value;
+  }
+}
+
 auto CreateCore(
   std::shared_ptr<Config> config
 ) -> std::unique_ptr<CoreBase> {
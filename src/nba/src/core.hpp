@@ -16,6 +16,7 @@
 #include "hw/irq/irq.hpp"
 #include "hw/keypad/keypad.hpp"
 #include "hw/timer/timer.hpp"
+#include "hook_table.hpp"
 
 namespace nba::core {
 
@@ -30,7 +31,15 @@ struct Core final : CoreBase {
   auto CreateSolarSensor() -> std::unique_ptr<SolarSensor> override;
   void LoadState(SaveState const& state) override;
   void CopyState(SaveState& state) override;
+  void LoadStateIncremental(SaveState const& state) override;
+  void CopyStateIncremental(SaveState& state) override;
+  void LoadMixerState(u8 const* data) override;
+  void CopyMixerState(u8* data) override;
   void Run(int cycles) override;
+  auto StateHash() -> u64 override;
+  auto Clone(std::shared_ptr<Config> config) -> std::unique_ptr<CoreBase> override;
+  void SetAudioOutputEnable(bool enable) override;
+  void SetVideoOutputEnable(bool enable) override;
 
   auto GetROM() -> ROM& override;
   auto GetPRAM() -> u8* override;
@@ -42,15 +51,24 @@ struct Core final : CoreBase {
   auto GetBGVOFS(int id) -> u16 override;
 
   Scheduler& GetScheduler() override;
+  auto GetMemorySpan(MemoryRegion region) -> MemorySpan override;
 
 private:
   void SkipBootScreen();
-  auto SearchSoundMainRAM() -> u32;
+  void InstallMP2KHook(u32 sound_main_ram);
+  void LoadState(SaveState const& state, bool incremental);
+  void CopyState(SaveState& state, bool incremental);
 
-  u32 hle_audio_hook;
   std::shared_ptr<Config> config;
 
+  // Receives the register state for StateHash(), allocated on first use.
+  std::unique_ptr<SaveState> hash_state;
+
+  // Transfers the state to clones, allocated on first use.
+  std::unique_ptr<SaveState> clone_state;
+
   Scheduler scheduler;
+  HookTable hooks;
 
   arm::ARM7TDMI cpu;
   IRQ irq;
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <nba/common/compiler.hpp>
+#include <nba/integer.hpp>
+
+namespace nba::core {
+
+/**
+ * Tracks which pages of a memory have been written since the last checkpoint (snapshot or restore).
+ * Incremental snapshots only need to copy these pages, which makes their cost
+ * proportional to the working set rather than to the size of the memory.
+ *
+ * Independently of that, the pages that changed since the page hashes were last updated
+ * are tracked for PageHashTree.
+ */
+template<size_t size, int page_shift = 8>
+struct DirtyPageMap {
+  static constexpr size_t kPageSize = 1 << page_shift;
+  static constexpr size_t kPageCount = (size + kPageSize - 1) >> page_shift;
+
+  DirtyPageMap() { MarkAll(); }
+
+  void ALWAYS_INLINE Mark(u32 offset) {
+    const uint page = offset >> page_shift;
+    const u64 bit = 1ULL << (page & 63);
+
+    bits[page >> 6] |= bit;
+    hash_bits[page >> 6] |= bit;
+  }
+
+  void MarkAll() {
+    bits.fill(~0ULL);
+    hash_bits.fill(~0ULL);
+  }
+
+  // Starts a new checkpoint. The page hashes are not affected, since the memory did not change.
+  void Clear() {
+    bits.fill(0);
+  }
+
+  // Invalidates all page hashes, e.g. after the memory was overwritten from a snapshot.
+  void MarkAllForHashing() {
+    hash_bits.fill(~0ULL);
+  }
+
+  /**
+   * Copies all dirty pages from `src` to `dst` and clears the dirty state.
+   * Used in both directions: memory to snapshot and snapshot to memory.
+   * Since the copied pages might have changed in memory, their hashes are invalidated.
+   */
+  void CopyDirtyPages(u8* dst, u8 const* src) {
+    for(size_t i = 0; i < bits.size(); i++) {
+      u64 word = bits[i];
+
+      hash_bits[i] |= word;
+
+      for(size_t page = i * 64; word != 0 && page < kPageCount; page++) {
+        if(word & 1) {
+          const size_t offset = page << page_shift;
+
+          std::memcpy(dst + offset, src + offset, std::min(kPageSize, size - offset));
+        }
+
+        word >>= 1;
+      }
+
+      bits[i] = 0;
+    }
+  }
+
+  // Calls `functor(page)` for every page which changed since the last call.
+  template<typename Functor>
+  void ConsumePagesForHashing(Functor&& functor) {
+    for(size_t i = 0; i < hash_bits.size(); i++) {
+      u64 word = hash_bits[i];
+
+      for(size_t page = i * 64; word != 0 && page < kPageCount; page++) {
+        if(word & 1) {
+          functor(page);
+        }
+
+        word >>= 1;
+      }
+
+      hash_bits[i] = 0;
+    }
+  }
+
+private:
+  std::array<u64, (kPageCount + 63) / 64> bits;
+  std::array<u64, (kPageCount + 63) / 64> hash_bits;
+};
+
+} // namespace nba::core
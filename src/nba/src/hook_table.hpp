@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <array>
+#include <functional>
+#include <nba/common/compiler.hpp>
+#include <nba/integer.hpp>
+#include <vector>
+
+namespace nba::core {
+
+/**
+ * Calls high-level emulation routines when the CPU is about to execute
+ * the instruction at a given guest address.
+ *
+ * The instruction addresses are tracked in a small bitmap that is indexed by
+ * the (halfword-aligned) program counter. This way the common case of not
+ * hitting a hook costs a single bit test, and the (short) list of installed
+ * hooks is only searched on a potential hit.
+ */
+struct HookTable {
+  using Callback = std::function<void()>;
+
+  void Reset() {
+    filter.fill(0);
+    hooks.clear();
+  }
+
+  bool Empty() const {
+    return hooks.empty();
+  }
+
+  void Add(u32 address, Callback callback) {
+    auto index = GetFilterIndex(address);
+
+    filter[index >> 6] |= 1ULL << (index & 63);
+    hooks.push_back({address, std::move(callback)});
+  }
+
+  auto ALWAYS_INLINE MayHaveHook(u32 address) const -> bool {
+    auto index = GetFilterIndex(address);
+
+    return filter[index >> 6] & (1ULL << (index & 63));
+  }
+
+  void Call(u32 address) {
+    for(auto& hook : hooks) {
+      if(hook.address == address) {
+        hook.callback();
+      }
+    }
+  }
+
+private:
+  static constexpr int kFilterSize = 4096;
+
+  static constexpr auto GetFilterIndex(u32 address) -> uint {
+    return (address >> 1) & (kFilterSize - 1);
+  }
+
+  struct Hook {
+    u32 address;
+    Callback callback;
+  };
+
+  std::array<u64, kFilterSize / 64> filter {};
+  std::vector<Hook> hooks;
+};
+
+} // namespace nba::core
@@ -12,6 +12,7 @@
 #include <nba/common/dsp/resampler/sinc.hpp>
 
 #include "apu.hpp"
+#include "hw/timer/timer.hpp"
 
 namespace nba::core {
 
@@ -19,10 +20,12 @@ APU::APU(
   Scheduler& scheduler,
   DMA& dma,
   Bus& bus,
+  Timer& timer,
   std::shared_ptr<Config> config
 )   : mmio(scheduler)
     , scheduler(scheduler)
     , dma(dma)
+    , timer(timer)
     , mp2k(bus)
     , config(config) {
   scheduler.Register(Scheduler::EventClass::APU_mixer, this, &APU::StepMixer);
@@ -98,25 +101,59 @@ void APU::OnTimerOverflow(int timer_id, int times) {
       auto& fifo = mmio.fifo[fifo_id];
       auto& pipe = fifo_pipe[fifo_id];
 
-      if(fifo.Count() <= 3) {
-        dma.Request(occasion[fifo_id]);
-      }
+      for(int i = 0; i < times; i++) {
+        if(fifo.Count() <= 3) {
+          dma.Request(occasion[fifo_id]);
+        }
+
+        if(pipe.size == 0 && fifo.Count() > 0) {
+          pipe.word = fifo.ReadWord();
+          pipe.size = 4;
+        }
 
-      if(pipe.size == 0 && fifo.Count() > 0) {
-        pipe.word = fifo.ReadWord();
-        pipe.size = 4;
+        s8 sample = (s8)(u8)pipe.word;
+
+        if(pipe.size > 0) {
+          pipe.word >>= 8;
+          pipe.size--;
+        }
+
+        latch[fifo_id] = sample;
       }
+    }
+  }
+}
+
+auto APU::GetFIFOOverflowBudget(int timer_id) -> int {
+  auto const& soundcnt = mmio.soundcnt;
 
-      s8 sample = (s8)(u8)pipe.word;
+  if(!soundcnt.master_enable) {
+    return 0;
+  }
 
-      if(pipe.size > 0) {
-        pipe.word >>= 8;
-        pipe.size--;
+  int budget = 0;
+
+  for(int fifo_id = 0; fifo_id < 2; fifo_id++) {
+    if(soundcnt.dma[fifo_id].timer_id == timer_id) {
+      const int count = mmio.fifo[fifo_id].Count();
+
+      /* Calculate how many overflows will happen until (and including) the one that requests DMA.
+       * The pipe is drained first (one byte per overflow), after that one word is taken
+       * from the FIFO every four overflows. DMA is requested once the FIFO holds three words or less.
+       */
+      int fifo_budget = 1;
+
+      if(count > 3) {
+        fifo_budget = fifo_pipe[fifo_id].size + 2 + (count - 4) * 4;
       }
 
-      latch[fifo_id] = sample;
+      if(budget == 0 || fifo_budget < budget) {
+        budget = fifo_budget;
+      }
     }
   }
+
+  return budget;
 }
 
 void APU::StepMixer() {
@@ -138,6 +175,10 @@ void APU::StepMixer() {
 
     auto mp2k_sample = mp2k.ReadSample();
 
+    if(auto stems = config->stem_capture.get(); stems && output_enable) {
+      CaptureStems(*stems, mp2k_sample[0], mp2k_sample[1], 65536);
+    }
+
     for(int channel = 0; channel < 2; channel++) {
       s16 psg_sample = 0;
 
@@ -160,9 +201,11 @@ void APU::StepMixer() {
 
     if(!mmio.soundcnt.master_enable) sample = {};
 
-    buffer_mutex.lock();
-    resampler->Write(sample);
-    buffer_mutex.unlock();
+    if(output_enable) {
+      buffer_mutex.lock();
+      resampler->Write(sample);
+      buffer_mutex.unlock();
+    }
 
     scheduler.Add(256 - (scheduler.GetTimestampNow() & 255), Scheduler::EventClass::APU_mixer);
   } else {
@@ -170,11 +213,18 @@ void APU::StepMixer() {
 
     auto& bias = mmio.bias;
 
+    // The FIFO latches are updated by the timers, which may lag behind.
+    timer.Sync();
+
     if(bias.resolution != resolution_old) {
       resampler->SetSampleRates(bias.GetSampleRate(), config->audio_dev->GetSampleRate());
       resolution_old = mmio.bias.resolution;
     }
 
+    if(auto stems = config->stem_capture.get(); stems && output_enable) {
+      CaptureStems(*stems, latch[0] / 128.0f, latch[1] / 128.0f, bias.GetSampleRate());
+    }
+
     for(int channel = 0; channel < 2; channel++) {
       s16 psg_sample = 0;
 
@@ -198,9 +248,11 @@ void APU::StepMixer() {
 
     if(!mmio.soundcnt.master_enable) sample = {};
 
-    buffer_mutex.lock();
-    resampler->Write({ sample[0] / float(0x200), sample[1] / float(0x200) });
-    buffer_mutex.unlock();
+    if(output_enable) {
+      buffer_mutex.lock();
+      resampler->Write({ sample[0] / float(0x200), sample[1] / float(0x200) });
+      buffer_mutex.unlock();
+    }
 
     const int sample_interval = mmio.bias.GetSampleInterval();
     const int cycles = sample_interval - (scheduler.GetTimestampNow() & (sample_interval - 1));
@@ -209,6 +261,19 @@ void APU::StepMixer() {
   }
 }
 
+void APU::CaptureStems(StemCapture& stems, float fifo_a, float fifo_b, int sample_rate) {
+  const StemCapture::Frame frame {
+    mmio.psg1.GetSample() / 128.0f,
+    mmio.psg2.GetSample() / 128.0f,
+    mmio.psg3.GetSample() / 128.0f,
+    mmio.psg4.GetSample() / 128.0f,
+    fifo_a,
+    fifo_b
+  };
+
+  stems.Write(frame, sample_rate);
+}
+
 void APU::StepSequencer() {
   mmio.psg1.Tick();
   mmio.psg2.Tick();
@@ -27,11 +27,14 @@ namespace nba::core {
 // See callback.cpp for implementation
 void AudioCallback(struct APU* apu, s16* stream, int byte_len);
 
+struct Timer;
+
 struct APU {
   APU(
     Scheduler& scheduler,
     DMA& dma,
     Bus& bus,
+    Timer& timer,
     std::shared_ptr<Config>
   );
 
@@ -39,17 +42,19 @@ struct APU {
 
   void Reset();
   auto GetMP2K() -> MP2K& { return mp2k; }
+  void SetOutputEnable(bool enable) { output_enable = enable; }
   void OnTimerOverflow(int timer_id, int times);
+  auto GetFIFOOverflowBudget(int timer_id) -> int;
 
   void LoadState(SaveState const& state);
   void CopyState(SaveState& state);
 
   struct MMIO {
     MMIO(Scheduler& scheduler)
-        : psg1(scheduler, Scheduler::EventClass::APU_PSG1_generate)
-        , psg2(scheduler, Scheduler::EventClass::APU_PSG2_generate)
+        : psg1(scheduler)
+        , psg2(scheduler)
         , psg3(scheduler)
-        , psg4(scheduler, bias) {
+        , psg4(scheduler) {
     }
 
     FIFO fifo[2];
@@ -77,15 +82,18 @@ private:
 
   void StepMixer();
   void StepSequencer();
+  void CaptureStems(StemCapture& stems, float fifo_a, float fifo_b, int sample_rate);
 
   s8 latch[2];
 
   Scheduler& scheduler;
   DMA& dma;
+  Timer& timer;
   MP2K mp2k;
   int mp2k_read_index;
   std::shared_ptr<Config> config;
   int resolution_old = 0;
+  bool output_enable = true;
 };
 
 } // namespace nba::core
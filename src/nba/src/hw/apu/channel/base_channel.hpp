@@ -12,6 +12,7 @@
 #include "hw/apu/channel/length_counter.hpp"
 #include "hw/apu/channel/envelope.hpp"
 #include "hw/apu/channel/sweep.hpp"
+#include "hw/apu/channel/synthesis_clock.hpp"
 
 namespace nba::core {
 
@@ -32,15 +33,22 @@ public:
   virtual bool IsEnabled() { return enabled; }
   virtual auto GetSample() -> s8 = 0;
 
+  // Catch up with all synthesis steps up until the current timestamp.
+  virtual void Sync() = 0;
+
   void Reset() {
     length.Reset();
     envelope.Reset();
     sweep.Reset();
+    clock.Reset();
     enabled = false;
     step = 0;
   }
 
   void Tick() {
+    // The frame sequencer may change the synthesis parameters.
+    Sync();
+
     // http://gbdev.gg8.se/wiki/articles/Gameboy_sound_hardware#Frame_Sequencer
     if((step & 1) == 0) enabled &= length.Tick();
     if((step & 3) == 2) enabled &= sweep.Tick();
@@ -69,6 +77,7 @@ protected:
   LengthCounter length;
   Envelope envelope;
   Sweep sweep;
+  SynthesisClock clock;
 
 private:
   bool enabled;
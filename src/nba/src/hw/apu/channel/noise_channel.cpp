@@ -6,16 +6,12 @@
  */
 
 #include "hw/apu/channel/noise_channel.hpp"
-#include "hw/apu/registers.hpp"
 
 namespace nba::core {
 
-NoiseChannel::NoiseChannel(Scheduler& scheduler, BIAS& bias)
+NoiseChannel::NoiseChannel(Scheduler& scheduler)
     : BaseChannel(true, false)
-    , scheduler(scheduler)
-    , bias(bias) {
-  scheduler.Register(Scheduler::EventClass::APU_PSG4_generate, this, &NoiseChannel::Generate);
-  
+    , scheduler(scheduler) {
   Reset();
 }
 
@@ -29,36 +25,28 @@ void NoiseChannel::Reset() {
 
   lfsr = 0;
   sample = 0;
-  skip_count = 0;
-
-  event = nullptr;
 }
 
-void NoiseChannel::Generate() {
+void NoiseChannel::Sync() {
+  const u64 steps = clock.Advance(
+    scheduler.GetTimestampNow(), GetSynthesisInterval(frequency_ratio, frequency_shift));
+
+  if(steps == 0) {
+    return;
+  }
+
   if(!IsEnabled()) {
     sample = 0;
-    event = nullptr;
+    clock.Stop();
     return;
   }
 
   static constexpr u16 lfsr_xor[2] = { 0x6000, 0x60 };
 
-  int carry = lfsr & 1;
+  int carry = 0;
 
-  lfsr >>= 1;
-  if(carry) {
-    lfsr ^= lfsr_xor[width];
-    sample = +8;
-  } else {
-    sample = -8;
-  }
-
-  sample *= envelope.current_volume;
-
-  if(!dac_enable) sample = 0;
-
-  // Skip samples that will never be sampled by the audio mixer.
-  for(int i = 0; i < skip_count; i++) {
+  // There is no closed form for the LFSR, but clocking it is cheap.
+  for(u64 i = 0; i < steps; i++) {
     carry = lfsr & 1;
     lfsr >>= 1;
     if(carry) {
@@ -66,23 +54,12 @@ void NoiseChannel::Generate() {
     }
   }
 
-  int noise_interval = GetSynthesisInterval(frequency_ratio, frequency_shift);
-  int mixer_interval = bias.GetSampleInterval();
-
-  /* If a channel generates at a higher rate than
-   * the audio mixer samples it, then it will generate samples
-   * that will be skipped anyways.
-   * In that case we can sample the channel at the same rate
-   * as the mixer rate and only output the sample that will be used.
-   */
-  if(noise_interval < mixer_interval) {
-    skip_count = mixer_interval/noise_interval - 1;
-    noise_interval = mixer_interval;
+  // Only the sample generated by the most recent step is observable.
+  if(dac_enable) {
+    sample = s8((carry ? +8 : -8) * envelope.current_volume);
   } else {
-    skip_count = 0;
+    sample = 0;
   }
-
-  event = scheduler.Add(noise_interval, Scheduler::EventClass::APU_PSG4_generate);
 }
 
 auto NoiseChannel::Read(int offset) -> u8 {
@@ -112,6 +89,8 @@ auto NoiseChannel::Read(int offset) -> u8 {
 }
 
 void NoiseChannel::Write(int offset, u8 value) {
+  Sync();
+
   switch(offset) {
     // Length / Envelope
     case 0: {
@@ -142,11 +121,7 @@ void NoiseChannel::Write(int offset, u8 value) {
 
       if(dac_enable && (value & 0x80)) {
         if(!IsEnabled()) {
-          skip_count = 0;
-          if(event) {
-            scheduler.Cancel(event);
-          }
-          event = scheduler.Add(GetSynthesisInterval(frequency_ratio, frequency_shift), Scheduler::EventClass::APU_PSG4_generate);
+          clock.Start(scheduler.GetTimestampNow(), GetSynthesisInterval(frequency_ratio, frequency_shift));
         }
 
         static constexpr u16 lfsr_init[] = { 0x4000, 0x0040 };
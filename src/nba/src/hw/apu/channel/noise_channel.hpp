@@ -14,15 +14,13 @@
 
 namespace nba::core {
 
-struct BIAS;
-
 class NoiseChannel : public BaseChannel {
 public:
-  NoiseChannel(Scheduler& scheduler, BIAS& bias);
+  NoiseChannel(Scheduler& scheduler);
 
   void Reset();
-  auto GetSample() -> s8 override { return sample; }
-  void Generate();
+  auto GetSample() -> s8 override { Sync(); return sample; }
+  void Sync() override;
   auto Read (int offset) -> u8;
   void Write(int offset, u8 value);
 
@@ -46,15 +44,11 @@ private:
   s8 sample = 0;
 
   Scheduler& scheduler;
-  Scheduler::Event* event;
 
   int frequency_shift;
   int frequency_ratio;
   int width;
   bool dac_enable;
-
-  BIAS& bias;
-  int skip_count;
 };
 
 } // namespace nba::core
@@ -16,11 +16,11 @@ namespace nba::core {
 
 class QuadChannel final : public BaseChannel {
 public:
-  QuadChannel(Scheduler& scheduler, Scheduler::EventClass event_class);
+  QuadChannel(Scheduler& scheduler);
 
   void Reset();
-  auto GetSample() -> s8 override { return sample; }
-  void Generate();
+  auto GetSample() -> s8 override { Sync(); return sample; }
+  void Sync() override;
   auto Read (int offset) -> u8;
   void Write(int offset, u8 value);
 
@@ -36,8 +36,6 @@ private:
   }
 
   Scheduler& scheduler;
-  Scheduler::EventClass event_class;
-  Scheduler::Event* event;
 
   s8 sample = 0;
   int phase;
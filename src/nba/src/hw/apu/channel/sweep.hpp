@@ -17,10 +17,14 @@ namespace nba::core {
 class Sweep {
 public:
   void Reset() {
+    active = false;
     direction = Direction::Increment;
     initial_freq = 0;
+    current_freq = 0;
+    shadow_freq = 0;
     divider = 0;
     shift = 0;
+    step = 0;
     Restart();
   }
 
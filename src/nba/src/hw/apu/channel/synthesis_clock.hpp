@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <nba/integer.hpp>
+
+namespace nba::core {
+
+/**
+ * Keeps track of the synthesis steps of a PSG channel without
+ * scheduling an event for every single step.
+ *
+ * The channel state is only advanced when it is observed (the mixer samples the channel)
+ * or about to be modified (register writes and frame sequencer ticks).
+ * Because the synthesis parameters cannot change between two of these points in time,
+ * the number of elapsed steps can be derived from the elapsed cycles alone.
+ */
+struct SynthesisClock {
+  void Reset() {
+    running = false;
+    timestamp_next = 0;
+  }
+
+  void Start(u64 timestamp_now, int interval) {
+    running = true;
+    timestamp_next = timestamp_now + interval;
+  }
+
+  void Stop() {
+    running = false;
+  }
+
+  /**
+   * Returns the number of steps that happened up until (and including) `timestamp_now`.
+   * The first step happens at the previously calculated timestamp,
+   * all following steps are `interval` cycles apart.
+   */
+  auto Advance(u64 timestamp_now, int interval) -> u64 {
+    if(!running || timestamp_now < timestamp_next) {
+      return 0;
+    }
+
+    const u64 steps = 1 + (timestamp_now - timestamp_next) / interval;
+
+    timestamp_next += steps * interval;
+    return steps;
+  }
+
+  bool running;
+  u64 timestamp_next;
+};
+
+} // namespace nba::core
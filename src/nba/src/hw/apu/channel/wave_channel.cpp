@@ -12,8 +12,6 @@ namespace nba::core {
 WaveChannel::WaveChannel(Scheduler& scheduler)
     : BaseChannel(false, false, 256)
     , scheduler(scheduler) {
-  scheduler.Register(Scheduler::EventClass::APU_PSG3_generate, this, &WaveChannel::Generate);
-
   Reset(WaveChannel::ResetWaveRAM::Yes);
 }
 
@@ -37,24 +35,35 @@ void WaveChannel::Reset(ResetWaveRAM reset_wave_ram) {
       }
     }
   }
-
-  event = nullptr;
 }
 
-void WaveChannel::Generate() {
+void WaveChannel::Sync() {
+  const u64 steps = clock.Advance(
+    scheduler.GetTimestampNow(), GetSynthesisIntervalFromFrequency(frequency));
+
+  if(steps == 0) {
+    return;
+  }
+
   if(!IsEnabled()) {
     sample = 0;
-    if(BaseChannel::IsEnabled()) {
-      event = scheduler.Add(GetSynthesisIntervalFromFrequency(frequency), Scheduler::EventClass::APU_PSG3_generate);
-    } else {
-      event = nullptr;
+    if(!BaseChannel::IsEnabled()) {
+      clock.Stop();
     }
     return;
   }
 
-  auto byte = wave_ram[wave_bank][phase / 2];
+  // Only the sample generated by the most recent step is observable.
+  const u64 position = phase + steps - 1;
 
-  if((phase % 2) == 0) {
+  int bank = wave_bank;
+  if(dimension && ((position / 32) & 1)) {
+    bank ^= 1;
+  }
+
+  auto byte = wave_ram[bank][(position % 32) / 2];
+
+  if((position % 2) == 0) {
     sample = byte >> 4;
   } else {
     sample = byte & 15;
@@ -64,17 +73,15 @@ void WaveChannel::Generate() {
 
   sample = (sample - 8) * 4 * (force_volume ? 3 : volume_table[volume]);
 
-  if(++phase == 32) {
-    phase = 0;
-    if(dimension) {
-      wave_bank ^= 1;
-    }
+  if(dimension && (((phase + steps) / 32) & 1)) {
+    wave_bank ^= 1;
   }
-
-  event = scheduler.Add(GetSynthesisIntervalFromFrequency(frequency), Scheduler::EventClass::APU_PSG3_generate);
+  phase = (phase + steps) % 32;
 }
 
 auto WaveChannel::Read(int offset) -> u8 {
+  Sync();
+
   switch(offset) {
     // Stop / Wave RAM select
     case 0: {
@@ -102,6 +109,8 @@ auto WaveChannel::Read(int offset) -> u8 {
 }
 
 void WaveChannel::Write(int offset, u8 value) {
+  Sync();
+
   switch(offset) {
     // Stop / Wave RAM select
     case 0: {
@@ -134,10 +143,7 @@ void WaveChannel::Write(int offset, u8 value) {
 
       if(playing && (value & 0x80)) {
         if(!BaseChannel::IsEnabled()) {
-          if(event) {
-            scheduler.Cancel(event);
-          }
-          event = scheduler.Add(GetSynthesisIntervalFromFrequency(frequency), Scheduler::EventClass::APU_PSG3_generate);
+          clock.Start(scheduler.GetTimestampNow(), GetSynthesisIntervalFromFrequency(frequency));
         }
         phase = 0;
         if(dimension) {
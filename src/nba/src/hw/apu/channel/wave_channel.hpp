@@ -25,8 +25,8 @@ public:
 
   void Reset(ResetWaveRAM reset_wave_ram);
   bool IsEnabled() override { return playing && BaseChannel::IsEnabled(); }
-  auto GetSample() -> s8 override { return sample; }
-  void Generate();
+  auto GetSample() -> s8 override { Sync(); return sample; }
+  void Sync() override;
   auto Read (int offset) -> u8;
   void Write(int offset, u8 value);
 
@@ -34,10 +34,12 @@ public:
   void CopyState(SaveState::APU::IO::WaveChannel& state);
 
   auto ReadSample(int offset) -> u8 {
+    Sync();
     return wave_ram[wave_bank ^ 1][offset];
   }
 
   void WriteSample(int offset, u8 value) {
+    Sync();
     wave_ram[wave_bank ^ 1][offset] = value;
   }
 
@@ -48,7 +50,6 @@ private:
   }
 
   Scheduler& scheduler;
-  Scheduler::Event* event = nullptr;
 
   s8 sample = 0;
   bool playing;
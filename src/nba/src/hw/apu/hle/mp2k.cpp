@@ -5,6 +5,9 @@
  * Refer to the included LICENSE file.
  */
 
+#include <algorithm>
+#include <cstring>
+#include <nba/common/punning.hpp>
 #include <nba/log.hpp>
 
 #include "bus/bus.hpp"
@@ -16,19 +19,120 @@ void MP2K::Reset() {
   engaged = false;
   current_frame = 0;
   buffer_read_index = 0;
+  sound_info_pointer = nullptr;
+  cached_sound_info_address = 0;
+  cached_sound_info = nullptr;
+  latch = {};
 
   for(auto& sampler : samplers) sampler = {};
   for(auto& envelope : envelopes) envelope = {};
 }
 
-void MP2K::SoundMainRAM(SoundInfo const& sound_info) {
-  if(sound_info.magic != 0x68736D54) {
+void MP2K::CopyFrom(MP2K const& other) {
+  Reset();
+
+  engaged = other.engaged;
+  current_frame = other.current_frame;
+  buffer_read_index = other.buffer_read_index;
+  latch = other.latch;
+
+  for(int i = 0; i < kMaxSoundChannels; i++) {
+    samplers[i] = other.samplers[i];
+    envelopes[i] = other.envelopes[i];
+
+    // The wave data may be in the other core's memory, so it is looked up again on the next frame.
+    samplers[i].wave_data = nullptr;
+  }
+
+  if(other.buffer) {
+    const int length = k_samples_per_frame * k_total_frame_count * 2;
+
+    buffer = std::make_unique<float[]>(length);
+    std::copy_n(other.buffer.get(), length, buffer.get());
+  }
+}
+
+void MP2K::CopyState(u8* data) const {
+  StateHeader header;
+
+  header.engaged = engaged;
+  header.current_frame = current_frame;
+  header.buffer_read_index = buffer_read_index;
+  header.latch = latch;
+
+  for(int i = 0; i < kMaxSoundChannels; i++) {
+    header.samplers[i] = samplers[i];
+    header.samplers[i].wave_data = nullptr;
+    header.envelopes[i] = envelopes[i];
+  }
+
+  std::memcpy(data, &header, sizeof(header));
+
+  // The buffer is only allocated once the mixer is engaged.
+  if(engaged) {
+    std::memcpy(data + sizeof(header), buffer.get(), GetStateSize() - sizeof(header));
+  }
+}
+
+void MP2K::LoadState(u8 const* data) {
+  StateHeader header;
+
+  std::memcpy(&header, data, sizeof(header));
+
+  Reset();
+
+  engaged = header.engaged;
+  current_frame = header.current_frame;
+  buffer_read_index = header.buffer_read_index;
+  latch = header.latch;
+
+  // The wave data pointers are not stored, they are looked up again on the next frame.
+  for(int i = 0; i < kMaxSoundChannels; i++) {
+    samplers[i] = header.samplers[i];
+    envelopes[i] = header.envelopes[i];
+  }
+
+  if(engaged) {
+    if(!buffer) {
+      buffer = std::make_unique<float[]>(k_samples_per_frame * k_total_frame_count * 2);
+    }
+
+    std::memcpy(buffer.get(), data + sizeof(header), GetStateSize() - sizeof(header));
+  }
+}
+
+auto MP2K::GetSoundInfo() -> SoundInfo const* {
+  // The SoundInfo pointer is stored at a fixed location in IWRAM.
+  if(!sound_info_pointer) {
+    sound_info_pointer = bus.GetHostAddress(0x03007FF0, sizeof(u32));
+  }
+
+  const auto address = read<u32>(sound_info_pointer, 0);
+
+  // Only translate the guest address again if the game changed the pointer.
+  if(address != cached_sound_info_address || !cached_sound_info) {
+    cached_sound_info_address = address;
+
+    if((address & 3) == 0) {
+      cached_sound_info = bus.TryGetHostAddress<SoundInfo>(address);
+    } else {
+      cached_sound_info = nullptr;
+    }
+  }
+
+  return cached_sound_info;
+}
+
+void MP2K::SoundMainRAM() {
+  const auto sound_info = GetSoundInfo();
+
+  if(!sound_info || sound_info->magic != 0x68736D54) {
     return;
   }
 
   if(!engaged) {
     Assert(
-      sound_info.pcm_samples_per_vblank != 0,
+      sound_info->pcm_samples_per_vblank != 0,
       "MP2K: samples per V-blank must not be zero."
     );
 
@@ -36,61 +140,71 @@ void MP2K::SoundMainRAM(SoundInfo const& sound_info) {
     engaged = true;
   }
 
-  auto max_channels = std::min(sound_info.max_channels, kMaxSoundChannels);
+  auto max_channels = std::min(sound_info->max_channels, kMaxSoundChannels);
 
-  this->sound_info = sound_info;
+  latch.reverb = sound_info->reverb;
+  latch.max_channels = max_channels;
+  latch.pcm_sample_rate = sound_info->pcm_sample_rate;
 
   // Update the channel state and envelope volume for this audio frame
   for(int i = 0; i < max_channels; i++) {
-    auto& channel = this->sound_info.channels[i];
+    auto const& channel = sound_info->channels[i];
+    auto& channel_latch = latch.channels[i];
 
-    if((channel.status & CHANNEL_ON) == 0) {
+    auto status = channel.status;
+
+    channel_latch.status = status;
+    channel_latch.type = channel.type;
+    channel_latch.frequency = channel.frequency;
+    channel_latch.wave_address = channel.wave_address;
+
+    if((status & CHANNEL_ON) == 0) {
       continue;
     }
 
     auto& sampler = samplers[i];
     auto  envelope_volume = u32(channel.envelope_volume);
-    auto  envelope_phase = channel.status & CHANNEL_ENV_MASK;
+    auto  envelope_phase = status & CHANNEL_ENV_MASK;
 
     float hq_envelope_volume[2];
 
     hq_envelope_volume[0] = envelopes[i].volume;
 
-    if(channel.status & CHANNEL_START) {
-      if(channel.status & CHANNEL_STOP) {
-        channel.status = 0;
+    if(status & CHANNEL_START) {
+      if(status & CHANNEL_STOP) {
+        channel_latch.status = 0;
         continue;
       }
 
       envelope_volume = channel.envelope_attack;
       if(envelope_volume == 0xFF) {
-        channel.status = CHANNEL_ENV_DECAY;
+        status = CHANNEL_ENV_DECAY;
       } else {
-        channel.status = CHANNEL_ENV_ATTACK;
+        status = CHANNEL_ENV_ATTACK;
       }
       hq_envelope_volume[0] = U8ToFloat(channel.envelope_attack);
 
       sampler = {};
       sampler.wave_info = *bus.GetHostAddress<Sampler::WaveInfo>(channel.wave_address);
       if(sampler.wave_info.status & 0xC000) {
-        channel.status |= CHANNEL_LOOP;
+        status |= CHANNEL_LOOP;
       }
-    } else if(channel.status & CHANNEL_ECHO) {
-      if(channel.echo_length-- == 0) {
-        channel.status = 0;
+    } else if(status & CHANNEL_ECHO) {
+      if(channel.echo_length == 0) {
+        channel_latch.status = 0;
         continue;
       }
-    } else if(channel.status & CHANNEL_STOP) {
+    } else if(status & CHANNEL_STOP) {
       envelope_volume = (envelope_volume * channel.envelope_release) >> 8;
       hq_envelope_volume[0] *= U8ToFloat(channel.envelope_release);
 
       if(envelope_volume <= channel.echo_volume) {
         if(channel.echo_volume == 0) {
-          channel.status = 0;
+          channel_latch.status = 0;
           continue;
         }
 
-        channel.status |= CHANNEL_ECHO;
+        status |= CHANNEL_ECHO;
         envelope_volume = (u32)channel.echo_volume;
         hq_envelope_volume[0] = U8ToFloat(channel.echo_volume);
       }
@@ -99,7 +213,7 @@ void MP2K::SoundMainRAM(SoundInfo const& sound_info) {
       hq_envelope_volume[0] = std::min(1.0f, hq_envelope_volume[0] + U8ToFloat(channel.envelope_attack));
 
       if(envelope_volume > 0xFE) {
-        channel.status = (channel.status & ~CHANNEL_ENV_MASK) | CHANNEL_ENV_DECAY;
+        status = (status & ~CHANNEL_ENV_MASK) | CHANNEL_ENV_DECAY;
         envelope_volume = 0xFF;
       }
     } else if(envelope_phase == CHANNEL_ENV_DECAY) {
@@ -109,32 +223,30 @@ void MP2K::SoundMainRAM(SoundInfo const& sound_info) {
       auto envelope_sustain = channel.envelope_sustain;
       if(envelope_volume <= envelope_sustain) {
         if(envelope_sustain == 0 && channel.echo_volume == 0) {
-          channel.status = 0;
+          channel_latch.status = 0;
           continue;
         }
 
-        channel.status = (channel.status & ~CHANNEL_ENV_MASK) | CHANNEL_ENV_SUSTAIN;
+        status = (status & ~CHANNEL_ENV_MASK) | CHANNEL_ENV_SUSTAIN;
         envelope_volume = envelope_sustain;
         hq_envelope_volume[0] = U8ToFloat(envelope_sustain);
       }
     }
 
-    channel.envelope_volume = u8(envelope_volume);
-    envelope_volume = (envelope_volume * (this->sound_info.master_volume + 1)) >> 4;
-    channel.envelope_volume_r = u8((envelope_volume * channel.volume_r) >> 8);
-    channel.envelope_volume_l = u8((envelope_volume * channel.volume_l) >> 8);
+    channel_latch.status = status;
+    envelope_volume = (envelope_volume * (sound_info->master_volume + 1)) >> 4;
 
     // Try to predict the envelope's value at the start of the next audio frame,
     // so that we can linearly interpolate the envelope between the current and next frame.
-    if(channel.status & CHANNEL_STOP) {
+    if(status & CHANNEL_STOP) {
       if(((envelope_volume * channel.envelope_release) >> 8) <= channel.echo_volume) {
         hq_envelope_volume[1] = U8ToFloat(channel.echo_volume);
       } else {
         hq_envelope_volume[1] = hq_envelope_volume[0] * U8ToFloat(channel.envelope_release);
       }
-    } else if((channel.status & CHANNEL_ENV_MASK) == CHANNEL_ENV_ATTACK) {
+    } else if((status & CHANNEL_ENV_MASK) == CHANNEL_ENV_ATTACK) {
       hq_envelope_volume[1] = std::min(1.0f, hq_envelope_volume[0] + U8ToFloat(channel.envelope_attack));
-    } else if((channel.status & CHANNEL_ENV_MASK) == CHANNEL_ENV_DECAY) {
+    } else if((status & CHANNEL_ENV_MASK) == CHANNEL_ENV_DECAY) {
       if(((envelope_volume * channel.envelope_decay) >> 8) <= channel.envelope_sustain) {
         hq_envelope_volume[1] = U8ToFloat(channel.envelope_sustain);
       } else {
@@ -144,7 +256,7 @@ void MP2K::SoundMainRAM(SoundInfo const& sound_info) {
       hq_envelope_volume[1] = hq_envelope_volume[0];
     }
 
-    const float hq_master_volume = (sound_info.master_volume + 1) / 16.0;
+    const float hq_master_volume = (sound_info->master_volume + 1) / 16.0;
     const float hq_volume_r = hq_master_volume * U8ToFloat(channel.volume_r);
     const float hq_volume_l = hq_master_volume * U8ToFloat(channel.volume_l);
 
@@ -167,8 +279,8 @@ void MP2K::RenderFrame() {
 
   current_frame = (current_frame + 1) % k_total_frame_count;
 
-  const auto reverb_strength = force_reverb ? std::max(sound_info.reverb, (u8)48) : sound_info.reverb;
-  const auto max_channels = std::min(sound_info.max_channels, kMaxSoundChannels);
+  const auto reverb_strength = force_reverb ? std::max(latch.reverb, (u8)48) : latch.reverb;
+  const auto max_channels = latch.max_channels;
   const auto destination = &buffer[current_frame * k_samples_per_frame * 2];
 
   if(reverb_strength > 0) {
@@ -178,7 +290,7 @@ void MP2K::RenderFrame() {
   }
 
   for(int i = 0; i < max_channels; i++) {
-    auto& channel = sound_info.channels[i];
+    auto const& channel = latch.channels[i];
     auto& sampler = samplers[i];
     auto& envelope = envelopes[i];
 
@@ -189,7 +301,7 @@ void MP2K::RenderFrame() {
     float angular_step;
 
     if(channel.type & 8) {
-      angular_step = sound_info.pcm_sample_rate / float(k_sample_rate);
+      angular_step = latch.pcm_sample_rate / float(k_sample_rate);
     } else {
       angular_step = channel.frequency / float(k_sample_rate);
     }
@@ -82,7 +82,15 @@ struct MP2K {
   }
 
   void Reset();  
-  void SoundMainRAM(SoundInfo const& sound_info);
+
+  // Continues from the state of another core's mixer, e.g. for Core::Clone().
+  void CopyFrom(MP2K const& other);
+
+  // Copies the mixer state from or to GetStateSize() bytes, e.g. for CoreBase::Snapshot().
+  void CopyState(u8* data) const;
+  void LoadState(u8 const* data);
+
+  void SoundMainRAM();
   void RenderFrame();
   auto ReadSample() -> float*;
 
@@ -99,6 +107,7 @@ private:
     return value / 256.0;
   }
 
+  auto GetSoundInfo() -> SoundInfo const*;
   void RenderReverb(float* destination, u8 strength);
 
   struct Sampler {
@@ -125,14 +134,44 @@ private:
     float volume_r[2] {0.0, 0.0};
   } envelopes[kMaxSoundChannels];
 
+  // Subset of the SoundInfo state that is latched for rendering the next audio frame.
+  struct Latch {
+    u8 reverb = 0;
+    u8 max_channels = 0;
+    s32 pcm_sample_rate = 0;
+
+    struct Channel {
+      u8 status = 0;
+      u8 type = 0;
+      u32 frequency = 0;
+      u32 wave_address = 0;
+    } channels[kMaxSoundChannels];
+  } latch;
+
   bool engaged;
   bool use_cubic_filter = false;
   bool force_reverb = false;
   Bus& bus;
-  SoundInfo sound_info;
+  u8* sound_info_pointer;
+  u32 cached_sound_info_address;
+  SoundInfo const* cached_sound_info;
   std::unique_ptr<float[]> buffer;
   int current_frame;
   int buffer_read_index;
+
+  struct StateHeader {
+    bool engaged;
+    int current_frame;
+    int buffer_read_index;
+    Latch latch;
+    Sampler samplers[kMaxSoundChannels];
+    Envelope envelopes[kMaxSoundChannels];
+  };
+
+public:
+  static constexpr auto GetStateSize() -> size_t {
+    return sizeof(StateHeader) + k_samples_per_frame * k_total_frame_count * 2 * sizeof(float);
+  }
 };
 
 } // namespace nba::core
@@ -12,6 +12,8 @@
 namespace nba::core {
 
 void APU::LoadState(SaveState const& state) {
+  // Restored directly, because disabling the APU via SOUNDCNT_X would reset the channels.
+  mmio.soundcnt.master_enable = state.apu.io.master_enable;
   mmio.soundcnt.WriteWord(state.apu.io.soundcnt);
   mmio.bias.WriteHalf(state.apu.io.soundbias);
 
@@ -29,13 +31,14 @@ void APU::LoadState(SaveState const& state) {
 
   resolution_old = state.apu.resolution_old;
 
-  // We are simply resetting the MP2K mixer for now,
-  // there probably is no need to do complicated (de)serialization.
+  // Save states do not include the MP2K mixer, so it is reset here.
+  // Snapshots restore it afterwards, see CoreBase::Restore().
   mp2k.Reset();
 }
 
 void APU::CopyState(SaveState& state) {
   state.apu.io.soundcnt = mmio.soundcnt.ReadWord();
+  state.apu.io.master_enable = mmio.soundcnt.master_enable;
   state.apu.io.soundbias = mmio.bias.ReadHalf();
 
   mmio.psg1.CopyState(state.apu.io.quad[0]);
@@ -74,11 +77,15 @@ void BaseChannel::LoadState(SaveState::APU::IO::PSG const& state) {
   sweep.active = state.sweep.active;
   sweep.direction = (Sweep::Direction)state.sweep.direction;
   sweep.initial_freq = state.sweep.initial_freq;
-  sweep.initial_freq = state.sweep.current_freq;
+  sweep.current_freq = state.sweep.current_freq;
   sweep.shadow_freq = state.sweep.shadow_freq;
   sweep.divider = state.sweep.divider;
   sweep.shift = state.sweep.shift;
   sweep.step = state.sweep.step;
+
+  // Synthesis
+  clock.running = state.clock.running;
+  clock.timestamp_next = state.clock.timestamp_next;
 }
 
 void BaseChannel::CopyState(SaveState::APU::IO::PSG& state) {
@@ -107,6 +114,10 @@ void BaseChannel::CopyState(SaveState::APU::IO::PSG& state) {
   state.sweep.divider = sweep.divider;
   state.sweep.shift = sweep.shift;
   state.sweep.step = sweep.step;
+
+  // Synthesis
+  state.clock.running = clock.running;
+  state.clock.timestamp_next = clock.timestamp_next;
 }
 
 void QuadChannel::LoadState(SaveState::APU::IO::QuadChannel const& state) {
@@ -116,7 +127,6 @@ void QuadChannel::LoadState(SaveState::APU::IO::QuadChannel const& state) {
   phase = state.phase;
   wave_duty = state.wave_duty;
   sample = state.sample;
-  event = scheduler.GetEventByUID(state.event_uid);
 }
 
 void QuadChannel::CopyState(SaveState::APU::IO::QuadChannel& state) {
@@ -126,7 +136,6 @@ void QuadChannel::CopyState(SaveState::APU::IO::QuadChannel& state) {
   state.phase = phase;
   state.wave_duty = wave_duty;
   state.sample = sample;
-  state.event_uid = GetEventUID(event);
 }
 
 void WaveChannel::LoadState(SaveState::APU::IO::WaveChannel const& state) {
@@ -139,7 +148,6 @@ void WaveChannel::LoadState(SaveState::APU::IO::WaveChannel const& state) {
   frequency = state.frequency;
   dimension = state.dimension;
   wave_bank = state.wave_bank;
-  event = scheduler.GetEventByUID(state.event_uid);
 
   std::memcpy(wave_ram, state.wave_ram, sizeof(wave_ram));
 }
@@ -154,7 +162,6 @@ void WaveChannel::CopyState(SaveState::APU::IO::WaveChannel& state) {
   state.frequency = frequency;
   state.dimension = dimension;
   state.wave_bank = wave_bank;
-  state.event_uid = GetEventUID(event);
 
   std::memcpy(state.wave_ram, wave_ram, sizeof(wave_ram));
 }
@@ -166,7 +173,6 @@ void NoiseChannel::LoadState(SaveState::APU::IO::NoiseChannel const& state) {
   frequency_shift = state.frequency_shift;
   frequency_ratio = state.frequency_ratio;
   width = state.width;
-  event = scheduler.GetEventByUID(state.event_uid);
 }
 
 void NoiseChannel::CopyState(SaveState::APU::IO::NoiseChannel& state) {
@@ -176,7 +182,6 @@ void NoiseChannel::CopyState(SaveState::APU::IO::NoiseChannel& state) {
   state.frequency_shift = frequency_shift;
   state.frequency_ratio = frequency_ratio;
   state.width = width;
-  state.event_uid = GetEventUID(event);
 }
 
 } // namespace nba::core
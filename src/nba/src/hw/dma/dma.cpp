@@ -84,6 +84,7 @@ void DMA::Reset() {
   vblank_set = 0;
   video_set = 0;
   runnable_set = 0;
+  latch = 0;
 
   for(int id = 0; id < 4; id++) {
     channels[id] = {};
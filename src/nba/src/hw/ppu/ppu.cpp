@@ -42,6 +42,9 @@ void PPU::Reset() {
   std::memset(pram, 0, 0x00400);
   std::memset(oam,  0, 0x00400);
   std::memset(vram, 0, 0x18000);
+  dirty_pages.pram.MarkAll();
+  dirty_pages.oam.MarkAll();
+  dirty_pages.vram.MarkAll();
 
   vram_bg_latch = 0U;
 
@@ -177,8 +180,12 @@ void PPU::BeginHDrawVBlank() {
     scheduler.Add(1007, Scheduler::EventClass::PPU_hblank_vdraw);
     vcount = 0;
 
-    config->video_dev->Draw(output[frame]);
-    frame ^= 1;
+    // Frames that are not output are rendered into the back buffer,
+    // so that the buffer which has been passed to the video device stays intact.
+    if(output_enable) {
+      config->video_dev->Draw(output[frame]);
+      frame ^= 1;
+    }
 
     InitBackground();
     InitMerge();
@@ -19,6 +19,8 @@
 #include "hw/ppu/registers.hpp"
 #include "hw/dma/dma.hpp"
 #include "hw/irq/irq.hpp"
+#include "dirty_page_map.hpp"
+#include "page_hash_tree.hpp"
 
 namespace nba::core {
 
@@ -32,8 +34,20 @@ struct PPU {
 
   void Reset();
 
-  void LoadState(SaveState const& state);
-  void CopyState(SaveState& state);
+  void LoadState(SaveState const& state, bool incremental = false);
+  void CopyState(SaveState& state, bool incremental = false);
+  void CopyRegisterState(SaveState& state);
+  auto GetMemoryHash() -> u64;
+
+  void SetOutputEnable(bool enable) {
+    output_enable = enable;
+  }
+
+  void MarkAllPagesDirty() {
+    dirty_pages.pram.MarkAll();
+    dirty_pages.oam.MarkAll();
+    dirty_pages.vram.MarkAll();
+  }
 
   auto GetPRAM() -> u8* {
     return pram;
@@ -43,6 +57,10 @@ struct PPU {
     return vram;
   }
 
+  auto GetOAM() -> u8* {
+    return oam;
+  }
+
   template<typename T>
   auto ALWAYS_INLINE ReadPRAM(u32 address) noexcept -> T {
     return read<T>(pram, address & 0x3FF);
@@ -55,6 +73,7 @@ struct PPU {
     } else {
       write<T>(pram, address & 0x3FF, value);
     }
+    dirty_pages.pram.Mark(address & 0x3FF);
   }
 
   auto ALWAYS_INLINE GetSpriteVRAMBoundary() noexcept -> u32 {
@@ -100,6 +119,7 @@ struct PPU {
     } else {
       write<T>(vram, address, value);
     }
+    dirty_pages.vram.Mark(address);
   }
 
   template<typename T>
@@ -114,6 +134,7 @@ struct PPU {
       }
 
       write<T>(vram, address, value);
+      dirty_pages.vram.Mark(address);
     }
   }
 
@@ -126,6 +147,7 @@ struct PPU {
   void ALWAYS_INLINE WriteOAM(u32 address, T value) noexcept {
     if constexpr (!std::is_same_v<T, u8>) {
       write<T>(oam, address & 0x3FF, value);
+      dirty_pages.oam.Mark(address & 0x3FF);
     }
   }
 
@@ -443,6 +465,18 @@ private:
   u8 oam [0x00400];
   u8 vram[0x18000];
 
+  struct DirtyPages {
+    DirtyPageMap<0x00400> pram;
+    DirtyPageMap<0x00400> oam;
+    DirtyPageMap<0x18000> vram;
+  } dirty_pages;
+
+  struct PageHashes {
+    PageHashTree<0x00400> pram;
+    PageHashTree<0x00400> oam;
+    PageHashTree<0x18000> vram;
+  } page_hashes;
+
   u16 vram_bg_latch;
 
   Scheduler& scheduler;
@@ -452,6 +486,7 @@ private:
 
   u32 output[2][240 * 160];
   int frame;
+  bool output_enable = true;
 
   bool dma3_video_transfer_running;
 
@@ -11,7 +11,7 @@
 
 namespace nba::core {
 
-void PPU::LoadState(SaveState const& state) {
+void PPU::LoadState(SaveState const& state, bool incremental) {
   auto& ss_ppu = state.ppu;
   auto& mosaic = mmio.mosaic;
 
@@ -24,6 +24,9 @@ void PPU::LoadState(SaveState const& state) {
   mmio.dispcnt.WriteHalf(ss_ppu.io.dispcnt);
   mmio.greenswap = ss_ppu.io.greenswap;
   mmio.dispstat.WriteHalf(ss_ppu.io.dispstat);
+  // The V-blank and H-blank flags are read-only, so they are not restored by WriteHalf().
+  mmio.dispstat.vblank_flag = ss_ppu.io.dispstat & 1;
+  mmio.dispstat.hblank_flag = (ss_ppu.io.dispstat >> 1) & 1;
 
   for(int id = 0; id < 4; id++) {
     mmio.bgcnt[id].WriteHalf(ss_ppu.io.bgcnt[id]);
@@ -61,15 +64,44 @@ void PPU::LoadState(SaveState const& state) {
   mmio.evb = (ss_ppu.io.bldalpha >> 8) & 31;
   mmio.evy = ss_ppu.io.bldy & 31;
 
-  std::memcpy(pram, state.bus.memory.pram, 0x400);
-  std::memcpy(oam,  state.bus.memory.oam,  0x400);
-  std::memcpy(vram, state.bus.memory.vram, 0x18000);
+  if(incremental) {
+    dirty_pages.pram.CopyDirtyPages(pram, state.bus.memory.pram);
+    dirty_pages.oam.CopyDirtyPages(oam, state.bus.memory.oam);
+    dirty_pages.vram.CopyDirtyPages(vram, state.bus.memory.vram);
+  } else {
+    std::memcpy(pram, state.bus.memory.pram, 0x400);
+    std::memcpy(oam,  state.bus.memory.oam,  0x400);
+    std::memcpy(vram, state.bus.memory.vram, 0x18000);
+    dirty_pages.pram.Clear();
+    dirty_pages.oam.Clear();
+    dirty_pages.vram.Clear();
+    dirty_pages.pram.MarkAllForHashing();
+    dirty_pages.oam.MarkAllForHashing();
+    dirty_pages.vram.MarkAllForHashing();
+  }
 
   vram_bg_latch = ss_ppu.vram_bg_latch;
   dma3_video_transfer_running = ss_ppu.dma3_video_transfer_running;
 }
 
-void PPU::CopyState(SaveState& state) {
+void PPU::CopyState(SaveState& state, bool incremental) {
+  CopyRegisterState(state);
+
+  if(incremental) {
+    dirty_pages.pram.CopyDirtyPages(state.bus.memory.pram, pram);
+    dirty_pages.oam.CopyDirtyPages(state.bus.memory.oam, oam);
+    dirty_pages.vram.CopyDirtyPages(state.bus.memory.vram, vram);
+  } else {
+    std::memcpy(state.bus.memory.pram, pram, 0x400);
+    std::memcpy(state.bus.memory.oam,  oam,  0x400);
+    std::memcpy(state.bus.memory.vram, vram, 0x18000);
+    dirty_pages.pram.Clear();
+    dirty_pages.oam.Clear();
+    dirty_pages.vram.Clear();
+  }
+}
+
+void PPU::CopyRegisterState(SaveState& state) {
   auto& ss_ppu = state.ppu;
   auto& mosaic = mmio.mosaic;
 
@@ -113,12 +145,16 @@ void PPU::CopyState(SaveState& state) {
   ss_ppu.io.bldalpha = mmio.eva | (mmio.evb << 8);
   ss_ppu.io.bldy = mmio.evy;
 
-  std::memcpy(state.bus.memory.pram, pram, 0x400);
-  std::memcpy(state.bus.memory.oam,  oam,  0x400);
-  std::memcpy(state.bus.memory.vram, vram, 0x18000);
-
   ss_ppu.vram_bg_latch = vram_bg_latch;
   ss_ppu.dma3_video_transfer_running = dma3_video_transfer_running;
 }
 
+auto PPU::GetMemoryHash() -> u64 {
+  u64 hash = page_hashes.pram.Update(pram, dirty_pages.pram);
+
+  hash = hash_combine(hash, page_hashes.oam.Update(oam, dirty_pages.oam));
+  hash = hash_combine(hash, page_hashes.vram.Update(vram, dirty_pages.vram));
+  return hash;
+}
+
 } // namespace nba::core
\ No newline at end of file
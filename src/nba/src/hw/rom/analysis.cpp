@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <cstring>
+#include <nba/common/punning.hpp>
+#include <nba/rom/analysis.hpp>
+#include <string_view>
+#include <utility>
+
+namespace nba {
+
+using BackupType = Config::BackupType;
+
+static constexpr u32 kSoundMainCRC32 = 0x27EA7FCF;
+static constexpr int kSoundMainLength = 48;
+
+/**
+ * CRC32 of a window of kSoundMainLength bytes that slides over the ROM one byte at a time.
+ * Since the CRC is affine in its input, the byte that leaves the window can be removed
+ * with a table lookup, instead of computing the CRC of every window from scratch.
+ */
+struct RollingCRC32 {
+  RollingCRC32() {
+    for(u32 i = 0; i < 256; i++) {
+      u32 crc = i;
+
+      for(int bit = 0; bit < 8; bit++) {
+        crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+      }
+      table[i] = crc;
+    }
+
+    /* Let R(s, d) be the CRC register after processing d, starting from register s.
+     * Appending byte b_n to the window b_0..b_(n-1) and then removing b_0 is done by:
+     *   R(~0, b_1..b_n) = R(R(~0, b_0..b_(n-1)), b_n) ^ R(0, b_0 0^n) ^ R(~0, 0^n) ^ R(~0, 0^(n+1))
+     */
+    const u32 zeros = Update(~0u, 0, kSoundMainLength + 1) ^ Update(~0u, 0, kSoundMainLength);
+
+    for(int byte = 0; byte < 256; byte++) {
+      remove[byte] = Update(Update(0, (u8)byte, 1), 0, kSoundMainLength) ^ zeros;
+    }
+  }
+
+  auto Update(u32 crc, u8 byte) const -> u32 {
+    return (crc >> 8) ^ table[(crc ^ byte) & 0xFF];
+  }
+
+  auto Update(u32 crc, u8 byte, int count) const -> u32 {
+    for(int i = 0; i < count; i++) {
+      crc = Update(crc, byte);
+    }
+    return crc;
+  }
+
+  auto Roll(u32 crc, u8 byte_in, u8 byte_out) const -> u32 {
+    return Update(crc, byte_in) ^ remove[byte_out];
+  }
+
+  u32 table[256];
+  u32 remove[256];
+};
+
+static auto MatchBackupID(u8 const* data, size_t available) -> BackupType {
+  static constexpr std::pair<std::string_view, BackupType> signatures[6] {
+    { "EEPROM_V",   BackupType::EEPROM_DETECT },
+    { "SRAM_V",     BackupType::SRAM },
+    { "SRAM_F_V",   BackupType::SRAM },
+    { "FLASH_V",    BackupType::FLASH_64 },
+    { "FLASH512_V", BackupType::FLASH_64 },
+    { "FLASH1M_V",  BackupType::FLASH_128 }
+  };
+
+  // Cheap prefilter: all IDs start with either 'E', 'S' or 'F'.
+  switch(data[0]) {
+    case 'E':
+    case 'S':
+    case 'F':
+      break;
+    default:
+      return BackupType::Detect;
+  }
+
+  for(auto const& [signature, type] : signatures) {
+    if(signature.size() <= available && std::memcmp(data, signature.data(), signature.size()) == 0) {
+      return type;
+    }
+  }
+
+  return BackupType::Detect;
+}
+
+static auto GetSoundMainRAM(MemorySpan rom, size_t sound_main) -> u32 {
+  // The pointer to SoundMainRAM() is stored at offset 0x74.
+  if(sound_main + 0x78 > rom.size) {
+    return 0xFFFFFFFF;
+  }
+
+  u32 address = read<u32>(rom.data, (uint)(sound_main + 0x74));
+
+  if(address & 1) {
+    address &= ~1;
+    address += sizeof(u16) * 2;
+  } else {
+    address &= ~3;
+    address += sizeof(u32) * 2;
+  }
+  return address;
+}
+
+auto AnalyzeROM(MemorySpan rom) -> ROMAnalysis {
+  static const RollingCRC32 rolling_crc32;
+
+  ROMAnalysis analysis;
+
+  u8 const* data = rom.data;
+  const size_t size = rom.size;
+
+  bool search_sound_main = size >= kSoundMainLength;
+  bool search_backup_id = true;
+
+  // CRC register of the window starting at the current offset.
+  u32 crc = ~0u;
+
+  if(search_sound_main) {
+    for(int i = 0; i < kSoundMainLength; i++) {
+      crc = rolling_crc32.Update(crc, data[i]);
+    }
+  }
+
+  // SoundMain() is halfword-aligned and the backup IDs are word-aligned.
+  for(size_t offset = 0; offset < size && (search_sound_main || search_backup_id); offset += sizeof(u16)) {
+    if(search_backup_id && (offset & 2) == 0) {
+      const auto backup_type = MatchBackupID(&data[offset], size - offset);
+
+      if(backup_type != BackupType::Detect) {
+        analysis.backup_type = backup_type;
+        search_backup_id = false;
+      }
+    }
+
+    if(search_sound_main) {
+      if(~crc == kSoundMainCRC32) {
+        analysis.sound_main_ram = GetSoundMainRAM(rom, offset);
+        search_sound_main = analysis.sound_main_ram == 0xFFFFFFFF;
+      }
+
+      if(offset + kSoundMainLength + sizeof(u16) <= size) {
+        crc = rolling_crc32.Roll(crc, data[offset + kSoundMainLength + 0], data[offset + 0]);
+        crc = rolling_crc32.Roll(crc, data[offset + kSoundMainLength + 1], data[offset + 1]);
+      } else {
+        search_sound_main = false;
+      }
+    }
+  }
+
+  return analysis;
+}
+
+} // namespace nba
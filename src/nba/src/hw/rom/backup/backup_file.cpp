@@ -0,0 +1,383 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <nba/common/atomic_write.hpp>
+#include <nba/common/crc32.hpp>
+#include <nba/log.hpp>
+#include <nba/rom/backup/backup_file.hpp>
+
+namespace nba {
+
+auto BackupFile::OpenOrCreate(
+  fs::path const& save_path,
+  std::vector<size_t> const& valid_sizes,
+  int& default_size,
+  Config::SaveFile const& options
+) -> std::unique_ptr<BackupFile> {
+  const auto write_mode = options.write_mode;
+
+  bool create = true;
+  auto flags = std::ios::binary | std::ios::in | std::ios::out;
+  std::unique_ptr<BackupFile> file { new BackupFile() };
+
+  file->save_path = save_path;
+  file->write_mode = write_mode;
+  file->flush_interval = std::chrono::milliseconds{std::max(options.flush_interval, 0)};
+
+  // Complete a journaled write that was interrupted, e.g. by a crash.
+  file->ReplayJournal();
+
+  // @todo: check file type and permissions?
+  if(fs::is_regular_file(save_path)) {
+    auto file_size = fs::file_size(save_path);
+
+    // allow for some extra/unused data; required for mGBA save compatibility
+    auto save_size = file_size & ~63u;
+
+    auto begin = valid_sizes.begin();
+    auto end = valid_sizes.end();
+
+    if(std::find(begin, end, save_size) != end) {
+      auto input = std::ifstream{save_path, std::ios::binary};
+      if(input.fail()) {
+        throw std::runtime_error("BackupFile: unable to open file: " + save_path.string());
+      }
+      if(write_mode == WriteMode::WriteThrough) {
+        file->stream.open(save_path.c_str(), flags);
+        if(file->stream.fail()) {
+          throw std::runtime_error("BackupFile: unable to open file: " + save_path.string());
+        }
+      }
+      default_size = save_size;
+      file->save_size = save_size;
+      file->file_size = file_size;
+      file->memory.reset(new u8[file_size]);
+      input.read((char*)file->memory.get(), file_size);
+      create = false;
+    }
+  }
+
+  /* A new save file is created either when no file exists yet,
+   * or when the existing file has an invalid size.
+   * Except in WriteThrough mode, the file is written on the first flush.
+   */
+  if(create) {
+    file->save_size = default_size;
+    file->file_size = default_size;
+    if(write_mode == WriteMode::WriteThrough) {
+      file->stream.open(save_path, flags | std::ios::trunc);
+      if(file->stream.fail()) {
+        throw std::runtime_error("BackupFile: unable to create file: " + save_path.string());
+      }
+    }
+    file->memory.reset(new u8[default_size]);
+    file->MemorySet(0, default_size, 0xFF);
+  }
+
+  return file;
+}
+
+BackupFile::~BackupFile() {
+  Flush();
+  StopWriter();
+}
+
+void BackupFile::Flush() {
+  QueueWrite();
+  WaitForWriter();
+  RetryFailedWrite();
+}
+
+void BackupFile::SetOptions(Config::SaveFile const& options) {
+  const auto write_mode = options.write_mode;
+
+  flush_interval = std::chrono::milliseconds{std::max(options.flush_interval, 0)};
+
+  // In-memory backups are never written to disk.
+  if(!auto_update || write_mode == this->write_mode) {
+    return;
+  }
+
+  if(this->write_mode == WriteMode::WriteThrough) {
+    stream.close();
+  } else {
+    Flush();
+
+    if(write_mode == WriteMode::WriteThrough) {
+      // The file is written through the stream from now on, so the writer's image of it becomes stale.
+      StopWriter();
+
+      if(!fs::exists(save_path)) {
+        ReplaceFile(memory.get());
+      }
+
+      stream.open(save_path, std::ios::binary | std::ios::in | std::ios::out);
+
+      if(stream.fail()) {
+        Log<Warn>("BackupFile: unable to open file: {}", save_path.string());
+      }
+    }
+  }
+
+  this->write_mode = write_mode;
+}
+
+auto BackupFile::GetJournalPath() const -> fs::path {
+  return fs::path{save_path}.concat(".journal");
+}
+
+void BackupFile::UpdateFile(unsigned index, size_t length) {
+  if(!stream.is_open()) {
+    return;
+  }
+  stream.seekg(index);
+  stream.write((char*)&memory[index], length);
+}
+
+void BackupFile::FlushIfDueSlow() {
+  if(write_failed) {
+    RetryFailedWrite();
+  }
+
+  const auto now = std::chrono::steady_clock::now();
+
+  if(dirty_begin >= dirty_end) {
+    return;
+  }
+
+  if((committed && now - commit_time >= kCommitDelay) || now - dirty_since >= flush_interval) {
+    QueueWrite();
+  }
+}
+
+void BackupFile::QueueWrite() {
+  if(dirty_begin >= dirty_end) {
+    return;
+  }
+
+  {
+    std::lock_guard lock{writer_mutex};
+
+    if(!writer_thread.joinable()) {
+      // Outside of the dirty range the backup memory matches the file.
+      file_image.reset(new u8[file_size]);
+      std::memcpy(file_image.get(), memory.get(), file_size);
+
+      writer_thread = std::thread{[this]() { WriterThread(); }};
+    }
+
+    // Merge with the queued write, if the writer thread has not started it yet.
+    if(queued_begin < queued_end) {
+      dirty_begin = std::min(dirty_begin, queued_begin);
+      dirty_end = std::max(dirty_end, queued_end);
+    }
+
+    queued_mode = write_mode;
+    queued_begin = dirty_begin;
+    queued_end = dirty_end;
+    queued_data.assign(memory.get() + dirty_begin, memory.get() + dirty_end);
+  }
+
+  writer_cv_work.notify_one();
+
+  dirty_begin = 0;
+  dirty_end = 0;
+  committed = false;
+}
+
+void BackupFile::RetryFailedWrite() {
+  std::lock_guard lock{writer_mutex};
+
+  if(!write_failed) {
+    return;
+  }
+
+  if(dirty_begin >= dirty_end) {
+    dirty_begin = failed_begin;
+    dirty_end = failed_end;
+  } else {
+    dirty_begin = std::min(dirty_begin, failed_begin);
+    dirty_end = std::max(dirty_end, failed_end);
+  }
+
+  // Try again after the flush interval.
+  dirty_since = std::chrono::steady_clock::now();
+  committed = false;
+
+  failed_begin = 0;
+  failed_end = 0;
+  write_failed = false;
+}
+
+void BackupFile::WaitForWriter() {
+  std::unique_lock lock{writer_mutex};
+
+  writer_cv_idle.wait(lock, [this]() { return queued_begin >= queued_end && !writer_busy; });
+}
+
+void BackupFile::StopWriter() {
+  if(!writer_thread.joinable()) {
+    return;
+  }
+
+  {
+    std::lock_guard lock{writer_mutex};
+    writer_quit = true;
+  }
+
+  writer_cv_work.notify_one();
+  writer_thread.join();
+
+  writer_quit = false;
+  file_image.reset();
+}
+
+void BackupFile::WriterThread() {
+  std::unique_lock lock{writer_mutex};
+
+  while(true) {
+    writer_cv_work.wait(lock, [this]() { return writer_quit || queued_begin < queued_end; });
+
+    // A queued write is still completed on exit.
+    if(queued_begin >= queued_end) {
+      break;
+    }
+
+    const auto write_mode = queued_mode;
+    const auto begin = queued_begin;
+    const auto end = queued_end;
+
+    std::memcpy(&file_image[begin], queued_data.data(), end - begin);
+
+    queued_begin = 0;
+    queued_end = 0;
+    writer_busy = true;
+
+    lock.unlock();
+
+    const bool success = WriteToFile(write_mode, begin, end);
+
+    lock.lock();
+
+    writer_busy = false;
+
+    // The emulator thread marks the range dirty again (see RetryFailedWrite()).
+    if(!success) {
+      if(failed_begin >= failed_end) {
+        failed_begin = begin;
+        failed_end = end;
+      } else {
+        failed_begin = std::min(failed_begin, begin);
+        failed_end = std::max(failed_end, end);
+      }
+      write_failed = true;
+    }
+
+    if(queued_begin >= queued_end) {
+      writer_cv_idle.notify_all();
+    }
+  }
+}
+
+auto BackupFile::WriteToFile(WriteMode write_mode, size_t begin, size_t end) -> bool {
+  std::error_code error;
+
+  // A journaled write can only update a file that already has the right size.
+  if(write_mode == WriteMode::Journaled && fs::file_size(save_path, error) == file_size && !error) {
+    return WriteJournaled(begin, end);
+  }
+
+  return ReplaceFile(file_image.get());
+}
+
+auto BackupFile::ReplaceFile(u8 const* data) -> bool {
+  if(WriteFileAtomic(save_path, data, file_size) != WriteFileResult::Success) {
+    Log<Warn>("BackupFile: failed to replace the save file: {}", save_path.string());
+    return false;
+  }
+
+  return true;
+}
+
+auto BackupFile::WriteJournaled(size_t begin, size_t end) -> bool {
+  const auto journal_path = GetJournalPath();
+  const auto data = &file_image[begin];
+  const auto length = end - begin;
+
+  const u32 header[4] { kJournalMagic, (u32)begin, (u32)length, crc32(data, length) };
+
+  auto journal = std::vector<u8>(sizeof(header) + length);
+
+  std::memcpy(journal.data(), header, sizeof(header));
+  std::memcpy(journal.data() + sizeof(header), data, length);
+
+  // The journal is on disk before the save file is touched. If writing the save file is
+  // interrupted, the journal is replayed the next time the save file is opened.
+  if(WriteFileAtomic(journal_path, journal.data(), journal.size()) != WriteFileResult::Success) {
+    Log<Warn>("BackupFile: failed to write the journal: {}", journal_path.string());
+    return false;
+  }
+
+  if(WriteFileInPlace(save_path, begin, data, length) != WriteFileResult::Success) {
+    Log<Warn>("BackupFile: failed to write the save file: {}", save_path.string());
+    return false;
+  }
+
+  std::error_code error;
+
+  // Replaying a journal that outlives a crash at this point only writes the same data again.
+  fs::remove(journal_path, error);
+  return true;
+}
+
+void BackupFile::ReplayJournal() {
+  const auto journal_path = GetJournalPath();
+
+  std::error_code error;
+
+  if(!fs::exists(journal_path, error)) {
+    return;
+  }
+
+  auto data = std::vector<u8>{};
+  u32 header[4];
+
+  {
+    auto journal = std::ifstream{journal_path, std::ios::binary};
+
+    journal.read((char*)header, sizeof(header));
+
+    const auto save_size = fs::file_size(save_path, error);
+
+    // An incomplete journal means that the save file has not been touched yet.
+    if(!journal.good() || header[0] != kJournalMagic || error || (u64)header[1] + header[2] > save_size) {
+      journal.close();
+      fs::remove(journal_path, error);
+      return;
+    }
+
+    data.resize(header[2]);
+    journal.read((char*)data.data(), data.size());
+
+    if(!journal.good() || crc32(data.data(), data.size()) != header[3]) {
+      journal.close();
+      fs::remove(journal_path, error);
+      return;
+    }
+  }
+
+  if(WriteFileInPlace(save_path, header[1], data.data(), data.size()) != WriteFileResult::Success) {
+    // Keep the journal, so that it can be replayed later.
+    Log<Warn>("BackupFile: failed to replay the journal: {}", journal_path.string());
+    return;
+  }
+
+  Log<Info>("BackupFile: completed an interrupted write to {}", save_path.string());
+  fs::remove(journal_path, error);
+}
+
+} // namespace nba
@@ -8,6 +8,7 @@
 #include <cstring>
 #include <exception>
 #include <nba/rom/backup/eeprom.hpp>
+#include <nba/core.hpp>
 
 #include <nba/log.hpp>
 
@@ -27,6 +28,18 @@ EEPROM::EEPROM(fs::path const& save_path, Size size_hint, core::Scheduler& sched
   Reset();
 }
 
+EEPROM::EEPROM(EEPROM const& other, core::Scheduler& scheduler)
+    : size(other.size)
+    , file(other.file->Clone())
+    , scheduler(scheduler)
+    , state(other.state)
+    , address(other.address)
+    , serial_buffer(other.serial_buffer)
+    , transmitted_bits(other.transmitted_bits)
+    , detect_size(other.detect_size) {
+  scheduler.Register(Scheduler::EventClass::EEPROM_ready, this, &EEPROM::OnReadyAfterWrite);
+}
+
 void EEPROM::Reset() {
   state = STATE_ACCEPT_COMMAND;
   address = 0;
@@ -40,8 +53,13 @@ void EEPROM::Reset() {
   }
 
   int bytes = g_save_size[size];
+
+  // Unsaved changes must be written before the file is read again.
+  if(file) {
+    file->Flush();
+  }
   
-  file = BackupFile::OpenOrCreate(save_path, {512, 8192}, bytes);
+  file = BackupFile::OpenOrCreate(save_path, {512, 8192}, bytes, save_file_options);
 
   if(bytes == g_save_size[0]) {
     size = SIZE_4K;
@@ -149,6 +167,23 @@ void EEPROM::Write(u32 address, u8 value) {
   }
 }
 
+auto EEPROM::Clone(CoreBase& core) const -> std::unique_ptr<Backup> {
+  return std::unique_ptr<EEPROM>{new EEPROM{*this, core.GetScheduler()}};
+}
+
+auto EEPROM::GetMemory() -> MemorySpan {
+  return {file->Buffer(), file->Size()};
+}
+
+void EEPROM::SetSaveFileOptions(Config::SaveFile const& options) {
+  save_file_options = options;
+  file->SetOptions(options);
+}
+
+void EEPROM::FlushIfDue() {
+  file->FlushIfDue();
+}
+
 void EEPROM::SetSizeHint(Size size) {
   if(detect_size) {
     int bytes = g_save_size[size];
@@ -157,13 +192,20 @@ void EEPROM::SetSizeHint(Size size) {
     detect_size = false;
 
     if(file->Size() != bytes) {
-      file = BackupFile::OpenOrCreate(save_path, {(size_t)bytes}, bytes);
+      if(save_path.empty()) {
+        // cloned EEPROMs are never written to disk.
+        file = BackupFile::CreateInMemory(bytes);
+      } else {
+        file->Flush();
+        file = BackupFile::OpenOrCreate(save_path, {(size_t)bytes}, bytes, save_file_options);
+      }
     }
   }
 }
 
 void EEPROM::OnReadyAfterWrite() {
   state = STATE_ACCEPT_COMMAND;
+  file->Commit();
 }
 
 } // namespace nba
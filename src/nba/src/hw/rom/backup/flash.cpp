@@ -16,6 +16,17 @@ FLASH::FLASH(fs::path const& save_path, Size size_hint)
     , save_path(save_path) {
   Reset();
 }
+
+FLASH::FLASH(FLASH const& other)
+    : size(other.size)
+    , file(other.file->Clone())
+    , current_bank(other.current_bank)
+    , phase(other.phase)
+    , enable_chip_id(other.enable_chip_id)
+    , enable_erase(other.enable_erase)
+    , enable_write(other.enable_write)
+    , enable_select(other.enable_select) {
+}
   
 void FLASH::Reset() {
   current_bank = 0;
@@ -26,8 +37,13 @@ void FLASH::Reset() {
   enable_select = false;
   
   int bytes = g_save_size[size];
+
+  // Unsaved changes must be written before the file is read again.
+  if(file) {
+    file->Flush();
+  }
   
-  file = BackupFile::OpenOrCreate(save_path, { 65536, 131072 }, bytes);
+  file = BackupFile::OpenOrCreate(save_path, { 65536, 131072 }, bytes, save_file_options);
   if(bytes == g_save_size[0]) {
     size = SIZE_64K;
   } else {
@@ -78,6 +94,23 @@ void FLASH::Write(u32 address, u8 value) {
   }
 }
 
+auto FLASH::Clone(CoreBase&) const -> std::unique_ptr<Backup> {
+  return std::unique_ptr<FLASH>{new FLASH{*this}};
+}
+
+auto FLASH::GetMemory() -> MemorySpan {
+  return {file->Buffer(), file->Size()};
+}
+
+void FLASH::SetSaveFileOptions(Config::SaveFile const& options) {
+  save_file_options = options;
+  file->SetOptions(options);
+}
+
+void FLASH::FlushIfDue() {
+  file->FlushIfDue();
+}
+
 void FLASH::HandleCommand(u32 address, u8 value) {
   if(address == 0x0E005555) {
     switch(static_cast<Command>(value)) {
@@ -99,6 +132,7 @@ void FLASH::HandleCommand(u32 address, u8 value) {
       case ERASE_CHIP: {
         if(enable_erase) {
           file->MemorySet(0, g_save_size[size], 0xFF);
+          file->Commit();
           enable_erase = false;
         }
         phase = 0;
@@ -123,6 +157,7 @@ void FLASH::HandleCommand(u32 address, u8 value) {
     u32 base = address & 0xF000;
     
     file->MemorySet(Physical(base), 0x1000, 0xFF);
+    file->Commit();
     enable_erase = false;
     phase = 0;
   }
@@ -131,6 +166,7 @@ void FLASH::HandleCommand(u32 address, u8 value) {
 void FLASH::HandleExtended(u32 address, u8 value) {
   if(enable_write) {
     file->Write(Physical(address & 0xFFFF), value);
+    file->Commit();
     enable_write = false;
   } else if(enable_select && address == 0x0E000000) {
     current_bank = value & 1;
@@ -14,9 +14,19 @@ SRAM::SRAM(fs::path const& save_path)
   Reset();
 }
 
+SRAM::SRAM(SRAM const& other)
+    : file(other.file->Clone()) {
+}
+
 void SRAM::Reset() {
   int bytes = 32768;
-  file = BackupFile::OpenOrCreate(save_path, { 32768 }, bytes);
+
+  // Unsaved changes must be written before the file is read again.
+  if(file) {
+    file->Flush();
+  }
+
+  file = BackupFile::OpenOrCreate(save_path, { 32768 }, bytes, save_file_options);
 }
 
 auto SRAM::Read(u32 address) -> u8 {
@@ -27,4 +37,21 @@ void SRAM::Write(u32 address, u8 value) {
   file->Write(address & 0x7FFF, value);
 }
 
+auto SRAM::Clone(CoreBase&) const -> std::unique_ptr<Backup> {
+  return std::unique_ptr<SRAM>{new SRAM{*this}};
+}
+
+auto SRAM::GetMemory() -> MemorySpan {
+  return {file->Buffer(), file->Size()};
+}
+
+void SRAM::SetSaveFileOptions(Config::SaveFile const& options) {
+  save_file_options = options;
+  file->SetOptions(options);
+}
+
+void SRAM::FlushIfDue() {
+  file->FlushIfDue();
+}
+
 } // namespace nba
@@ -83,4 +83,19 @@ void GPIO::Write(u32 address, u8 value) {
   }
 }
 
+auto GPIO::Clone(CoreBase& core) const -> std::unique_ptr<GPIO> {
+  auto gpio = std::make_unique<GPIO>();
+
+  gpio->allow_reads = allow_reads;
+  gpio->rd_mask = rd_mask;
+  gpio->wr_mask = wr_mask;
+  gpio->port_data = port_data;
+
+  for(auto& device : devices) {
+    gpio->Attach(device->Clone(core));
+  }
+
+  return gpio;
+}
+
 } // namespace nba
@@ -6,7 +6,9 @@
  */
 
 #include <nba/rom/gpio/rtc.hpp>
+#include <nba/core.hpp>
 #include <nba/log.hpp>
+#include <algorithm>
 #include <ctime>
 
 #include "hw/irq/irq.hpp"
@@ -15,7 +17,10 @@ namespace nba {
 
 constexpr int RTC::s_argument_count[8];
 
-RTC::RTC(core::IRQ& irq) : irq(irq) {
+RTC::RTC(core::IRQ& irq, core::Scheduler& scheduler, std::shared_ptr<Config> config)
+    : irq(irq)
+    , scheduler(scheduler)
+    , config(config) {
   Reset();
 }
 
@@ -37,6 +42,54 @@ void RTC::Reset() {
   control.mode_24h = true;
 }
 
+auto RTC::Clone(CoreBase& core) const -> std::unique_ptr<GPIODevice> {
+  // The clone must raise IRQs on the other core, so let the core create it.
+  auto rtc = core.CreateRTC();
+
+  static_cast<GPIODevice&>(*rtc) = *this;
+  rtc->current_bit = current_bit;
+  rtc->current_byte = current_byte;
+  rtc->reg = reg;
+  rtc->data = data;
+  std::copy(std::begin(buffer), std::end(buffer), rtc->buffer);
+  rtc->port = port;
+  rtc->state = state;
+  rtc->control = control;
+  return rtc;
+}
+
+// std::gmtime() and std::localtime() return a pointer to shared storage, which is not safe when running multiple cores in parallel.
+static auto ConvertTime(std::time_t timestamp, bool local) -> std::tm {
+  std::tm time;
+
+#ifdef _WIN32
+  if(local) {
+    localtime_s(&time, &timestamp);
+  } else {
+    gmtime_s(&time, &timestamp);
+  }
+#else
+  if(local) {
+    localtime_r(&timestamp, &time);
+  } else {
+    gmtime_r(&timestamp, &time);
+  }
+#endif
+
+  return time;
+}
+
+auto RTC::GetTime() const -> std::tm {
+  if(config->rtc_seed != 0) {
+    // The scheduler counts cycles since power-on, the system clock runs at 16.78 MHz.
+    const std::time_t timestamp = config->rtc_seed + (std::time_t)(scheduler.GetTimestampNow() >> 24);
+
+    return ConvertTime(timestamp, false);
+  }
+
+  return ConvertTime(std::time(nullptr), true);
+}
+
 auto RTC::Read() -> int {
   return (port.sio & port.cs) << static_cast<int>(Port::SIO);
 }
@@ -183,25 +236,23 @@ void RTC::ReadRegister() {
       break;
     }
     case Register::DateTime: {
-      auto timestamp = std::time(nullptr);
-      auto time = std::localtime(&timestamp);
-      AdjustHour(time->tm_hour);
-      buffer[0] = ConvertDecimalToBCD(time->tm_year - 100);
-      buffer[1] = ConvertDecimalToBCD(1 + time->tm_mon);
-      buffer[2] = ConvertDecimalToBCD(time->tm_mday);
-      buffer[3] = ConvertDecimalToBCD(time->tm_wday);
-      buffer[4] = ConvertDecimalToBCD(time->tm_hour);
-      buffer[5] = ConvertDecimalToBCD(time->tm_min);
-      buffer[6] = ConvertDecimalToBCD(time->tm_sec);
+      auto time = GetTime();
+      AdjustHour(time.tm_hour);
+      buffer[0] = ConvertDecimalToBCD(time.tm_year - 100);
+      buffer[1] = ConvertDecimalToBCD(1 + time.tm_mon);
+      buffer[2] = ConvertDecimalToBCD(time.tm_mday);
+      buffer[3] = ConvertDecimalToBCD(time.tm_wday);
+      buffer[4] = ConvertDecimalToBCD(time.tm_hour);
+      buffer[5] = ConvertDecimalToBCD(time.tm_min);
+      buffer[6] = ConvertDecimalToBCD(time.tm_sec);
       break;
     }
     case Register::Time: {
-      auto timestamp = std::time(nullptr);
-      auto time = std::localtime(&timestamp);
-      AdjustHour(time->tm_hour);
-      buffer[0] = ConvertDecimalToBCD(time->tm_hour);
-      buffer[1] = ConvertDecimalToBCD(time->tm_min);
-      buffer[2] = ConvertDecimalToBCD(time->tm_sec);
+      auto time = GetTime();
+      AdjustHour(time.tm_hour);
+      buffer[0] = ConvertDecimalToBCD(time.tm_hour);
+      buffer[1] = ConvertDecimalToBCD(time.tm_min);
+      buffer[2] = ConvertDecimalToBCD(time.tm_sec);
       break;
     }
   }
@@ -37,6 +37,10 @@ void SolarSensor::Write(int value) {
   old_clk = clk;
 }
 
+auto SolarSensor::Clone(CoreBase&) const -> std::unique_ptr<GPIODevice> {
+  return std::make_unique<SolarSensor>(*this);
+}
+
 void SolarSensor::SetLightLevel(u8 level) {
   current_level = 255 - level;
 }
@@ -0,0 +1,38 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <nba/rom/rom.hpp>
+
+namespace nba {
+
+auto ROM::Clone(CoreBase& core) const -> ROM {
+  ROM clone{};
+
+  clone.rom = rom;
+  clone.rom_data = rom_data;
+  clone.rom_size = rom_size;
+
+  if(backup_sram) {
+    clone.backup_sram = backup_sram->Clone(core);
+  }
+
+  if(backup_eeprom) {
+    clone.backup_eeprom = backup_eeprom->Clone(core);
+  }
+
+  if(gpio) {
+    clone.gpio = gpio->Clone(core);
+  }
+
+  clone.rom_address_latch = rom_address_latch;
+  clone.rom_mask = rom_mask;
+  clone.eeprom_mask = eeprom_mask;
+  clone.analysis = analysis;
+  return clone;
+}
+
+} // namespace nba
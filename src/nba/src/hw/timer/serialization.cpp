@@ -29,7 +29,8 @@ void Timer::LoadState(SaveState const& state) {
     channels[i].shift = g_ticks_shift[channels[i].control.frequency];
     channels[i].mask = g_ticks_mask[channels[i].control.frequency];
 
-    channels[i].running = false;
+    channels[i].running = channels[i].control.enable && !channels[i].control.cascade;
+    channels[i].timestamp_started = scheduler.GetTimestampNow() - state.timer[i].prescaler_phase;
     channels[i].event_overflow = scheduler.GetEventByUID(state.timer[i].event_uid);
 
     channels[i].pending.reload = state.timer[i].pending.reload;
@@ -39,6 +40,17 @@ void Timer::LoadState(SaveState const& state) {
 
 void Timer::CopyState(SaveState& state) {
   for(int i = 0; i < 4; i++) {
+    auto const& channel = channels[i];
+
+    if(channel.running) {
+      // Cycles since the last prescaler tick, so that the counter is restored with sub-tick accuracy.
+      const s64 cycles = (s64)(scheduler.GetTimestampNow() - channel.timestamp_started);
+
+      state.timer[i].prescaler_phase = (s32)(cycles - ((s64)GetCounterDeltaSinceLastUpdate(channel) << channel.shift));
+    } else {
+      state.timer[i].prescaler_phase = 0;
+    }
+
     state.timer[i].counter = ReadCounter(channels[i]);
     state.timer[i].reload = channels[i].reload;
     state.timer[i].control = ReadControl(channels[i]);
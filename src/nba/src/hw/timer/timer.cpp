@@ -14,10 +14,15 @@ namespace nba::core {
 static constexpr int g_ticks_shift[4] = { 0, 6, 8, 10 };
 static constexpr int g_ticks_mask[4] = { 0, 0x3F, 0xFF, 0x3FF };
 
-Timer::Timer(Scheduler& scheduler, IRQ& irq, APU& apu)
-    : scheduler(scheduler)
+Timer::Timer(
+  Scheduler& scheduler,
+  IRQ& irq,
+  APU& apu,
+  std::shared_ptr<Config> config
+)   : scheduler(scheduler)
     , irq(irq)
-    , apu(apu) {
+    , apu(apu)
+    , config(config) {
   scheduler.Register(Scheduler::EventClass::TM_overflow, this, &Timer::OnOverflow);
   scheduler.Register(Scheduler::EventClass::TM_write_reload, this, &Timer::OnReloadWritten);
   scheduler.Register(Scheduler::EventClass::TM_write_control, this, &Timer::OnControlWritten);
@@ -33,6 +38,18 @@ void Timer::Reset() {
   }
 }
 
+void Timer::Sync() {
+  for(auto& channel : channels) {
+    SyncChannel(channel);
+  }
+}
+
+void Timer::Reschedule() {
+  for(auto& channel : channels) {
+    ScheduleOverflow(channel);
+  }
+}
+
 auto Timer::ReadByte(int chan_id, int offset) -> u8 {
   auto const& channel = channels[chan_id];
 
@@ -114,15 +131,20 @@ void Timer::WriteWord(int chan_id, u32 value) {
 }
 
 auto Timer::ReadCounter(Channel const& channel) -> u16 {
-  auto counter = channel.counter;
+  u64 counter = channel.counter;
 
   // While the timer is still running we must account for time that has passed
   // since the last counter update (overflow or configuration change).
   if(channel.running) {
     counter += GetCounterDeltaSinceLastUpdate(channel);
+
+    // Account for overflows which have not been processed yet (see Sync()).
+    if(counter >= 0x10000) {
+      counter = channel.reload + (counter - 0x10000) % (0x10000 - channel.reload);
+    }
   }
 
-  return counter;
+  return (u16)counter;
 }
 
 void Timer::WriteReload(Channel& channel, u16 value) {
@@ -147,7 +169,13 @@ void Timer::WriteControl(Channel& channel, u16 value) {
 }
 
 void Timer::OnReloadWritten(u64 chan_id) {
-  channels[chan_id].reload = channels[chan_id].pending.reload;
+  auto& channel = channels[chan_id];
+
+  // The reload value determines the time between overflows, so process
+  // the overflows that happened with the old reload value first.
+  SyncChannel(channel);
+  channel.reload = channel.pending.reload;
+  ScheduleOverflow(channel);
 }
 
 void Timer::OnControlWritten(u64 chan_id) {
@@ -156,6 +184,9 @@ void Timer::OnControlWritten(u64 chan_id) {
   bool enable_previous = control.enable;
   u16 value = channel.pending.control;
 
+  // The IRQ and cascade settings decide whether overflows of this and the previous channel can be coalesced.
+  Sync();
+
   if(channel.running) {
     StopChannel(channel);
   }
@@ -196,31 +227,122 @@ void Timer::OnControlWritten(u64 chan_id) {
       }
     }
   }
+
+  Reschedule();
+}
+
+auto Timer::GetCounterDeltaSinceLastUpdate(Channel const& channel) -> u64 {
+  const u64 timestamp_now = scheduler.GetTimestampNow();
+
+  // The channel may be started with a one cycle delay (see OnControlWritten()).
+  if(timestamp_now < channel.timestamp_started) {
+    return 0;
+  }
+
+  return (timestamp_now - channel.timestamp_started) >> channel.shift;
 }
 
-auto Timer::GetCounterDeltaSinceLastUpdate(Channel const& channel) -> u32 {
-  return (scheduler.GetTimestampNow() - channel.timestamp_started) >> channel.shift;
+auto Timer::GetOverflowBudget(Channel const& channel) -> int {
+  // Each overflow is observable if it raises an IRQ or clocks a cascading timer.
+  if(!config->timer_coalescing || channel.control.interrupt) {
+    return 1;
+  }
+
+  if(channel.id != 3) {
+    auto const& next_control = channels[channel.id + 1].control;
+
+    if(next_control.enable && next_control.cascade) {
+      return 1;
+    }
+  }
+
+  // Timers 0 and 1 may drive the FIFOs, which only need attention once they request new data.
+  if(channel.id <= 1) {
+    return apu.GetFIFOOverflowBudget(channel.id);
+  }
+
+  return 0;
 }
 
 void Timer::StartChannel(Channel& channel, int cycle_offset) {
-  int cycles = int((0x10000 - channel.counter) << channel.shift) - cycle_offset;
-
   channel.running = true;
   channel.timestamp_started = scheduler.GetTimestampNow() - cycle_offset;
-  channel.event_overflow = scheduler.Add(cycles, Scheduler::EventClass::TM_overflow, 0, channel.id);
+
+  ScheduleOverflow(channel);
 }
 
 void Timer::StopChannel(Channel& channel) {
+  SyncChannel(channel);
   channel.counter += GetCounterDeltaSinceLastUpdate(channel);
-  if(channel.counter >= 0x10000) {
-    ReloadCascadeAndRequestIRQ(channel);
+
+  if(channel.event_overflow) {
+    scheduler.Cancel(channel.event_overflow);
+    channel.event_overflow = nullptr;
   }
 
-  scheduler.Cancel(channel.event_overflow);
-  channel.event_overflow = nullptr;
   channel.running = false;
 }
 
+void Timer::SyncChannel(Channel& channel) {
+  if(!channel.running) {
+    return;
+  }
+
+  const u64 timestamp_now = scheduler.GetTimestampNow();
+  const u64 cycles_to_overflow = u64(0x10000 - channel.counter) << channel.shift;
+
+  if(timestamp_now < channel.timestamp_started + cycles_to_overflow) {
+    return;
+  }
+
+  const u64 cycles_per_overflow = u64(0x10000 - channel.reload) << channel.shift;
+  const u64 overflows = 1 + (timestamp_now - channel.timestamp_started - cycles_to_overflow) / cycles_per_overflow;
+
+  channel.timestamp_started += cycles_to_overflow + (overflows - 1) * cycles_per_overflow;
+
+  if(overflows == 1 || GetOverflowBudget(channel) == 1) {
+    for(u64 i = 0; i < overflows; i++) {
+      ReloadCascadeAndRequestIRQ(channel);
+    }
+  } else {
+    // Nothing but the FIFOs observes the overflows, so they can be processed in one go.
+    channel.counter = channel.reload;
+
+    if(channel.id <= 1) {
+      apu.OnTimerOverflow(channel.id, (int)overflows);
+    }
+  }
+}
+
+void Timer::ScheduleOverflow(Channel& channel) {
+  const int budget = channel.running ? GetOverflowBudget(channel) : 0;
+
+  u64 timestamp_overflow = 0;
+
+  if(budget > 0) {
+    // Schedule the event for the first overflow that must be observed.
+    const u64 cycles_to_overflow = u64(0x10000 - channel.counter) << channel.shift;
+    const u64 cycles_per_overflow = u64(0x10000 - channel.reload) << channel.shift;
+
+    timestamp_overflow = channel.timestamp_started + cycles_to_overflow + (budget - 1) * cycles_per_overflow;
+  }
+
+  if(channel.event_overflow) {
+    if(budget > 0 && channel.event_overflow->timestamp == timestamp_overflow) {
+      return;
+    }
+
+    scheduler.Cancel(channel.event_overflow);
+    channel.event_overflow = nullptr;
+  }
+
+  if(budget > 0) {
+    const u64 delay = timestamp_overflow - scheduler.GetTimestampNow();
+
+    channel.event_overflow = scheduler.Add(delay, Scheduler::EventClass::TM_overflow, 0, channel.id);
+  }
+}
+
 void Timer::ReloadCascadeAndRequestIRQ(Channel& channel) {
   channel.counter = channel.reload;
 
@@ -243,8 +365,11 @@ void Timer::ReloadCascadeAndRequestIRQ(Channel& channel) {
 void Timer::OnOverflow(u64 chan_id) {
   auto& channel = channels[chan_id];
 
-  ReloadCascadeAndRequestIRQ(channel);
-  StartChannel(channel, 0);
+  // This event is about to be removed from the queue, it must not be cancelled.
+  channel.event_overflow = nullptr;
+
+  SyncChannel(channel);
+  ScheduleOverflow(channel);
 }
 
 } // namespace nba::core
@@ -8,6 +8,8 @@
 #pragma once
 
 #include <algorithm>
+#include <memory>
+#include <nba/config.hpp>
 #include <nba/integer.hpp>
 #include <nba/save_state.hpp>
 #include <nba/scheduler.hpp>
@@ -18,9 +20,26 @@
 namespace nba::core {
 
 struct Timer {
-  Timer(Scheduler& scheduler, IRQ& irq, APU& apu);
+  Timer(
+    Scheduler& scheduler,
+    IRQ& irq,
+    APU& apu,
+    std::shared_ptr<Config> config
+  );
 
   void Reset();
+
+  /**
+   * Timer overflows that are not observed by anything (IRQ, cascade or FIFO DMA)
+   * are not processed individually but lazily, whenever the timer state is accessed.
+   * Sync() brings all channels up-to-date and must be called before
+   * state that depends on the overflows (the FIFOs) is accessed.
+   * Reschedule() must be called after such state was modified,
+   * because it might change when the next overflow must be observed.
+   */
+  void Sync();
+  void Reschedule();
+
   auto ReadByte(int chan_id, int offset) -> u8;
   auto ReadHalf(int chan_id, int offset) -> u16;
   auto ReadWord(int chan_id) -> u32;
@@ -65,6 +84,7 @@ private:
   Scheduler& scheduler;
   IRQ& irq;
   APU& apu;
+  std::shared_ptr<Config> config;
 
   auto ReadCounter(Channel const& channel) -> u16;
   void WriteReload(Channel& channel, u16 value);
@@ -75,9 +95,12 @@ private:
   void OnReloadWritten(u64 chan_id);
   void OnControlWritten(u64 chan_id);
 
-  auto GetCounterDeltaSinceLastUpdate(Channel const& channel) -> u32;
+  auto GetCounterDeltaSinceLastUpdate(Channel const& channel) -> u64;
+  auto GetOverflowBudget(Channel const& channel) -> int;
   void StartChannel(Channel& channel, int cycle_offset);
   void StopChannel(Channel& channel);
+  void SyncChannel(Channel& channel);
+  void ScheduleOverflow(Channel& channel);
   void ReloadCascadeAndRequestIRQ(Channel& channel);
   void OnOverflow(u64 chan_id);
 };
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <nba/common/hash.hpp>
+#include <nba/integer.hpp>
+
+#include "dirty_page_map.hpp"
+
+namespace nba::core {
+
+/**
+ * A hash tree (Merkle tree) over the pages of a memory. The leaves hold the hashes of the pages,
+ * every inner node holds the combined hash of its two children.
+ * Only the pages that changed since the last update are rehashed, together with their
+ * ancestors, so updating the root hash costs O(dirty pages * log(pages)).
+ */
+template<size_t size, int page_shift = 8>
+struct PageHashTree {
+  using PageMap = DirtyPageMap<size, page_shift>;
+
+  auto Update(u8 const* memory, PageMap& dirty_pages) -> u64 {
+    dirty_pages.ConsumePagesForHashing([&](size_t page) {
+      const size_t offset = page << page_shift;
+
+      size_t node = kLeafCount + page;
+
+      nodes[node] = hash64(memory + offset, std::min(PageMap::kPageSize, size - offset), page);
+
+      while(node > 1) {
+        node >>= 1;
+        nodes[node] = hash_combine(nodes[node * 2], nodes[node * 2 + 1]);
+      }
+    });
+
+    return nodes[1];
+  }
+
+private:
+  static constexpr auto GetLeafCount() -> size_t {
+    size_t count = 1;
+
+    while(count < PageMap::kPageCount) {
+      count *= 2;
+    }
+    return count;
+  }
+
+  static constexpr size_t kLeafCount = GetLeafCount();
+
+  // Node 1 is the root, the children of node n are 2n and 2n + 1. Leaves without a page remain zero.
+  std::array<u64, kLeafCount * 2> nodes{};
+};
+
+} // namespace nba::core
@@ -5,39 +5,148 @@
  * Refer to the included LICENSE file.
  */
 
+#include <nba/common/hash.hpp>
+
 #include "core.hpp"
 
 namespace nba::core {
 
 void Core::LoadState(SaveState const& state) {
+  LoadState(state, false);
+}
+
+void Core::CopyState(SaveState& state) {
+  CopyState(state, false);
+}
+
+void Core::LoadStateIncremental(SaveState const& state) {
+  LoadState(state, true);
+}
+
+void Core::CopyStateIncremental(SaveState& state) {
+  CopyState(state, true);
+}
+
+static_assert(MP2K::GetStateSize() <= SnapshotData::kMixerStateSize, "MP2K mixer state must fit into snapshots");
+
+void Core::LoadMixerState(u8 const* data) {
+  apu.GetMP2K().LoadState(data);
+}
+
+void Core::CopyMixerState(u8* data) {
+  apu.GetMP2K().CopyState(data);
+}
+
+void Core::LoadState(SaveState const& state, bool incremental) {
   scheduler.Reset();
   scheduler.SetTimestampNow(state.timestamp);
 
   scheduler.LoadState(state);
   cpu.LoadState(state);
-  bus.LoadState(state);
+  bus.LoadState(state, incremental);
   irq.LoadState(state);
-  ppu.LoadState(state);
+  ppu.LoadState(state, incremental);
   apu.LoadState(state);
   timer.LoadState(state);
   dma.LoadState(state);
   keypad.LoadState(state);
 }
 
-void Core::CopyState(SaveState& state) {
+void Core::CopyState(SaveState& state, bool incremental) {
+  // Process coalesced timer overflows first, the FIFO and DMA state depends on them.
+  timer.Sync();
+
   state.magic = SaveState::kMagicNumber;
   state.version = SaveState::kCurrentVersion;
   state.timestamp = scheduler.GetTimestampNow();
 
   scheduler.CopyState(state);
   cpu.CopyState(state);
-  bus.CopyState(state);
+  bus.CopyState(state, incremental);
+  irq.CopyState(state);
+  ppu.CopyState(state, incremental);
+  apu.CopyState(state);
+  timer.CopyState(state);
+  dma.CopyState(state);
+  keypad.CopyState(state);
+}
+
+auto Core::StateHash() -> u64 {
+  if(!hash_state) {
+    // Value-initialized, so that padding and fields that are never written are zero.
+    hash_state = MakeSaveState();
+  }
+
+  auto& state = *hash_state;
+
+  timer.Sync();
+
+  scheduler.CopyState(state);
+  cpu.CopyState(state);
+  bus.CopyRegisterState(state);
   irq.CopyState(state);
-  ppu.CopyState(state);
+  ppu.CopyRegisterState(state);
   apu.CopyState(state);
   timer.CopyState(state);
   dma.CopyState(state);
   keypad.CopyState(state);
+  GetROM().CopyState(state);
+
+  const auto hash_range = [](u64 hash, void const* begin, void const* end) {
+    return hash_combine(hash, hash64(begin, (u8 const*)end - (u8 const*)begin));
+  };
+
+  // Event UIDs depend on how many events were scheduled in the past, so two equal states may differ in them.
+  // Events are hashed by what they do and when instead, and UID references are replaced by the hash of the event.
+  const auto hash_event = [](SaveState::Scheduler::Event const& event) {
+    u64 event_hash = hash_combine(event.key, event.user_data);
+
+    return hash_combine(event_hash, event.event_class);
+  };
+
+  const auto get_event_hash = [&](u64 uid) -> u64 {
+    for(int i = 0; i < state.scheduler.event_count; i++) {
+      if(state.scheduler.events[i].uid == uid) {
+        return hash_event(state.scheduler.events[i]);
+      }
+    }
+    return 0;
+  };
+
+  for(auto& channel : state.timer) {
+    channel.event_uid = get_event_hash(channel.event_uid);
+  }
+
+  for(auto& channel : state.dma.channels) {
+    channel.event_uid = get_event_hash(channel.event_uid);
+  }
+
+  u64 hash = hash64(&state.arm, sizeof(state.arm), scheduler.GetTimestampNow());
+
+  hash = hash_range(hash, &state.bus.memory.latch, &state.bus + 1);
+  hash = hash_range(hash, &state.irq, &state.irq + 1);
+  hash = hash_range(hash, &state.ppu, &state.ppu + 1);
+  hash = hash_range(hash, &state.apu, &state.apu + 1);
+  hash = hash_range(hash, &state.timer, &state.timer + 1);
+  hash = hash_range(hash, &state.dma, &state.dma + 1);
+
+  // Includes the backup memory, which the game may read back later.
+  hash = hash_range(hash, &state.rom_address_latch, &state.gpio + 1);
+  hash = hash_combine(hash, state.keycnt);
+
+  // The order of the events in the heap depends on the order in which they were scheduled,
+  // so their hashes are summed up to make the result independent of that order.
+  u64 events_hash = 0;
+
+  for(int i = 0; i < state.scheduler.event_count; i++) {
+    events_hash += hash_event(state.scheduler.events[i]);
+  }
+
+  hash = hash_combine(hash, events_hash);
+
+  hash = hash_combine(hash, bus.GetMemoryHash());
+  hash = hash_combine(hash, ppu.GetMemoryHash());
+  return hash;
 }
 
 } // namespace nba::core
\ No newline at end of file
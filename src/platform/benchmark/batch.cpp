@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <fmt/format.h>
+#include <platform/batch_runner.hpp>
+
+#include "common.hpp"
+
+using namespace nba;
+
+/**
+ * Measures the aggregate throughput of many instances running in parallel.
+ * Usage: nba-bench-batch [rom] [instances] [threads] [frames]
+ */
+int main(int argc, char** argv) {
+  auto core = bench::CreateBenchmarkCore(argc > 1 ? argv[1] : nullptr);
+  const int instance_count = argc > 2 ? std::atoi(argv[2]) : 64;
+  const int thread_count = argc > 3 ? std::atoi(argv[3]) : 0;
+  const int frames = argc > 4 ? std::atoi(argv[4]) : 600;
+
+  BatchRunner runner{thread_count};
+
+  runner.AddClones(*core, instance_count);
+
+  // Let the game boot, so that the measurement is not dominated by the boot sequence.
+  runner.RunFrames(60);
+  runner.ResetStatistics();
+
+  runner.RunFrames(frames);
+
+  auto statistics = runner.GetStatistics();
+
+  std::vector<float> p50;
+  std::vector<float> p99;
+
+  for(auto& instance : statistics.instances) {
+    p50.push_back(instance.latency_p50);
+    p99.push_back(instance.latency_p99);
+  }
+
+  std::sort(p50.begin(), p50.end());
+  std::sort(p99.begin(), p99.end());
+
+  fmt::print("instances:            {} on {} threads\n", instance_count, runner.GetThreadCount());
+  fmt::print("frames/s (aggregate): {:.1f}\n", statistics.frames_per_second);
+  fmt::print("frames/s (instance):  {:.1f}\n", statistics.frames_per_second / instance_count);
+  fmt::print("frame time p50:       {:.1f} us (median instance), {:.1f} us (worst instance)\n", p50[p50.size() / 2], p50.back());
+  fmt::print("frame time p99:       {:.1f} us (median instance), {:.1f} us (worst instance)\n", p99[p99.size() / 2], p99.back());
+  return 0;
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <nba/core.hpp>
+#include <string>
+#include <vector>
+
+namespace nba::bench {
+
+/**
+ * Creates a core that runs the given ROM (skipping the BIOS boot screen).
+ * An empty ROM is used when no path is given, which is sufficient
+ * for measurements that do not depend on the emulated software.
+ */
+inline auto CreateBenchmarkCore(char const* rom_path) -> std::unique_ptr<CoreBase> {
+  auto config = std::make_shared<Config>();
+  config->skip_bios = true;
+
+  std::vector<u8> rom;
+
+  if(rom_path) {
+    std::ifstream file{rom_path, std::ios::binary};
+
+    rom.assign(std::istreambuf_iterator<char>{file}, {});
+  }
+
+  if(rom.empty()) {
+    // An endless loop: b 0x08000000
+    rom = {0xFE, 0xFF, 0xFF, 0xEA};
+    rom.resize(0x10000);
+  }
+
+  auto core = CreateCore(config);
+  core->Attach(std::vector<u8>(0x4000));
+  core->Attach(ROM{std::move(rom), nullptr, nullptr});
+  core->Reset();
+  return core;
+}
+
+/**
+ * Calls `function` repeatedly for (at least) `seconds` and returns the number of calls per second.
+ */
+template<typename Function>
+auto MeasureRate(double seconds, Function&& function) -> double {
+  using Clock = std::chrono::steady_clock;
+
+  const auto t0 = Clock::now();
+  u64 iterations = 0;
+  double elapsed;
+
+  do {
+    for(int i = 0; i < 16; i++) {
+      function();
+    }
+    iterations += 16;
+    elapsed = std::chrono::duration<double>(Clock::now() - t0).count();
+  } while(elapsed < seconds);
+
+  return (double)iterations / elapsed;
+}
+
+} // namespace nba::bench
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <cstdlib>
+#include <fmt/format.h>
+#include <nba/common/crc32.hpp>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "common.hpp"
+
+using namespace nba;
+
+/**
+ * Measures the throughput of every CRC32 method that is supported by the CPU
+ * and checks that all methods agree with the bitwise reference implementation.
+ * Usage: nba-bench-crc32 [seconds]
+ */
+int main(int argc, char** argv) {
+  static constexpr std::pair<CRC32Method, char const*> methods[] {
+    { CRC32Method::Bitwise,   "bitwise" },
+    { CRC32Method::SliceBy8,  "slice-by-8" },
+    { CRC32Method::SliceBy16, "slice-by-16" },
+    { CRC32Method::PCLMUL,    "pclmul" },
+    { CRC32Method::ARMv8,     "armv8" }
+  };
+
+  const double seconds = argc > 1 ? std::atof(argv[1]) : 1.0;
+
+  std::vector<u8> buffer(32 * 1024 * 1024);
+  std::mt19937 random{};
+
+  for(auto& byte : buffer) {
+    byte = (u8)random();
+  }
+
+  // Odd lengths and a misaligned start exercise the tails of the wide methods.
+  for(size_t length : {0, 1, 15, 63, 64, 65, 1000, 4093}) {
+    const u32 expected = crc32(CRC32Method::Bitwise, &buffer[3], length);
+
+    for(auto [method, name] : methods) {
+      if(IsCRC32MethodSupported(method) && crc32(method, &buffer[3], length) != expected) {
+        fmt::print("{}: wrong result for {} bytes\n", name, length);
+        return 1;
+      }
+    }
+  }
+
+  fmt::print("selected method: {}\n", methods[(int)GetCRC32Method()].second);
+
+  for(size_t size : {1 << 20, 4 << 20, 32 << 20}) {
+    const u32 expected = crc32(CRC32Method::Bitwise, buffer.data(), size);
+
+    fmt::print("{} MiB:\n", size >> 20);
+
+    for(auto [method, name] : methods) {
+      // The reference implementation is too slow to be measured on large buffers in reasonable time.
+      if(!IsCRC32MethodSupported(method) || (method == CRC32Method::Bitwise && size > (1 << 20))) {
+        continue;
+      }
+
+      u32 result = 0;
+
+      const double rate = bench::MeasureRate(seconds, [&]() {
+        result = crc32(method, buffer.data(), size);
+      });
+
+      fmt::print("  {:12} {:8.2f} GiB/s{}\n", name, rate * size / (1 << 30), result == expected ? "" : " (wrong result)");
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fmt/format.h>
+#include <platform/device/shared_memory_transport.hpp>
+#include <platform/shared_memory/reader.hpp>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace nba;
+
+static auto GetTime() -> u64 {
+  return (u64)std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static int RunReader(std::string const& name, int frames) {
+  auto reader = SharedFrameReader::Open(name);
+
+  if(!reader) {
+    fmt::print("reader: cannot open shared memory\n");
+    return EXIT_FAILURE;
+  }
+
+  std::vector<u64> latencies;
+  u64 frame = 0;
+  int torn_frames = 0;
+
+  while((int)latencies.size() < frames) {
+    frame = reader->WaitForFrame(frame, 1000000);
+
+    const u64 wakeup_time = GetTime();
+
+    if(frame == 0) {
+      fmt::print("reader: timed out\n");
+      return EXIT_FAILURE;
+    }
+
+    SharedFrameReader::Frame view;
+
+    if(!reader->Acquire(frame, view)) {
+      torn_frames++;
+      continue;
+    }
+
+    latencies.push_back(wakeup_time - view.publish_time);
+  }
+
+  std::sort(latencies.begin(), latencies.end());
+
+  const auto percentile = [&](int p) {
+    return latencies[(latencies.size() - 1) * p / 100] / 1000.0;
+  };
+
+  fmt::print("frames:          {}\n", frames);
+  fmt::print("skipped frames:  {}\n", torn_frames);
+  fmt::print("publish -> wakeup latency (us): p50 {:.1f}, p90 {:.1f}, p99 {:.1f}, max {:.1f}\n",
+    percentile(50), percentile(90), percentile(99), latencies.back() / 1000.0);
+  return EXIT_SUCCESS;
+}
+
+/**
+ * Measures the latency from publishing a frame to the wakeup of a reader in another process.
+ * Usage: nba-bench-shm [frames] [interval in microseconds]
+ */
+int main(int argc, char** argv) {
+  const int frames = argc > 1 ? std::atoi(argv[1]) : 2000;
+  const int interval = argc > 2 ? std::atoi(argv[2]) : 1000;
+  const std::string name = fmt::format("/nba-bench-shm-{}", getpid());
+
+  auto transport = SharedMemoryTransport::Create(name);
+
+  if(!transport) {
+    fmt::print("cannot create shared memory\n");
+    return EXIT_FAILURE;
+  }
+
+  const pid_t pid = fork();
+
+  if(pid == 0) {
+    const int result = RunReader(name, frames);
+
+    // Leave without running destructors, the shared memory belongs to the parent.
+    std::fflush(stdout);
+    std::_Exit(result);
+  }
+
+  auto video_device = transport->GetVideoDevice();
+  std::vector<u32> buffer(SharedFrameBuffer::kWidth * SharedFrameBuffer::kHeight);
+
+  // Give the reader time to start waiting.
+  std::this_thread::sleep_for(std::chrono::milliseconds{100});
+
+  // Keep publishing until the reader is done, since it may skip frames.
+  int status = EXIT_FAILURE;
+
+  for(u32 i = 0; waitpid(pid, &status, WNOHANG) == 0; i++) {
+    buffer[0] = i;
+    video_device->Draw(buffer.data());
+    std::this_thread::sleep_for(std::chrono::microseconds{interval});
+  }
+
+  return WIFEXITED(status) ? WEXITSTATUS(status) : EXIT_FAILURE;
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <cstdlib>
+#include <fmt/format.h>
+#include <memory>
+
+#include "common.hpp"
+
+using namespace nba;
+
+/**
+ * Measures how many times per second the core state can be snapshotted and restored.
+ * Usage: nba-bench-snapshot [rom] [seconds]
+ */
+int main(int argc, char** argv) {
+  auto core = bench::CreateBenchmarkCore(argc > 1 ? argv[1] : nullptr);
+  const double seconds = argc > 2 ? std::atof(argv[2]) : 2.0;
+
+  // Let the game boot, so that the state resembles that of a running game.
+  for(int i = 0; i < 60; i++) {
+    core->RunForOneFrame();
+  }
+
+  auto buffer = MakeSnapshotData();
+
+  const double snapshot_rate = bench::MeasureRate(seconds, [&]() {
+    core->Snapshot(buffer.get(), CoreBase::kSnapshotSize);
+  });
+
+  const double restore_rate = bench::MeasureRate(seconds, [&]() {
+    core->Restore(buffer.get(), CoreBase::kSnapshotSize);
+  });
+
+  const double frame_rate = bench::MeasureRate(seconds, [&]() {
+    core->RunForOneFrame();
+  });
+
+  const double frame_snapshot_rate = bench::MeasureRate(seconds, [&]() {
+    core->RunForOneFrame();
+    core->Snapshot(buffer.get(), CoreBase::kSnapshotSize);
+  });
+
+  fmt::print("snapshot size:        {} bytes\n", CoreBase::kSnapshotSize);
+  fmt::print("snapshots/s:          {:.0f} ({:.2f} GiB/s)\n", snapshot_rate, snapshot_rate * CoreBase::kSnapshotSize / (1 << 30));
+  fmt::print("restores/s:           {:.0f} ({:.2f} GiB/s)\n", restore_rate, restore_rate * CoreBase::kSnapshotSize / (1 << 30));
+  fmt::print("frames/s:             {:.1f}\n", frame_rate);
+  fmt::print("frames/s (+snapshot): {:.1f}\n", frame_snapshot_rate);
+  return 0;
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <memory>
+#include <nba/integer.hpp>
+#include <platform/file_lock.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace nba {
+
+/**
+ * Keeps ROMs that have been extracted from archives (zip, rar, 7z, tar) as uncompressed files,
+ * so that loading an archive a second time does not decompress it again and the ROM can be
+ * memory-mapped directly.
+ *
+ * Archives are identified by their path, modification time and size. The extracted files are
+ * named after the CRC32 and size of the ROM, so archives containing the same ROM share one file.
+ * Once the extracted files exceed the size limit, the least recently used ones are deleted.
+ *
+ * Several processes may share a cache directory. The index and the extracted files are only
+ * modified while holding a lock file, and the index is read again each time the lock is taken.
+ */
+struct ArchiveCache {
+  enum class Result {
+    NotAnArchive,
+    NoROM,  // the archive does not contain a .gba file
+    Failed, // the ROM could not be cached, it has to be extracted without the cache
+    Success
+  };
+
+  ArchiveCache(fs::path const& directory, u64 size_limit);
+ ~ArchiveCache();
+
+  /**
+   * Extracts the ROM, unless it has already been extracted, and returns the path of the extracted file.
+   * `entry_name` selects a file inside the archive, by default the first .gba file is used.
+   */
+  auto Get(fs::path const& archive_path, fs::path& rom_path, std::string const& entry_name = {}) -> Result;
+
+  // Extracts the ROMs of the given archives on a background thread, e.g. for recently used games.
+  void Prefetch(std::vector<fs::path> const& archive_paths);
+
+private:
+  static constexpr u32 kMagicNumber = 0x4341424E; // "NBAC"
+  static constexpr u32 kFormatVersion = 2;
+
+  struct Entry {
+    std::string archive_path;
+    std::string entry_name; // as requested, empty for the first .gba file
+    u64 archive_write_time;
+    u64 archive_size;
+    u32 rom_crc32;
+    u32 rom_size;
+    u64 last_used;
+  };
+
+  struct ArchiveInfo {
+    std::string path;
+    u64 write_time;
+    u64 size;
+  };
+
+  static auto GetArchiveInfo(fs::path const& archive_path, ArchiveInfo& info) -> bool;
+
+  auto GetROMPath(Entry const& entry) const -> fs::path;
+  auto LockDirectory() const -> std::unique_ptr<FileLock>;
+  auto Find(ArchiveInfo const& info, std::string const& entry_name) -> Entry*;
+  void Evict();
+  void ReadIndex();
+  void WriteIndex();
+  void RunPrefetchThread();
+
+  fs::path directory;
+  u64 size_limit;
+  u64 use_counter = 0;
+
+  std::mutex mutex;
+  std::vector<Entry> entries;
+
+  std::thread prefetch_thread;
+  std::mutex prefetch_mutex;
+  std::condition_variable prefetch_cv;
+  std::deque<fs::path> prefetch_queue;
+  bool prefetch_stop = false;
+};
+
+} // namespace nba
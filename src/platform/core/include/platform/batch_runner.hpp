@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <nba/core.hpp>
+#include <thread>
+#include <vector>
+
+namespace nba {
+
+/**
+ * Runs many independent cores on a pool of worker threads.
+ *
+ * Each instance is a job that runs a number of slices (frames or cycle counts).
+ * Jobs are distributed round-robin over the workers, a worker that runs out of jobs
+ * steals pending jobs from the other workers. An instance never runs on two threads at once.
+ *
+ * Instances must not share their Config or devices: the key pad installs its input callback
+ * on the input device and the APU opens the audio device. Clones created with AddClones()
+ * or CoreBase::Clone() without a config satisfy this.
+ */
+struct BatchRunner {
+  struct Statistics {
+    struct Instance {
+      u64 frames = 0;
+
+      // Wall time of a single slice in microseconds, over the most recent slices.
+      float latency_p50 = 0;
+      float latency_p90 = 0;
+      float latency_p99 = 0;
+      float latency_max = 0;
+    };
+
+    double frames_per_second = 0;
+    std::vector<Instance> instances;
+  };
+
+  // A thread count of zero uses one thread per hardware thread.
+  BatchRunner(int thread_count = 0, bool pin_threads = true);
+ ~BatchRunner();
+
+  // Returns the index of the new instance.
+  auto Add(std::unique_ptr<CoreBase> core) -> int;
+
+  // Adds `count` clones of `core` (see CoreBase::Clone()), each with its own config.
+  void AddClones(CoreBase& core, int count);
+
+  auto GetCore(int index) -> CoreBase& { return *instances[index]->core; }
+  auto GetInstanceCount() const -> int { return (int)instances.size(); }
+  auto GetThreadCount() const -> int { return (int)workers.size(); }
+
+  // Runs every instance for `count` frames and returns once all instances are done.
+  void RunFrames(int count);
+
+  // Runs every instance for `count` slices of `cycles` cycles.
+  void RunCycles(int cycles, int count = 1);
+
+  auto GetStatistics() const -> Statistics;
+  void ResetStatistics();
+
+private:
+  static constexpr int kLatencySampleCount = 4096;
+
+  struct Instance {
+    std::unique_ptr<CoreBase> core;
+    u64 cycles = 0;
+
+    // Ring buffer of slice durations.
+    std::vector<float> latencies;
+    size_t latency_index = 0;
+  };
+
+  struct Job {
+    int instance;
+    int slices;
+  };
+
+  struct Worker {
+    std::thread thread;
+    std::mutex mutex;
+    std::deque<Job> jobs;
+  };
+
+  void Run(int cycles, int count);
+  void WorkerMain(int id);
+  auto PopJob(int id, Job& job) -> bool;
+  void WaitForJob();
+  void NotifyJobQueued();
+  void NotifyBatchDone();
+  void RunSlice(Instance& instance);
+
+  std::vector<std::unique_ptr<Instance>> instances;
+  std::vector<std::unique_ptr<Worker>> workers;
+
+  // Cycles per slice, zero means one frame.
+  int slice_cycles = 0;
+
+  std::mutex batch_mutex;
+  std::condition_variable batch_start;
+  std::condition_variable batch_done;
+  u64 batch_id = 0;
+  int busy_workers = 0;
+  std::atomic_int pending_jobs = 0;
+  bool quit = false;
+
+  // Workers that find no job to steal sleep until a job is put back into a queue or the batch is done.
+  std::mutex idle_mutex;
+  std::condition_variable job_available;
+  std::atomic_int queued_jobs = 0;
+  std::atomic_int idle_workers = 0;
+
+  double run_time = 0;
+};
+
+} // namespace nba
@@ -16,6 +16,7 @@ namespace nba {
 struct PlatformConfig : Config {
   std::string bios_path = "bios.bin";
   std::string save_folder = "";
+  int run_ahead_frames = 0;
   
   struct Cartridge {
     BackupType backup_type = BackupType::Detect;
@@ -41,6 +42,12 @@ struct PlatformConfig : Config {
     bool lcd_ghosting = true;
   } video;
 
+  struct ArchiveCache {
+    bool enable = true;
+    int size_limit_mib = 1024;
+    bool prefetch_recent = false;
+  } archive_cache;
+
   void Load(std::string const& path);
   void Save(std::string const& path);
 
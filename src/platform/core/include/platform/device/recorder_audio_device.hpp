@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <nba/device/audio_device.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace nba {
+
+/**
+ * Records the audio output of the core to a file.
+ *
+ * Unlike a regular audio device the recorder is not driven by the host's audio clock.
+ * Instead the embedder calls Advance() with the number of emulated cycles,
+ * which means audio can be rendered faster than realtime (or headless).
+ * The samples are collected into blocks that are written to disk by a background thread.
+ */
+struct RecorderAudioDevice : AudioDevice {
+  enum class Format {
+    WAV_S16,
+    RAW_S16,
+    RAW_F32
+  };
+
+  RecorderAudioDevice(
+    std::string const& path,
+    Format format = Format::WAV_S16,
+    int sample_rate = 48000,
+    int block_size = 2048
+  );
+
+ ~RecorderAudioDevice() override;
+
+  bool IsGood() const;
+  void Advance(int cycles);
+  void Finish();
+
+  auto GetSampleRate() -> int final;
+  auto GetBlockSize() -> int final;
+  bool Open(void* userdata, Callback callback) final;
+  void SetPause(bool value) final;
+  void Close() final;
+
+private:
+  static constexpr int kCyclesPerSecond = 16777216;
+
+  // Number of samples that are left in the core's ring buffer, to account for resampler latency.
+  static constexpr int kLatency = 32;
+
+  struct Block {
+    std::vector<s16> samples;
+    int length = 0;
+  };
+
+  void WriteHeader();
+  void WriteBlock(Block const& block);
+  void SubmitBlock();
+  void WriterThread();
+
+  std::ofstream file;
+  Format format;
+  int sample_rate;
+  int block_size;
+  bool paused = false;
+  bool finished = false;
+  u64 bytes_written = 0;
+
+  Callback callback = nullptr;
+  void* callback_userdata = nullptr;
+  u64 cycles_total = 0;
+  u64 samples_total = 0;
+
+  Block blocks[2];
+  int front = 0;
+
+  std::thread thread;
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool block_pending = false;
+  bool quit = false;
+};
+
+} // namespace nba
@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <nba/device/input_device.hpp>
+#include <nba/device/video_device.hpp>
+#include <platform/shared_memory/frame_buffer.hpp>
+#include <platform/shared_memory/region.hpp>
+#include <string>
+
+namespace nba {
+
+/**
+ * Publishes frames into a shared memory ring and takes the input from the same region,
+ * so that other processes can drive the emulator (see SharedFrameReader).
+ * The input is sampled whenever a frame is published, i.e. once per frame.
+ */
+struct SharedMemoryTransport {
+  // Returns nullptr if the shared memory cannot be created.
+  static auto Create(std::string const& name, int slot_count = 4) -> std::unique_ptr<SharedMemoryTransport>;
+
+  auto GetVideoDevice() -> std::shared_ptr<VideoDevice> { return video_device; }
+  auto GetInputDevice() -> std::shared_ptr<InputDevice> { return input_device; }
+
+private:
+  struct SharedInputDevice : InputDevice {
+    auto Poll(Key key) -> bool final;
+    void SetOnChangeCallback(std::function<void(void)> callback) final;
+
+    // Reads the keys from shared memory and notifies the core if they have changed.
+    void Update();
+
+    SharedFrameBuffer::Header* header = nullptr;
+    u32 keys = 0;
+    std::function<void(void)> on_change_callback;
+  };
+
+  struct SharedVideoDevice : VideoDevice {
+    void Draw(u32* buffer) final;
+
+    SharedFrameBuffer::Header* header = nullptr;
+    std::shared_ptr<SharedInputDevice> input_device;
+
+    // The devices may outlive the transport, when they are still referenced by a Config.
+    std::shared_ptr<SharedMemoryRegion> region;
+  };
+
+  SharedMemoryTransport() = default;
+
+  std::shared_ptr<SharedVideoDevice> video_device;
+  std::shared_ptr<SharedInputDevice> input_device;
+};
+
+} // namespace nba
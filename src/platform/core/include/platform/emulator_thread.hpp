@@ -8,14 +8,31 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <nba/core.hpp>
 #include <platform/frame_limiter.hpp>
 #include <thread> 
+#include <vector>
 
 namespace nba {
 
 struct EmulatorThread {
+  static constexpr float kFrameRate = 59.7275;
+  static constexpr int kMaxRunAheadFrames = 8;
+
+  // Averages over the last reporting interval (one second), in milliseconds.
+  struct FrameTimings {
+    int run_ahead_frames;
+    float frame_time;
+    float frame_time_max;
+    float snapshot_time;
+    float restore_time;
+    float frame_time_budget;
+  };
+
   EmulatorThread(std::unique_ptr<CoreBase>& core);
  ~EmulatorThread();
 
@@ -26,10 +43,26 @@ struct EmulatorThread {
   void SetFastForward(bool enabled);
   void SetFrameRateCallback(std::function<void(float)> callback);
   void SetPerFrameCallback(std::function<void()> callback);
+  void SetFrameTimingsCallback(std::function<void(FrameTimings const&)> callback);
+  int GetRunAheadFrames() const;
+  void SetRunAheadFrames(int frames);
   void Start();
   void Stop();
 
+  /**
+   * Runs a task on the emulator thread in between two frames, e.g. to access the core
+   * without stopping emulation. If the thread is not running, the task is run immediately.
+   */
+  void Invoke(std::function<void()> task);
+
 private:
+  using Clock = std::chrono::steady_clock;
+
+  void RunTasks();
+  void RunFrame();
+  void RunFrameWithRunAhead(int run_ahead_frames);
+  void ReportFrameTimings();
+
   std::unique_ptr<CoreBase>& core;
   FrameLimiter frame_limiter;
   std::thread thread;
@@ -37,6 +70,23 @@ private:
   bool paused = false;
   std::function<void(float)> frame_rate_cb = [](float) {};
   std::function<void()> per_frame_cb = []() {};
+  std::function<void(FrameTimings const&)> frame_timings_cb = [](FrameTimings const&) {};
+
+  std::mutex tasks_mutex;
+  std::vector<std::function<void()>> tasks;
+  bool accept_tasks = false;
+
+  std::atomic_int run_ahead_frames = 0;
+  std::unique_ptr<SnapshotData> run_ahead_state;
+  bool run_ahead_state_valid = false;
+
+  struct FrameTimingsAccumulator {
+    int frames = 0;
+    double frame_time = 0;
+    double frame_time_max = 0;
+    double snapshot_time = 0;
+    double restore_time = 0;
+  } frame_timings;
 };
 
 } // namespace nba
@@ -0,0 +1,38 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <memory>
+
+namespace fs = std::filesystem;
+
+namespace nba {
+
+/**
+ * An exclusive lock on a file, which at most one FileLock holds at a time, across all processes.
+ * The lock is released when the FileLock is destroyed or the process exits.
+ */
+struct FileLock {
+ ~FileLock();
+
+  // Creates the file if necessary and waits until the lock has been acquired.
+  // Returns nullptr if the file cannot be opened or locked.
+  static auto Acquire(fs::path const& path) -> std::unique_ptr<FileLock>;
+
+private:
+  FileLock() = default;
+
+#ifdef _WIN32
+  void* file_handle = nullptr;
+#else
+  int fd = -1;
+#endif
+};
+
+} // namespace nba
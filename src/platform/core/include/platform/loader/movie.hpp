@@ -0,0 +1,32 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <platform/movie.hpp>
+
+namespace fs = std::filesystem;
+
+namespace nba {
+
+struct MovieLoader {
+  enum class Result {
+    CannotFindFile,
+    CannotOpenFile,
+    BadImage,
+    UnsupportedVersion,
+    Success
+  };
+
+  static auto Load(
+    Movie& movie,
+    fs::path const& path
+  ) -> Result;
+};
+
+} // namespace nba
@@ -7,9 +7,14 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
+#include <nba/common/memory_span.hpp>
 #include <nba/core.hpp>
 #include <nba/rom/backup/backup.hpp>
+#include <platform/archive_cache.hpp>
 #include <platform/game_db.hpp>
+#include <platform/rom_analysis_cache.hpp>
 #include <string>
 
 namespace fs = std::filesystem;
@@ -24,11 +29,23 @@ struct ROMLoader {
     Success
   };
 
+  /**
+   * If `analysis_cache` is null, the ROM is scanned (for the backup type and the MP2K sound mixer)
+   * every time it is loaded. Otherwise the scan results are taken from and added to the cache.
+   *
+   * If `archive_cache` is null, ROMs inside archives are decompressed into memory every time they
+   * are loaded. Otherwise they are extracted once and then mapped from the extracted file.
+   *
+   * Loading the same unmodified ROM file into several cores shares one copy of the ROM, for as long
+   * as any core still uses it.
+   */
   static auto Load(
     std::unique_ptr<CoreBase>& core,
     fs::path const& path,
     Config::BackupType backup_type = Config::BackupType::Detect,
-    GPIODeviceType force_gpio = GPIODeviceType::None
+    GPIODeviceType force_gpio = GPIODeviceType::None,
+    ROMAnalysisCache* analysis_cache = nullptr,
+    ArchiveCache* archive_cache = nullptr
   ) -> Result;
 
   static auto Load(
@@ -36,21 +53,50 @@ struct ROMLoader {
     fs::path const& rom_path,
     fs::path const& save_path,
     Config::BackupType backup_type = Config::BackupType::Detect,
-    GPIODeviceType force_gpio = GPIODeviceType::None
+    GPIODeviceType force_gpio = GPIODeviceType::None,
+    ROMAnalysisCache* analysis_cache = nullptr,
+    ArchiveCache* archive_cache = nullptr
+  ) -> Result;
+
+  /**
+   * Maps ROM files instead of reading them into memory, which makes loading a large number of cores
+   * cheaper. The emulator crashes if a mapped ROM file is truncated or rewritten in place, so this
+   * is only meant for farms of cores that run a fixed set of ROM files. Disabled by default.
+   * ROMs extracted by the ArchiveCache are always mapped, since these files are never modified.
+   */
+  static void SetMapROMFiles(bool map_rom_files);
+
+  /**
+   * Decompresses the first .gba file in a zip, rar, 7z or tar archive. If `entry_name` points to
+   * a non-empty name, the file of that name is decompressed instead. Otherwise the name of the
+   * decompressed file is stored in it.
+   * Returns CannotOpenFile if the file is not an archive and BadImage if it contains no such file.
+   */
+  static auto ReadFileFromArchive(
+    fs::path const& path,
+    std::vector<u8>& file_data,
+    std::string* entry_name = nullptr
   ) -> Result;
 
 private:
-  static auto ReadFile(fs::path const& path, std::vector<u8>& file_data) -> Result;
-  static auto ReadFileFromArchive(fs::path const& path, std::vector<u8>& file_data) -> Result;
+  static auto ReadFile(
+    fs::path const& path,
+    std::shared_ptr<MemorySpan const>& file_data,
+    ArchiveCache* archive_cache
+  ) -> Result;
+
+  /**
+   * Maps a ROM file read-only or reads it into memory. Loading the same unmodified file again,
+   * e.g. for another core, returns the existing mapping or copy for as long as any core still uses it.
+   */
+  static auto OpenFile(fs::path const& path, bool map) -> std::shared_ptr<MemorySpan const>;
+
+  static std::atomic<bool> map_rom_files;
 
   static auto GetGameInfo(
-    std::vector<u8>& file_data
+    MemorySpan const& file_data
   ) -> GameInfo;
 
-  static auto GetBackupType(
-    std::vector<u8>& file_data
-  ) -> Config::BackupType;
-
   static auto CreateBackup(
     std::unique_ptr<CoreBase>& core,
     fs::path const& save_path,
@@ -9,6 +9,7 @@
 
 #include <filesystem>
 #include <nba/core.hpp>
+#include <platform/save_state_file.hpp>
 #include <string>
 
 namespace fs = std::filesystem;
@@ -30,6 +31,7 @@ struct SaveStateLoader {
   ) -> Result;
 
 private:
+  static auto ConvertResult(SaveStateFile::Result result) -> Result;
   static auto Validate(SaveState const& save_state) -> Result;
 };
 
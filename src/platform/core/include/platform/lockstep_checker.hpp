@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <nba/core.hpp>
+#include <nba/integer.hpp>
+#include <string>
+#include <vector>
+
+namespace nba {
+
+/**
+ * Runs two cores side by side and compares their state after every step,
+ * e.g. to verify that an optimization (or a different configuration) does not change emulation.
+ * Both cores must start from the same state and must receive the same input.
+ *
+ * When all components are compared, the state hashes (see CoreBase::StateHash()) are compared first
+ * and the full states are only copied and diffed once the hashes differ.
+ */
+struct LockstepChecker {
+  enum Component : u32 {
+    CPU       = 1 << 0, // ARM registers and pipeline
+    Memory    = 1 << 1, // EWRAM, IWRAM, PRAM, VRAM and OAM
+    IO        = 1 << 2, // Bus, IRQ, PPU, timer, DMA and keypad registers
+    Audio     = 1 << 3, // APU state
+    Scheduler = 1 << 4, // Timestamp and pending events
+    All       = (1 << 5) - 1
+  };
+
+  struct Divergence {
+    u64 step = 0;
+    u64 timestamp = 0;
+    std::vector<std::string> differences;
+  };
+
+  LockstepChecker(CoreBase& core_a, CoreBase& core_b, u32 components = Component::All);
+
+  /**
+   * Runs both cores for `cycles` cycles and compares them.
+   * Returns false if the cores have diverged, see GetDivergence().
+   */
+  bool Step(int cycles);
+
+  auto GetStepCount() const -> u64 { return step_count; }
+  auto HasDiverged() const -> bool { return diverged; }
+  auto GetDivergence() const -> Divergence const& { return divergence; }
+
+private:
+  void Compare();
+  void DiffCPU();
+  void DiffScheduler();
+  void DiffBytes(std::string const& name, u32 base_address, void const* data_a, void const* data_b, size_t size);
+
+  template<typename T>
+  void DiffBytes(std::string const& name, T const& value_a, T const& value_b) {
+    DiffBytes(name, 0, &value_a, &value_b, sizeof(T));
+  }
+
+  CoreBase& core_a;
+  CoreBase& core_b;
+  u32 components;
+
+  u64 step_count = 0;
+  bool diverged = false;
+  Divergence divergence;
+
+  std::unique_ptr<SaveState> state_a;
+  std::unique_ptr<SaveState> state_b;
+};
+
+} // namespace nba
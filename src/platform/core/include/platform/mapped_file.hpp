@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <nba/integer.hpp>
+
+namespace fs = std::filesystem;
+
+namespace nba {
+
+/**
+ * A read-only memory mapping of a file. Pages are only read from disk once they are accessed,
+ * so opening a file is cheap regardless of its size.
+ */
+struct MappedFile {
+ ~MappedFile();
+
+  // Returns nullptr if the file cannot be opened or mapped.
+  static auto Open(fs::path const& path) -> std::unique_ptr<MappedFile>;
+
+  auto Data() const -> u8 const* { return data; }
+  auto Size() const -> size_t { return size; }
+
+private:
+  MappedFile() = default;
+
+  u8 const* data = nullptr;
+  size_t size = 0;
+
+#ifdef _WIN32
+  void* file_handle = nullptr;
+  void* mapping_handle = nullptr;
+#endif
+};
+
+} // namespace nba
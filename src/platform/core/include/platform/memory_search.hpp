@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <nba/core.hpp>
+#include <vector>
+
+namespace nba {
+
+/**
+ * Searches EWRAM and IWRAM for values that behave in a given way, e.g. to find cheat codes
+ * or variables for reward functions. Each filter compares the current memory against the
+ * previous filter (or the start of the search) and removes the candidates that do not match.
+ *
+ * Candidates are naturally aligned values of the search width. The candidate set is a bitmap,
+ * which only stores blocks that still contain candidates, so that filters become cheaper
+ * the more candidates have been removed.
+ */
+struct MemorySearch {
+  enum class Width {
+    Byte = 1,
+    Half = 2,
+    Word = 4
+  };
+
+  enum class Condition {
+    Equal,       // value == a
+    NotEqual,    // value != a
+    Changed,     // value != previous
+    Unchanged,   // value == previous
+    Increased,   // value >  previous
+    Decreased,   // value <  previous
+    IncreasedBy, // value == previous + a
+    DecreasedBy, // value == previous - a
+    InRange      // a <= value <= b
+  };
+
+  struct Candidate {
+    u32 address;
+    u32 previous_value;
+  };
+
+  // Starts a new search, every value in EWRAM and IWRAM is a candidate.
+  void Start(CoreBase& core, Width width);
+
+  // Values are compared as unsigned integers.
+  void Filter(CoreBase& core, Condition condition, u32 a = 0, u32 b = 0);
+
+  auto GetWidth() const -> Width { return width; }
+  auto GetCandidateCount() const -> size_t;
+
+  // Returns at most `max_count` candidates in ascending address order.
+  auto GetCandidates(size_t max_count) const -> std::vector<Candidate>;
+
+private:
+  static constexpr size_t kWRAMSize = 0x40000;
+  static constexpr size_t kIRAMSize = 0x8000;
+  static constexpr int kBlockSize = 512; // candidates per block
+
+  struct Block {
+    u32 index;
+    u64 bits[kBlockSize / 64];
+  };
+
+  auto GetBlockMemory(CoreBase& core, u32 index) const -> u8 const*;
+  auto GetAddress(size_t candidate) const -> u32;
+
+  Width width = Width::Byte;
+  std::vector<Block> blocks;
+
+  // The memory as seen by the previous filter, EWRAM followed by IWRAM.
+  std::vector<u8> previous;
+};
+
+} // namespace nba
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <nba/core.hpp>
+#include <nba/integer.hpp>
+#include <vector>
+
+namespace nba {
+
+/**
+ * An input movie: the key input of every frame, starting either at power-on or from a snapshot.
+ * Checkpoints (state hashes at regular intervals) allow desyncs to be detected
+ * close to where they happen, rather than only at the end of the movie.
+ */
+struct Movie {
+  static constexpr u32 kMagicNumber = 0x564F4D4E; // NMOV
+  static constexpr u32 kFormatVersion = 2;
+
+  struct Checkpoint {
+    u64 frame;
+    u64 state_hash;
+  };
+
+  u32 rom_crc32 = 0;
+  s64 rtc_seed = 0;
+  bool skip_bios = false;
+
+  // State encoded with SaveStateFile::Encode(), empty if the movie starts at power-on.
+  std::vector<u8> start_state;
+
+  // Contents of the backup memory at power-on. The state above already contains them.
+  std::vector<u8> start_backup;
+
+  // Pressed keys for each frame, bit n is set if InputDevice::Key n is pressed.
+  std::vector<u16> frames;
+
+  std::vector<Checkpoint> checkpoints;
+};
+
+/**
+ * Input device for movie recording and playback. The keys are only changed between frames,
+ * so that the input is applied at the exact same point in emulated time on playback.
+ */
+struct MovieInputDevice : InputDevice {
+  void SetKeys(u16 keys) {
+    this->keys = keys;
+
+    // Always notify the core, so that the input is latched in the same way on every frame.
+    if(on_change_callback) {
+      on_change_callback();
+    }
+  }
+
+  auto GetKeys() const -> u16 { return keys; }
+
+  auto Poll(Key key) -> bool final {
+    return keys & (1 << (int)key);
+  }
+
+  void SetOnChangeCallback(std::function<void(void)> callback) final {
+    on_change_callback = callback;
+  }
+
+private:
+  u16 keys = 0;
+  std::function<void(void)> on_change_callback;
+};
+
+/**
+ * Records a movie. `config` must be the config of `core` and its input device must be `input`.
+ */
+struct MovieRecorder {
+  MovieRecorder(
+    CoreBase& core,
+    std::shared_ptr<Config> config,
+    MovieInputDevice& input,
+    int checkpoint_interval = 60
+  );
+
+  /**
+   * Starts a new movie, either by resetting the core or from the current state.
+   * If the config does not specify an RTC seed, the current time is used as seed.
+   */
+  void Start(bool from_power_on);
+
+  // Runs one frame with the given keys (see Movie::frames) pressed.
+  void RunFrame(u16 keys);
+
+  auto GetMovie() const -> Movie const& { return movie; }
+
+private:
+  CoreBase& core;
+  std::shared_ptr<Config> config;
+  MovieInputDevice& input;
+  int checkpoint_interval;
+  Movie movie;
+};
+
+/**
+ * Plays a movie back. `config` must be the config of `core` and its input device must be `input`.
+ * Nothing else is done per frame, so playback runs as fast as the core.
+ */
+struct MoviePlayer {
+  enum class Result {
+    ROMMismatch,
+    BadImage,
+    Success
+  };
+
+  enum class Status {
+    Playing,
+    Finished,
+    Desync
+  };
+
+  MoviePlayer(
+    CoreBase& core,
+    std::shared_ptr<Config> config,
+    MovieInputDevice& input,
+    Movie const& movie
+  );
+
+  /**
+   * Verifies the ROM and restores the initial state of the movie, including the backup memory.
+   * The restored backup memory is written to the save file of the cartridge like any write of the game,
+   * so the cartridge should use a throwaway save file (or be a clone, which keeps its backup in memory).
+   */
+  auto Start() -> Result;
+
+  auto RunFrame() -> Status;
+
+  // Plays the remaining frames and returns either Finished or Desync.
+  auto RunToEnd() -> Status;
+
+  auto GetFrame() const -> u64 { return frame; }
+
+  // The frame of the checkpoint that did not match.
+  auto GetDesyncFrame() const -> u64 { return desync_frame; }
+
+private:
+  CoreBase& core;
+  std::shared_ptr<Config> config;
+  MovieInputDevice& input;
+  Movie const& movie;
+
+  u64 frame = 0;
+  size_t next_checkpoint = 0;
+  u64 desync_frame = 0;
+  Status status = Status::Playing;
+};
+
+} // namespace nba
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <nba/core.hpp>
+#include <nba/integer.hpp>
+#include <vector>
+
+namespace nba {
+
+/**
+ * Keeps a history of snapshots of the emulator state for rewinding.
+ *
+ * A snapshot is captured every `snapshot_interval` frames. Each snapshot is stored as the
+ * XOR difference to the previous snapshot, which is mostly zero because most of the state
+ * does not change from one frame to the next. The difference is then compressed by encoding
+ * runs of zero words. Every `keyframe_interval` snapshots a keyframe is stored, which does not depend
+ * on any previous snapshot. When the memory budget is exceeded, the oldest keyframe and its deltas are dropped,
+ * or if there is no newer keyframe, the oldest delta is turned into a keyframe in place of the old one.
+ *
+ * Stepping back always lands on a snapshot. The frames between two snapshots cannot be reproduced exactly,
+ * because the input of those frames is not recorded, so a step back covers at least the requested number of frames.
+ */
+struct RewindBuffer {
+  RewindBuffer(
+    size_t memory_budget = 64 * 1024 * 1024,
+    int snapshot_interval = 1,
+    int keyframe_interval = 60
+  );
+
+  void Reset();
+
+  // Must be called once after every emulated frame.
+  void Push(CoreBase& core);
+
+  /**
+   * Restores the latest snapshot that is at least `frames` frames old.
+   * Returns false if the history does not reach back far enough.
+   */
+  bool StepBack(CoreBase& core, int frames = 1);
+
+  // The number of frames that the history reaches back.
+  auto GetFrameCount() const -> u64;
+  auto GetMemoryUsage() const -> size_t { return memory_usage; }
+  auto GetSnapshotCount() const -> size_t { return snapshots.size(); }
+
+private:
+  struct Snapshot {
+    u64 frame;
+    bool keyframe;
+    std::vector<u8> data;
+  };
+
+  static void Encode(u8 const* current, u8 const* previous, std::vector<u8>& output);
+  static void Decode(std::vector<u8> const& input, u8* state);
+
+  void Capture(CoreBase& core);
+  void Decode(size_t index, u8* state);
+  void Evict();
+
+  size_t memory_budget;
+  int snapshot_interval;
+  int keyframe_interval;
+
+  u64 frame = 0;
+  size_t memory_usage = 0;
+  int snapshots_since_keyframe = 0;
+  std::deque<Snapshot> snapshots;
+
+  // Uncompressed copies of the latest snapshot and of the snapshot that is currently captured.
+  std::unique_ptr<SnapshotData> previous;
+  std::unique_ptr<SnapshotData> current;
+  std::vector<u8> scratch;
+};
+
+} // namespace nba
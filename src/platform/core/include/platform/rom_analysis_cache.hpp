@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <mutex>
+#include <nba/common/memory_span.hpp>
+#include <nba/rom/analysis.hpp>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace nba {
+
+/**
+ * Stores the result of AnalyzeROM() in a file, so that a ROM is only scanned the first time
+ * it is loaded. ROMs are identified by their size, CRC32 and 64-bit hash. The cache is safe to use from
+ * multiple threads.
+ */
+struct ROMAnalysisCache {
+  // Reads the cache file, if it exists. Invalid cache files are ignored and replaced.
+  ROMAnalysisCache(fs::path const& path);
+
+  // Returns the cached analysis or analyzes the ROM and adds the result to the cache file.
+  auto Get(MemorySpan rom) -> ROMAnalysis;
+
+private:
+  static constexpr u32 kMagicNumber = 0x4152424E; // "NBRA"
+  static constexpr u32 kFormatVersion = 2;
+
+  struct Entry {
+    u64 hash;
+    u32 crc32;
+    u32 size;
+    u32 sound_main_ram;
+    u32 backup_type;
+  };
+
+  auto Find(u64 hash, u32 crc, u32 size) -> Entry*;
+  void Read();
+  void Write();
+
+  fs::path path;
+  std::mutex mutex;
+  std::vector<Entry> entries;
+};
+
+} // namespace nba
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <nba/integer.hpp>
+#include <nba/save_state.hpp>
+#include <platform/mapped_file.hpp>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace nba {
+
+/**
+ * The on-disk format of save states.
+ *
+ * A file consists of a header (magic, format version, state version, section count),
+ * a table of sections and the section data. Every section holds the state of one subsystem
+ * and is described by its tag, flags, uncompressed size, stored size, file offset and
+ * the CRC32 of its uncompressed data. Sections are run-length compressed if that makes them smaller.
+ *
+ * Files are memory-mapped and sections are only decoded on request, so reading
+ * e.g. the backup memory does not require decoding the whole state.
+ * States of older versions are upgraded section by section while decoding them.
+ * Raw SaveState images of version 9, the last version that was written
+ * before this format existed, are still read.
+ */
+struct SaveStateFile {
+  static constexpr u32 kMagicNumber = 0x4653424E; // NBSF
+  static constexpr u32 kFormatVersion = 1;
+  static constexpr u32 kOldestSupportedVersion = 9;
+
+  enum class Section {
+    Core,
+    ARM,
+    Bus,
+    IRQ,
+    PPU,
+    APU,
+    Timer,
+    DMA,
+    Backup,
+    GPIO,
+    Scheduler,
+    Count
+  };
+
+  enum class Result {
+    CannotOpenFile,
+    BadImage,
+    UnsupportedVersion,
+    Success
+  };
+
+  static void Encode(SaveState const& save_state, std::vector<u8>& output);
+
+  static auto Open(
+    fs::path const& path,
+    std::unique_ptr<SaveStateFile>& file
+  ) -> Result;
+
+  // Like Open(), but for an encoded state in memory, e.g. one that is embedded in another file.
+  static auto Open(
+    std::vector<u8>&& data,
+    std::unique_ptr<SaveStateFile>& file
+  ) -> Result;
+
+  // The version of the state stored in the file, which may be older than SaveState::kCurrentVersion.
+  auto GetVersion() const -> u32 { return version; }
+
+  /**
+   * Decodes a single section into the corresponding part of `save_state`.
+   * Returns BadImage if the section is missing, malformed or fails the checksum test.
+   */
+  auto Decode(Section section, SaveState& save_state) const -> Result;
+
+  // Decodes all sections. The decoded state always has the current version.
+  auto DecodeAll(SaveState& save_state) const -> Result;
+
+private:
+  struct SectionEntry {
+    bool present = false;
+    bool compressed = false;
+    u32 size = 0;
+    u32 stored_size = 0;
+    u32 offset = 0;
+    u32 checksum = 0;
+  };
+
+  SaveStateFile() = default;
+
+  static auto Open(
+    std::unique_ptr<SaveStateFile> state_file,
+    std::unique_ptr<SaveStateFile>& file
+  ) -> Result;
+
+  auto ParseSectionTable() -> Result;
+  auto ReadSection(Section section, std::vector<u8>& output) const -> Result;
+  void ReadRawSection(Section section, std::vector<u8>& output) const;
+
+  // Reads a section as it is stored, i.e. before it is upgraded to the current version.
+  auto ReadStoredSection(Section section, std::vector<u8>& output) const -> Result;
+
+  std::unique_ptr<MappedFile> mapped_file;
+  std::vector<u8> buffer;
+  u8 const* image = nullptr;
+  size_t image_size = 0;
+  u32 version = 0;
+  bool raw_image = false;
+  SectionEntry sections[(int)Section::Count];
+};
+
+} // namespace nba
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <nba/integer.hpp>
+#include <stddef.h>
+
+namespace nba {
+
+/**
+ * Layout of the shared memory used to pass frames and input between the emulator and
+ * other processes. The emulator publishes each frame into a ring of slots, every slot is
+ * guarded by a sequence lock, so that readers can use the pixels in place and detect
+ * when a slot has been overwritten. The consumer writes the pressed keys into the header.
+ */
+struct SharedFrameBuffer {
+  static constexpr u32 kMagicNumber = 0x4D53424E; // NBSM
+  static constexpr u32 kVersion = 1;
+  static constexpr int kWidth = 240;
+  static constexpr int kHeight = 160;
+
+  struct Header {
+    u32 magic;
+    u32 version;
+    u32 slot_count;
+    u32 slot_size;
+
+    // Number of the most recent frame (starting at 1), zero if no frame was published yet.
+    alignas(64) std::atomic<u64> latest_frame;
+
+    // Lower 32 bits of latest_frame, readers wait on this word.
+    std::atomic<u32> frame_signal;
+
+    // Number of readers that are waiting, so that the emulator only wakes readers when needed.
+    std::atomic<u32> waiting_readers;
+
+    // Written by the consumer, bit n is set if InputDevice::Key n is pressed.
+    alignas(64) std::atomic<u32> keys;
+  };
+
+  struct Slot {
+    // Odd while the slot is written.
+    std::atomic<u32> sequence;
+    u32 reserved;
+    u64 frame;
+
+    // std::chrono::steady_clock time of publication in nanoseconds.
+    u64 publish_time;
+
+    alignas(64) u32 pixels[kWidth * kHeight];
+  };
+
+  static_assert(std::atomic<u32>::is_always_lock_free && std::atomic<u64>::is_always_lock_free,
+    "SharedFrameBuffer: atomics must be lock-free to be shared between processes.");
+
+  static constexpr auto GetSize(int slot_count) -> size_t {
+    return sizeof(Header) + slot_count * sizeof(Slot);
+  }
+
+  static auto GetSlot(Header* header, u64 frame) -> Slot* {
+    return (Slot*)((u8*)header + sizeof(Header)) + frame % header->slot_count;
+  }
+
+  /**
+   * Blocks while `word` equals `expected`, for at most `timeout_us` microseconds.
+   * Uses a futex on Linux and falls back to sleeping on other systems, so spurious returns are possible.
+   */
+  static void Wait(std::atomic<u32>& word, u32 expected, int timeout_us);
+
+  // Wakes all processes that wait on `word`.
+  static void Wake(std::atomic<u32>& word);
+};
+
+} // namespace nba
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <platform/shared_memory/frame_buffer.hpp>
+#include <platform/shared_memory/region.hpp>
+#include <string>
+
+namespace nba {
+
+/**
+ * Reads frames published by SharedMemoryTransport and writes the input, from any process.
+ *
+ *   u64 frame = 0;
+ *   while((frame = reader->WaitForFrame(frame, 100000)) != 0) {
+ *     SharedFrameReader::Frame view;
+ *     if(reader->Acquire(frame, view)) {
+ *       Consume(view.pixels);
+ *       if(!reader->Validate(view)) { ... the slot was overwritten while it was read ... }
+ *     }
+ *   }
+ */
+struct SharedFrameReader {
+  struct Frame {
+    u32 const* pixels;
+    u64 frame;
+    u64 publish_time;
+    u32 sequence;
+  };
+
+  // Returns nullptr if the region does not exist or has an unexpected layout.
+  static auto Open(std::string const& name) -> std::unique_ptr<SharedFrameReader>;
+
+  // Number of the most recent frame, zero if no frame was published yet.
+  auto GetLatestFrame() const -> u64;
+
+  /**
+   * Waits until a frame newer than `frame` is published and returns its number,
+   * or returns zero after `timeout_us` microseconds.
+   */
+  auto WaitForFrame(u64 frame, int timeout_us) -> u64;
+
+  // Returns false if the frame is being written or has already been replaced.
+  auto Acquire(u64 frame, Frame& view) const -> bool;
+
+  // Returns true if the frame was not overwritten since it was acquired.
+  auto Validate(Frame const& view) const -> bool;
+
+  // Bit n is set if InputDevice::Key n is pressed.
+  void SetKeys(u16 keys);
+
+private:
+  SharedFrameReader() = default;
+
+  std::unique_ptr<SharedMemoryRegion> region;
+  SharedFrameBuffer::Header* header = nullptr;
+};
+
+} // namespace nba
@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <nba/integer.hpp>
+#include <string>
+
+namespace nba {
+
+// A named POSIX shared memory object, mapped read-write.
+struct SharedMemoryRegion {
+ ~SharedMemoryRegion();
+
+  /**
+   * Creates the object, replacing a stale object of the same name. The object is removed
+   * again when the region is destroyed. Returns nullptr on failure.
+   */
+  static auto Create(std::string const& name, size_t size) -> std::unique_ptr<SharedMemoryRegion>;
+
+  // Maps an existing object. Returns nullptr on failure.
+  static auto Open(std::string const& name) -> std::unique_ptr<SharedMemoryRegion>;
+
+  auto Data() const -> void* { return data; }
+  auto Size() const -> size_t { return size; }
+
+private:
+  SharedMemoryRegion() = default;
+
+  std::string name;
+  void* data = nullptr;
+  size_t size = 0;
+  bool owner = false;
+};
+
+} // namespace nba
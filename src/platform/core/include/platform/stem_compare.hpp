@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <nba/integer.hpp>
+#include <nba/stem_capture.hpp>
+
+namespace fs = std::filesystem;
+
+namespace nba {
+
+struct StemComparison {
+  struct Stem {
+    double rms_difference = 0;
+    double peak_difference = 0;
+    u64 peak_frame = 0;
+  } stems[StemCapture::kStemCount];
+
+  u64 frame_count = 0;
+  u64 golden_dropped_frames = 0;
+  u64 actual_dropped_frames = 0;
+  bool length_mismatch = false;
+  bool sample_rate_mismatch = false;
+
+  /**
+   * True if the captures match within `tolerance` (the largest allowed peak difference).
+   * A capture that dropped frames never matches, since its frames are no longer aligned to the other capture.
+   */
+  bool Matches(double tolerance) const {
+    if(golden_dropped_frames != 0 || actual_dropped_frames != 0 || length_mismatch || sample_rate_mismatch) {
+      return false;
+    }
+
+    for(auto& stem : stems) {
+      if(stem.peak_difference > tolerance) return false;
+    }
+
+    return true;
+  }
+};
+
+/**
+ * Compares two stem captures (see StemWriter) against each other,
+ * e.g. a golden capture against the output of the current build.
+ * The files are streamed in blocks, so captures of any length can be compared.
+ */
+struct StemComparator {
+  enum class Result {
+    CannotOpenFile,
+    BadImage,
+    Success
+  };
+
+  static auto Compare(
+    fs::path const& golden_path,
+    fs::path const& actual_path,
+    StemComparison& comparison,
+    int block_size = 4096
+  ) -> Result;
+};
+
+} // namespace nba
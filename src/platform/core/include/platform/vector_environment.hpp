@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <nba/core.hpp>
+#include <optional>
+#include <platform/batch_runner.hpp>
+#include <platform/movie.hpp>
+#include <vector>
+
+namespace nba {
+
+/**
+ * Steps a batch of cores with one call, for reinforcement learning.
+ * All outputs are written into caller-provided arrays with the instance as the outermost dimension,
+ * so that they can be used as tensors without further copies.
+ */
+struct VectorEnvironment {
+  static constexpr int kFrameWidth = 240;
+  static constexpr int kFrameHeight = 160;
+  static constexpr int kFrameSize = kFrameWidth * kFrameHeight;
+
+  // A value of 1, 2 or 4 bytes read by guest address (see CoreBase::Gather()).
+  using Observation = CoreBase::MemoryRead;
+
+  // An instance is done once (value & mask) == expected.
+  struct DoneCondition {
+    Observation value;
+    u32 mask;
+    u32 expected;
+  };
+
+  struct Options {
+    int frame_skip = 4;
+    int thread_count = 0;
+
+    // Instances that are done are restored to the initial state at the beginning of the next step.
+    bool auto_reset = true;
+
+    std::vector<Observation> observations;
+    std::optional<DoneCondition> done_condition;
+
+    // Copied for every instance, the audio, input and video devices are replaced.
+    std::shared_ptr<Config> config;
+  };
+
+  /**
+   * Creates `count` instances, which start from the current state of `core`.
+   * Throws std::runtime_error if an observation does not have a size of 1, 2 or 4 bytes.
+   */
+  VectorEnvironment(CoreBase& core, int count, Options const& options);
+
+  /**
+   * Runs every instance for `frame_skip` frames with the given keys pressed.
+   * Any output pointer may be null, if the output is not needed.
+   *   keys:         [count], bit n is set if InputDevice::Key n is pressed
+   *   frames:       [count][kFrameHeight][kFrameWidth], the last frame in ARGB8888
+   *   observations: [count][observation count]
+   *   dones:        [count], 1 if the done condition is met, otherwise 0
+   */
+  void Step(u16 const* keys, u32* frames, u32* observations, u8* dones);
+
+  // Restores every instance to the initial state.
+  void Reset();
+
+  auto GetCount() const -> int { return (int)instances.size(); }
+  auto GetCore(int index) -> CoreBase& { return runner.GetCore(index); }
+  auto GetObservationCount() const -> int { return (int)options.observations.size(); }
+
+private:
+  struct FrameCaptureDevice : VideoDevice {
+    void Draw(u32* buffer) final;
+
+    u32* target = nullptr;
+  };
+
+  struct Instance {
+    std::shared_ptr<MovieInputDevice> input;
+    std::shared_ptr<FrameCaptureDevice> video;
+    bool done = false;
+  };
+
+  Options options;
+  BatchRunner runner;
+  std::vector<Instance> instances;
+
+  // The observations followed by the value of the done condition.
+  std::vector<Observation> reads;
+  std::vector<u32> values;
+
+  std::unique_ptr<SnapshotData> initial_state;
+};
+
+} // namespace nba
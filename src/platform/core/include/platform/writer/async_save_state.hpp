@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <nba/core.hpp>
+#include <platform/writer/save_state.hpp>
+#include <thread>
+#include <vector>
+
+namespace nba {
+
+/**
+ * Writes save states to disk on a background thread.
+ *
+ * Only capturing the state (a copy into a pooled buffer) happens on the calling thread,
+ * so that saving a state does not stall emulation, even if the disk is slow.
+ * Save states are written in the order in which they were captured.
+ */
+struct AsyncSaveStateWriter {
+  using Result = SaveStateWriter::Result;
+
+  // Called on the I/O thread once the save state was written or writing has failed.
+  using Callback = std::function<void(fs::path const& path, Result result)>;
+
+  AsyncSaveStateWriter();
+ ~AsyncSaveStateWriter();
+
+  /**
+   * Captures the state of the core and queues it for writing.
+   * The core must not be running concurrently, i.e. call this from the
+   * emulator thread (see EmulatorThread::Invoke()) or while it is stopped.
+   */
+  void Write(CoreBase& core, fs::path const& path, Callback callback = nullptr);
+
+  // Blocks until all queued save states have been written.
+  void Flush();
+
+private:
+  struct Job {
+    std::unique_ptr<SaveState> save_state;
+    fs::path path;
+    Callback callback;
+  };
+
+  void WorkerThread();
+
+  std::deque<Job> jobs;
+  std::vector<std::unique_ptr<SaveState>> free_buffers;
+  bool busy = false;
+  bool quit = false;
+
+  std::thread thread;
+  std::mutex mutex;
+  std::condition_variable cv_work;
+  std::condition_variable cv_idle;
+};
+
+} // namespace nba
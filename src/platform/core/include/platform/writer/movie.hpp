@@ -0,0 +1,30 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <platform/movie.hpp>
+
+namespace fs = std::filesystem;
+
+namespace nba {
+
+struct MovieWriter {
+  enum class Result {
+    CannotOpenFile,
+    CannotWrite,
+    Success
+  };
+
+  static auto Write(
+    Movie const& movie,
+    fs::path const& path
+  ) -> Result;
+};
+
+} // namespace nba
@@ -19,6 +19,7 @@ struct SaveStateWriter {
   enum class Result {
     CannotOpenFile,
     CannotWrite,
+    CannotReplaceFile,
     Success
   };
 
@@ -26,6 +27,16 @@ struct SaveStateWriter {
     std::unique_ptr<CoreBase>& core,
     fs::path const& path
   ) -> Result;
+
+  /**
+   * Writes a previously captured state. The state is written to a temporary file first,
+   * which then replaces the destination file. This way an existing save state is never
+   * left in a partially written state, even if writing fails.
+   */
+  static auto Write(
+    SaveState const& save_state,
+    fs::path const& path
+  ) -> Result;
 };
 
 } // namespace nba
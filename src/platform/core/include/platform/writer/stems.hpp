@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+#include <nba/stem_capture.hpp>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace nba {
+
+/**
+ * Writes the audio stems of a StemCapture to a file.
+ *
+ * File layout: a 20-byte header (magic, version, stem count, number of dropped frames as u64),
+ * followed by blocks of frames that were captured at the same sample rate.
+ * Each block starts with its sample rate and frame count (both u32), followed by
+ * the frames as interleaved 32-bit float samples (one per stem).
+ */
+struct StemWriter {
+  static constexpr u32 kMagicNumber = 0x5453424E; // NBST
+  static constexpr u32 kCurrentVersion = 2;
+  static constexpr int kHeaderSize = 20;
+
+  enum class Result {
+    CannotOpenFile,
+    CannotWrite,
+    Success
+  };
+
+  auto Open(fs::path const& path) -> Result;
+  auto Drain(StemCapture& capture) -> Result;
+  auto Close() -> Result;
+
+private:
+  auto WriteHeader() -> Result;
+  void WriteBlock(int sample_rate, size_t begin, size_t end);
+
+  std::ofstream file_stream;
+  std::vector<StemCapture::Frame> frames;
+  std::vector<int> sample_rates;
+  u64 dropped_frames = 0;
+};
+
+} // namespace nba
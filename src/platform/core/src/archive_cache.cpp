@@ -0,0 +1,351 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <algorithm>
+#include <fmt/format.h>
+#include <fstream>
+#include <nba/common/atomic_write.hpp>
+#include <nba/common/crc32.hpp>
+#include <nba/log.hpp>
+#include <platform/archive_cache.hpp>
+#include <platform/loader/rom.hpp>
+#include <set>
+#include <utility>
+
+namespace nba {
+
+ArchiveCache::ArchiveCache(fs::path const& directory, u64 size_limit) : directory(directory), size_limit(size_limit) {
+  std::error_code error;
+
+  fs::create_directories(directory, error);
+
+  if(error) {
+    Log<Warn>("ArchiveCache: failed to create the cache directory: {}", directory.string());
+  }
+
+  ReadIndex();
+}
+
+ArchiveCache::~ArchiveCache() {
+  {
+    std::lock_guard lock{prefetch_mutex};
+    prefetch_stop = true;
+  }
+
+  prefetch_cv.notify_one();
+
+  if(prefetch_thread.joinable()) {
+    prefetch_thread.join();
+  }
+}
+
+auto ArchiveCache::Get(fs::path const& archive_path, fs::path& rom_path, std::string const& entry_name) -> Result {
+  ArchiveInfo info;
+
+  if(!GetArchiveInfo(archive_path, info)) {
+    return Result::Failed;
+  }
+
+  std::error_code error;
+
+  {
+    std::lock_guard lock{mutex};
+
+    auto directory_lock = LockDirectory();
+
+    if(!directory_lock) {
+      return Result::Failed;
+    }
+
+    ReadIndex();
+
+    if(auto entry = Find(info, entry_name); entry) {
+      auto path = GetROMPath(*entry);
+
+      // The extracted file may have been deleted by something other than the cache.
+      if(fs::exists(path, error)) {
+        entry->last_used = ++use_counter;
+        WriteIndex();
+        rom_path = std::move(path);
+        return Result::Success;
+      }
+    }
+  }
+
+  // Extract without holding the locks, so that other archives can be looked up in the meantime.
+  auto rom = std::vector<u8>{};
+  auto extracted_entry_name = entry_name;
+
+  switch(ROMLoader::ReadFileFromArchive(archive_path, rom, &extracted_entry_name)) {
+    case ROMLoader::Result::Success:  break;
+    case ROMLoader::Result::BadImage: return Result::NoROM;
+    default: return Result::NotAnArchive;
+  }
+
+  auto entry = Entry{
+    info.path,
+    entry_name,
+    info.write_time,
+    info.size,
+    crc32(rom.data(), rom.size()),
+    (u32)rom.size(),
+    0
+  };
+
+  auto path = GetROMPath(entry);
+
+  std::lock_guard lock{mutex};
+
+  auto directory_lock = LockDirectory();
+
+  if(!directory_lock) {
+    return Result::Failed;
+  }
+
+  // Another process may have changed the index while the archive was extracted.
+  ReadIndex();
+
+  // Archives containing the same ROM share the extracted file, which only has to be written once.
+  if(!fs::exists(path, error)) {
+    if(WriteFileAtomic(path, rom.data(), rom.size()) != WriteFileResult::Success) {
+      Log<Warn>("ArchiveCache: failed to write the extracted ROM: {}", path.string());
+      return Result::Failed;
+    }
+  }
+
+  // Drop the entry for an older version of the archive, its file is deleted by Evict() if unused.
+  entries.erase(std::remove_if(entries.begin(), entries.end(), [&](Entry const& other) {
+    return other.archive_path == info.path && (other.entry_name == entry_name ||
+      other.archive_write_time != info.write_time || other.archive_size != info.size);
+  }), entries.end());
+
+  entry.last_used = ++use_counter;
+  entries.push_back(std::move(entry));
+  Evict();
+  WriteIndex();
+  rom_path = std::move(path);
+  return Result::Success;
+}
+
+void ArchiveCache::Prefetch(std::vector<fs::path> const& archive_paths) {
+  {
+    std::lock_guard lock{prefetch_mutex};
+
+    prefetch_queue.insert(prefetch_queue.end(), archive_paths.begin(), archive_paths.end());
+
+    if(!prefetch_thread.joinable()) {
+      prefetch_thread = std::thread{[this]() { RunPrefetchThread(); }};
+    }
+  }
+
+  prefetch_cv.notify_one();
+}
+
+auto ArchiveCache::GetArchiveInfo(fs::path const& archive_path, ArchiveInfo& info) -> bool {
+  std::error_code error;
+
+  const auto path = fs::canonical(archive_path, error);
+  if(error) return false;
+
+  const auto write_time = fs::last_write_time(path, error);
+  if(error) return false;
+
+  const auto size = fs::file_size(path, error);
+  if(error) return false;
+
+  info.path = path.u8string();
+  info.write_time = (u64)write_time.time_since_epoch().count();
+  info.size = (u64)size;
+  return true;
+}
+
+auto ArchiveCache::GetROMPath(Entry const& entry) const -> fs::path {
+  return directory / fmt::format("{:08X}-{}.gba", entry.rom_crc32, entry.rom_size);
+}
+
+auto ArchiveCache::LockDirectory() const -> std::unique_ptr<FileLock> {
+  auto lock = FileLock::Acquire(directory / "index.lock");
+
+  if(!lock) {
+    Log<Warn>("ArchiveCache: failed to lock the cache directory: {}", directory.string());
+  }
+
+  return lock;
+}
+
+auto ArchiveCache::Find(ArchiveInfo const& info, std::string const& entry_name) -> Entry* {
+  for(auto& entry : entries) {
+    if(entry.archive_path == info.path && entry.entry_name == entry_name &&
+        entry.archive_write_time == info.write_time && entry.archive_size == info.size) {
+      return &entry;
+    }
+  }
+
+  return nullptr;
+}
+
+void ArchiveCache::Evict() {
+  // Keep the most recently used ROMs that fit into the size limit. The most recently used ROM is
+  // always kept, even if it exceeds the limit on its own, since it is about to be loaded.
+  std::sort(entries.begin(), entries.end(), [](Entry const& a, Entry const& b) {
+    return a.last_used > b.last_used;
+  });
+
+  auto kept_entries = std::vector<Entry>{};
+  auto kept_files = std::set<fs::path>{};
+  u64 total_size = 0;
+
+  for(auto& entry : entries) {
+    auto path = GetROMPath(entry);
+
+    if(kept_files.count(path) == 0) {
+      if(!kept_entries.empty() && total_size + entry.rom_size > size_limit) {
+        continue;
+      }
+
+      kept_files.insert(path);
+      total_size += entry.rom_size;
+    }
+
+    kept_entries.push_back(std::move(entry));
+  }
+
+  entries = std::move(kept_entries);
+
+  /* Delete every extracted ROM that is no longer referenced, including ones left over from a crash,
+   * and temporary files of writes that were interrupted by a crash. This is only safe because the
+   * index has just been read and every process writes to the directory while holding the lock.
+   */
+  std::error_code error;
+
+  for(auto& file : fs::directory_iterator{directory, error}) {
+    auto const& path = file.path();
+
+    if((path.extension() == ".gba" && kept_files.count(path) == 0) || IsAtomicWriteTemporaryFile(path)) {
+      std::error_code remove_error;
+      fs::remove(path, remove_error);
+    }
+  }
+}
+
+void ArchiveCache::ReadIndex() {
+  const auto path = directory / "index.bin";
+
+  auto file = std::ifstream{path, std::ios::binary};
+
+  if(!file.good()) {
+    return;
+  }
+
+  const auto read = [&](auto& value) {
+    file.read((char*)&value, sizeof(value));
+  };
+
+  const auto read_string = [&](std::string& string) {
+    u32 length = 0;
+    read(length);
+    if(!file.good() || length > 4096) {
+      file.setstate(std::ios::failbit);
+      return;
+    }
+    string.resize(length);
+    file.read(string.data(), length);
+  };
+
+  u32 header[3];
+
+  file.read((char*)header, sizeof(header));
+
+  if(!file.good() || header[0] != kMagicNumber || header[1] != kFormatVersion) {
+    Log<Warn>("ArchiveCache: ignoring invalid index file: {}", path.string());
+    return;
+  }
+
+  // The index on disk replaces the entries in memory, it holds the changes made by all processes.
+  auto entries = std::vector<Entry>{};
+
+  for(u32 i = 0; i < header[2]; i++) {
+    Entry entry;
+
+    read_string(entry.archive_path);
+    read_string(entry.entry_name);
+    read(entry.archive_write_time);
+    read(entry.archive_size);
+    read(entry.rom_crc32);
+    read(entry.rom_size);
+    read(entry.last_used);
+
+    if(!file.good()) {
+      Log<Warn>("ArchiveCache: failed to read the index file: {}", path.string());
+      return;
+    }
+
+    use_counter = std::max(use_counter, entry.last_used);
+    entries.push_back(std::move(entry));
+  }
+
+  this->entries = std::move(entries);
+}
+
+void ArchiveCache::WriteIndex() {
+  const auto path = directory / "index.bin";
+
+  auto data = std::vector<u8>{};
+
+  const auto write = [&](auto const& value) {
+    auto bytes = (u8 const*)&value;
+    data.insert(data.end(), bytes, bytes + sizeof(value));
+  };
+
+  const auto write_string = [&](std::string const& string) {
+    write((u32)string.size());
+    data.insert(data.end(), string.begin(), string.end());
+  };
+
+  write(kMagicNumber);
+  write(kFormatVersion);
+  write((u32)entries.size());
+
+  for(auto& entry : entries) {
+    write_string(entry.archive_path);
+    write_string(entry.entry_name);
+    write(entry.archive_write_time);
+    write(entry.archive_size);
+    write(entry.rom_crc32);
+    write(entry.rom_size);
+    write(entry.last_used);
+  }
+
+  if(WriteFileAtomic(path, data.data(), data.size()) != WriteFileResult::Success) {
+    Log<Warn>("ArchiveCache: failed to write the index file: {}", path.string());
+  }
+}
+
+void ArchiveCache::RunPrefetchThread() {
+  while(true) {
+    auto archive_path = fs::path{};
+
+    {
+      std::unique_lock lock{prefetch_mutex};
+
+      prefetch_cv.wait(lock, [this]() { return prefetch_stop || !prefetch_queue.empty(); });
+
+      if(prefetch_stop) {
+        return;
+      }
+
+      archive_path = std::move(prefetch_queue.front());
+      prefetch_queue.pop_front();
+    }
+
+    auto rom_path = fs::path{};
+
+    Get(archive_path, rom_path);
+  }
+}
+
+} // namespace nba
@@ -0,0 +1,306 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <platform/batch_runner.hpp>
+
+#ifdef _WIN32
+  #define WIN32_LEAN_AND_MEAN
+  #include <windows.h>
+#elif defined(__linux__)
+  #include <pthread.h>
+  #include <sched.h>
+#endif
+
+namespace nba {
+
+// Pinning is not supported on macOS, where the scheduler only accepts affinity hints.
+static void PinThread(std::thread& thread, int cpu) {
+#ifdef _WIN32
+  SetThreadAffinityMask((HANDLE)thread.native_handle(), (DWORD_PTR)1 << (cpu % 64));
+#elif defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+#else
+  (void)thread;
+  (void)cpu;
+#endif
+}
+
+BatchRunner::BatchRunner(int thread_count, bool pin_threads) {
+  const int cpu_count = std::max((int)std::thread::hardware_concurrency(), 1);
+
+  if(thread_count <= 0) {
+    thread_count = cpu_count;
+  }
+
+  // All workers must exist before the first thread starts looking for jobs to steal.
+  for(int i = 0; i < thread_count; i++) {
+    workers.push_back(std::make_unique<Worker>());
+  }
+
+  for(int i = 0; i < thread_count; i++) {
+    workers[i]->thread = std::thread{&BatchRunner::WorkerMain, this, i};
+
+    if(pin_threads) {
+      PinThread(workers[i]->thread, i % cpu_count);
+    }
+  }
+}
+
+BatchRunner::~BatchRunner() {
+  {
+    std::lock_guard lock{batch_mutex};
+    quit = true;
+  }
+
+  batch_start.notify_all();
+
+  for(auto& worker : workers) {
+    worker->thread.join();
+  }
+}
+
+auto BatchRunner::Add(std::unique_ptr<CoreBase> core) -> int {
+  auto instance = std::make_unique<Instance>();
+
+  instance->core = std::move(core);
+  instance->latencies.reserve(kLatencySampleCount);
+  instances.push_back(std::move(instance));
+  return (int)instances.size() - 1;
+}
+
+void BatchRunner::AddClones(CoreBase& core, int count) {
+  for(int i = 0; i < count; i++) {
+    Add(core.Clone());
+  }
+}
+
+void BatchRunner::RunFrames(int count) {
+  Run(0, count);
+}
+
+void BatchRunner::RunCycles(int cycles, int count) {
+  Run(std::max(cycles, 1), count);
+}
+
+void BatchRunner::Run(int cycles, int count) {
+  if(instances.empty() || count <= 0) {
+    return;
+  }
+
+  const auto t0 = std::chrono::steady_clock::now();
+
+  slice_cycles = cycles;
+
+  for(size_t i = 0; i < instances.size(); i++) {
+    auto& worker = *workers[i % workers.size()];
+
+    std::lock_guard lock{worker.mutex};
+    worker.jobs.push_back({(int)i, count});
+  }
+
+  queued_jobs = (int)instances.size();
+  pending_jobs = (int)instances.size();
+
+  {
+    std::unique_lock lock{batch_mutex};
+
+    batch_id++;
+    busy_workers = (int)workers.size();
+    batch_start.notify_all();
+    batch_done.wait(lock, [&] { return busy_workers == 0; });
+  }
+
+  run_time += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+void BatchRunner::WorkerMain(int id) {
+  u64 last_batch_id = 0;
+
+  while(true) {
+    {
+      std::unique_lock lock{batch_mutex};
+
+      batch_start.wait(lock, [&] { return quit || batch_id != last_batch_id; });
+
+      if(quit) {
+        return;
+      }
+
+      last_batch_id = batch_id;
+    }
+
+    /**
+     * Jobs are put back into the queue after every slice, so that they can be stolen
+     * while the worker is busy. Keep looking for work until all jobs are done,
+     * since a job that is currently running on another worker may still become available.
+     */
+    while(pending_jobs > 0) {
+      Job job;
+
+      if(!PopJob(id, job)) {
+        WaitForJob();
+        continue;
+      }
+
+      RunSlice(*instances[job.instance]);
+
+      if(--job.slices > 0) {
+        auto& worker = *workers[id];
+
+        {
+          std::lock_guard lock{worker.mutex};
+          worker.jobs.push_front(job);
+          queued_jobs++;
+        }
+
+        NotifyJobQueued();
+      } else if(--pending_jobs == 0) {
+        NotifyBatchDone();
+      }
+    }
+
+    {
+      std::lock_guard lock{batch_mutex};
+
+      if(--busy_workers == 0) {
+        batch_done.notify_one();
+      }
+    }
+  }
+}
+
+auto BatchRunner::PopJob(int id, Job& job) -> bool {
+  const int worker_count = (int)workers.size();
+
+  // Take the most recently run job from the own queue, it is most likely still in the cache.
+  {
+    auto& worker = *workers[id];
+
+    std::lock_guard lock{worker.mutex};
+
+    if(!worker.jobs.empty()) {
+      job = worker.jobs.front();
+      worker.jobs.pop_front();
+      queued_jobs--;
+      return true;
+    }
+  }
+
+  for(int i = 1; i < worker_count; i++) {
+    auto& victim = *workers[(id + i) % worker_count];
+
+    std::lock_guard lock{victim.mutex};
+
+    if(!victim.jobs.empty()) {
+      job = victim.jobs.back();
+      victim.jobs.pop_back();
+      queued_jobs--;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void BatchRunner::WaitForJob() {
+  std::unique_lock lock{idle_mutex};
+
+  idle_workers++;
+  job_available.wait(lock, [&] { return queued_jobs > 0 || pending_jobs == 0; });
+  idle_workers--;
+}
+
+void BatchRunner::NotifyJobQueued() {
+  /**
+   * Most of the time no worker is idle, so the mutex is only taken if one is waiting.
+   * The job is counted before idle_workers is read and an idle worker is counted before it reads
+   * queued_jobs, so either the worker sees the job or the job is announced to the worker.
+   */
+  if(idle_workers > 0) {
+    { std::lock_guard lock{idle_mutex}; }
+    job_available.notify_one();
+  }
+}
+
+void BatchRunner::NotifyBatchDone() {
+  { std::lock_guard lock{idle_mutex}; }
+  job_available.notify_all();
+}
+
+void BatchRunner::RunSlice(Instance& instance) {
+  const auto t0 = std::chrono::steady_clock::now();
+
+  if(slice_cycles == 0) {
+    instance.core->RunForOneFrame();
+    instance.cycles += CoreBase::kCyclesPerFrame;
+  } else {
+    instance.core->Run(slice_cycles);
+    instance.cycles += slice_cycles;
+  }
+
+  const float latency = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - t0).count();
+
+  if(instance.latencies.size() < kLatencySampleCount) {
+    instance.latencies.push_back(latency);
+  } else {
+    instance.latencies[instance.latency_index] = latency;
+  }
+
+  instance.latency_index = (instance.latency_index + 1) % kLatencySampleCount;
+}
+
+auto BatchRunner::GetStatistics() const -> Statistics {
+  Statistics statistics;
+  u64 total_frames = 0;
+
+  for(auto& instance : instances) {
+    auto& result = statistics.instances.emplace_back();
+    auto latencies = instance->latencies;
+
+    result.frames = instance->cycles / CoreBase::kCyclesPerFrame;
+    total_frames += result.frames;
+
+    if(latencies.empty()) {
+      continue;
+    }
+
+    const auto percentile = [&](int p) {
+      auto nth = latencies.begin() + (latencies.size() - 1) * p / 100;
+
+      std::nth_element(latencies.begin(), nth, latencies.end());
+      return *nth;
+    };
+
+    result.latency_p50 = percentile(50);
+    result.latency_p90 = percentile(90);
+    result.latency_p99 = percentile(99);
+    result.latency_max = *std::max_element(latencies.begin(), latencies.end());
+  }
+
+  if(run_time > 0) {
+    statistics.frames_per_second = (double)total_frames / run_time;
+  }
+
+  return statistics;
+}
+
+void BatchRunner::ResetStatistics() {
+  for(auto& instance : instances) {
+    instance->cycles = 0;
+    instance->latencies.clear();
+    instance->latency_index = 0;
+  }
+
+  run_time = 0;
+}
+
+} // namespace nba
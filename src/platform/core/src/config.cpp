@@ -36,6 +36,7 @@ void PlatformConfig::Load(std::string const& path) {
       this->bios_path = toml::find_or<std::string>(general, "bios_path", "bios.bin");
       this->skip_bios = toml::find_or<toml::boolean>(general, "bios_skip", false);
       this->save_folder = toml::find_or<std::string>(general, "save_folder", "");
+      this->run_ahead_frames = toml::find_or<int>(general, "run_ahead_frames", 0);
     }
   }
 
@@ -68,6 +69,25 @@ void PlatformConfig::Load(std::string const& path) {
       this->cartridge.force_rtc = toml::find_or<toml::boolean>(cartridge, "force_rtc", false);
       this->cartridge.force_solar_sensor = toml::find_or<toml::boolean>(cartridge, "force_solar_sensor", false);
       this->cartridge.solar_sensor_level = toml::find_or<int>(cartridge, "solar_sensor_level", 156);
+
+      auto save_write_mode = toml::find_or<std::string>(cartridge, "save_write_mode", "journaled");
+
+      const std::map<std::string, Config::SaveFile::WriteMode> save_write_modes{
+        { "write_through", Config::SaveFile::WriteMode::WriteThrough },
+        { "write_back",    Config::SaveFile::WriteMode::WriteBack    },
+        { "journaled",     Config::SaveFile::WriteMode::Journaled    }
+      };
+
+      auto write_mode_match = save_write_modes.find(save_write_mode);
+
+      if(write_mode_match == save_write_modes.end()) {
+        Log<Warn>("Config: save write mode '{0}' is not valid, defaulting to journaled.", save_write_mode);
+        this->save_file.write_mode = Config::SaveFile::WriteMode::Journaled;
+      } else {
+        this->save_file.write_mode = write_mode_match->second;
+      }
+
+      this->save_file.flush_interval = toml::find_or<int>(cartridge, "save_flush_interval", 1000);
     }
   }
 
@@ -106,6 +126,17 @@ void PlatformConfig::Load(std::string const& path) {
     }
   }
 
+  if(data.contains("archive_cache")) {
+    auto archive_cache_result = toml::expect<toml::value>(data.at("archive_cache"));
+
+    if(archive_cache_result.is_ok()) {
+      auto archive_cache = archive_cache_result.unwrap();
+      this->archive_cache.enable = toml::find_or<toml::boolean>(archive_cache, "enable", true);
+      this->archive_cache.size_limit_mib = toml::find_or<int>(archive_cache, "size_limit_mib", 1024);
+      this->archive_cache.prefetch_recent = toml::find_or<toml::boolean>(archive_cache, "prefetch_recent", false);
+    }
+  }
+
   if(data.contains("audio")) {
     auto audio_result = toml::expect<toml::value>(data.at("audio"));
 
@@ -156,6 +187,7 @@ void PlatformConfig::Save(std::string const& path) {
   data["general"]["bios_path"] = this->bios_path;
   data["general"]["bios_skip"] = this->skip_bios;
   data["general"]["save_folder"] = this->save_folder;
+  data["general"]["run_ahead_frames"] = this->run_ahead_frames;
 
   // Cartridge
   std::string save_type;
@@ -173,6 +205,15 @@ void PlatformConfig::Save(std::string const& path) {
   data["cartridge"]["force_solar_sensor"] = this->cartridge.force_solar_sensor;
   data["cartridge"]["solar_sensor_level"] = this->cartridge.solar_sensor_level;
 
+  std::string save_write_mode;
+  switch(this->save_file.write_mode) {
+    case Config::SaveFile::WriteMode::WriteThrough: save_write_mode = "write_through"; break;
+    case Config::SaveFile::WriteMode::WriteBack:    save_write_mode = "write_back"; break;
+    case Config::SaveFile::WriteMode::Journaled:    save_write_mode = "journaled"; break;
+  }
+  data["cartridge"]["save_write_mode"] = save_write_mode;
+  data["cartridge"]["save_flush_interval"] = this->save_file.flush_interval;
+
   // Video
   std::string filter;
   std::string color_correction;
@@ -194,6 +235,11 @@ void PlatformConfig::Save(std::string const& path) {
   data["video"]["color_correction"] = color_correction;
   data["video"]["lcd_ghosting"] = this->video.lcd_ghosting;
 
+  // Archive cache
+  data["archive_cache"]["enable"] = this->archive_cache.enable;
+  data["archive_cache"]["size_limit_mib"] = this->archive_cache.size_limit_mib;
+  data["archive_cache"]["prefetch_recent"] = this->archive_cache.prefetch_recent;
+
   // Audio
   std::string resampler;
   switch(this->audio.interpolation) {
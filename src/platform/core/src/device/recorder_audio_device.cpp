@@ -0,0 +1,213 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <algorithm>
+#include <nba/common/punning.hpp>
+#include <nba/log.hpp>
+#include <platform/device/recorder_audio_device.hpp>
+
+namespace nba {
+
+RecorderAudioDevice::RecorderAudioDevice(
+  std::string const& path,
+  Format format,
+  int sample_rate,
+  int block_size
+)   : format(format)
+    , sample_rate(sample_rate)
+    , block_size(block_size) {
+  file.open(path, std::ios::binary | std::ios::trunc);
+
+  if(!file.good()) {
+    Log<Error>("Audio: failed to open '{}' for recording.", path);
+    finished = true;
+    return;
+  }
+
+  for(auto& block : blocks) {
+    block.samples.resize(block_size * 2);
+  }
+
+  WriteHeader();
+
+  thread = std::thread{[this]() { WriterThread(); }};
+}
+
+RecorderAudioDevice::~RecorderAudioDevice() {
+  Finish();
+}
+
+bool RecorderAudioDevice::IsGood() const {
+  return file.good();
+}
+
+void RecorderAudioDevice::Advance(int cycles) {
+  if(finished || paused || !callback) {
+    return;
+  }
+
+  cycles_total += cycles;
+
+  // Hold back a few samples, so that we never read past the samples the resampler has produced.
+  const u64 samples_target = cycles_total * sample_rate / kCyclesPerSecond;
+
+  if(samples_target <= samples_total + kLatency) {
+    return;
+  }
+
+  auto samples_to_pull = samples_target - kLatency - samples_total;
+
+  samples_total += samples_to_pull;
+
+  while(samples_to_pull > 0) {
+    auto& block = blocks[front];
+    auto length = (int)std::min<u64>(samples_to_pull, block_size - block.length);
+
+    callback(callback_userdata, &block.samples[block.length * 2], length * 2 * sizeof(s16));
+
+    block.length += length;
+    samples_to_pull -= length;
+
+    if(block.length == block_size) {
+      SubmitBlock();
+    }
+  }
+}
+
+void RecorderAudioDevice::Finish() {
+  if(finished) {
+    return;
+  }
+
+  if(blocks[front].length > 0) {
+    SubmitBlock();
+  }
+
+  mutex.lock();
+  quit = true;
+  mutex.unlock();
+  cv.notify_all();
+  thread.join();
+
+  // Now that all samples have been written, we know the final size of the data chunk.
+  if(format == Format::WAV_S16) {
+    file.seekp(0);
+    WriteHeader();
+  }
+
+  file.close();
+  finished = true;
+}
+
+auto RecorderAudioDevice::GetSampleRate() -> int {
+  return sample_rate;
+}
+
+auto RecorderAudioDevice::GetBlockSize() -> int {
+  return block_size;
+}
+
+bool RecorderAudioDevice::Open(void* userdata, Callback callback) {
+  this->callback = callback;
+  callback_userdata = userdata;
+  return true;
+}
+
+void RecorderAudioDevice::SetPause(bool value) {
+  paused = value;
+}
+
+void RecorderAudioDevice::Close() {
+  callback = nullptr;
+  callback_userdata = nullptr;
+}
+
+void RecorderAudioDevice::WriteHeader() {
+  if(format != Format::WAV_S16) {
+    return;
+  }
+
+  const u32 data_size = (u32)bytes_written;
+
+  u8 header[44];
+
+  // RIFF chunk
+  write<u32>(header,  0, 0x46464952); // 'RIFF'
+  write<u32>(header,  4, 36 + data_size);
+  write<u32>(header,  8, 0x45564157); // 'WAVE'
+
+  // Format chunk
+  write<u32>(header, 12, 0x20746D66); // 'fmt '
+  write<u32>(header, 16, 16);
+  write<u16>(header, 20, 1); // PCM
+  write<u16>(header, 22, 2); // stereo
+  write<u32>(header, 24, sample_rate);
+  write<u32>(header, 28, sample_rate * 2 * sizeof(s16));
+  write<u16>(header, 32, 2 * sizeof(s16));
+  write<u16>(header, 34, 16);
+
+  // Data chunk
+  write<u32>(header, 36, 0x61746164); // 'data'
+  write<u32>(header, 40, data_size);
+
+  file.write((char const*)header, sizeof(header));
+}
+
+void RecorderAudioDevice::WriteBlock(Block const& block) {
+  const int count = block.length * 2;
+
+  if(format == Format::RAW_F32) {
+    std::vector<float> samples(count);
+
+    for(int i = 0; i < count; i++) {
+      samples[i] = block.samples[i] / 32768.0f;
+    }
+
+    file.write((char const*)samples.data(), count * sizeof(float));
+    bytes_written += count * sizeof(float);
+  } else {
+    file.write((char const*)block.samples.data(), count * sizeof(s16));
+    bytes_written += count * sizeof(s16);
+  }
+}
+
+void RecorderAudioDevice::SubmitBlock() {
+  std::unique_lock lock{mutex};
+
+  // Wait for the writer thread to finish the back block, before we hand over the front block.
+  cv.wait(lock, [this]() { return !block_pending; });
+
+  block_pending = true;
+  front ^= 1;
+  blocks[front].length = 0;
+
+  lock.unlock();
+  cv.notify_all();
+}
+
+void RecorderAudioDevice::WriterThread() {
+  std::unique_lock lock{mutex};
+
+  while(true) {
+    cv.wait(lock, [this]() { return block_pending || quit; });
+
+    if(!block_pending) {
+      break;
+    }
+
+    auto& block = blocks[front ^ 1];
+
+    lock.unlock();
+    WriteBlock(block);
+    lock.lock();
+
+    block_pending = false;
+    cv.notify_all();
+  }
+}
+
+} // namespace nba
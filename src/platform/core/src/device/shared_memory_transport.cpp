@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <platform/device/shared_memory_transport.hpp>
+
+namespace nba {
+
+auto SharedMemoryTransport::Create(std::string const& name, int slot_count) -> std::unique_ptr<SharedMemoryTransport> {
+  // Keep at least one slot between the slot that is written and the most recent frame.
+  slot_count = std::max(slot_count, 2);
+
+  std::shared_ptr<SharedMemoryRegion> region = SharedMemoryRegion::Create(name, SharedFrameBuffer::GetSize(slot_count));
+
+  if(!region) {
+    return nullptr;
+  }
+
+  // The memory is zero-initialized, which is a valid state for all atomics and slots.
+  auto header = new(region->Data()) SharedFrameBuffer::Header{};
+
+  header->version = SharedFrameBuffer::kVersion;
+  header->slot_count = (u32)slot_count;
+  header->slot_size = sizeof(SharedFrameBuffer::Slot);
+
+  auto transport = std::unique_ptr<SharedMemoryTransport>{new SharedMemoryTransport{}};
+
+  transport->input_device = std::make_shared<SharedInputDevice>();
+  transport->input_device->header = header;
+
+  transport->video_device = std::make_shared<SharedVideoDevice>();
+  transport->video_device->header = header;
+  transport->video_device->input_device = transport->input_device;
+  transport->video_device->region = region;
+
+  // Readers check the magic number, so write it last.
+  std::atomic_thread_fence(std::memory_order_release);
+  header->magic = SharedFrameBuffer::kMagicNumber;
+
+  return transport;
+}
+
+auto SharedMemoryTransport::SharedInputDevice::Poll(Key key) -> bool {
+  return keys & (1 << (int)key);
+}
+
+void SharedMemoryTransport::SharedInputDevice::SetOnChangeCallback(std::function<void(void)> callback) {
+  on_change_callback = callback;
+}
+
+void SharedMemoryTransport::SharedInputDevice::Update() {
+  const u32 new_keys = header->keys.load(std::memory_order_acquire);
+
+  if(new_keys != keys) {
+    keys = new_keys;
+
+    if(on_change_callback) {
+      on_change_callback();
+    }
+  }
+}
+
+void SharedMemoryTransport::SharedVideoDevice::Draw(u32* buffer) {
+  const u64 frame = header->latest_frame.load(std::memory_order_relaxed) + 1;
+
+  auto slot = SharedFrameBuffer::GetSlot(header, frame);
+
+  // Sequence lock: readers discard the slot if the sequence is odd or has changed while they read it.
+  const u32 sequence = slot->sequence.load(std::memory_order_relaxed);
+
+  slot->sequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  std::memcpy(slot->pixels, buffer, sizeof(slot->pixels));
+  slot->frame = frame;
+  slot->publish_time = (u64)std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+
+  slot->sequence.store(sequence + 2, std::memory_order_release);
+
+  header->latest_frame.store(frame, std::memory_order_release);
+  header->frame_signal.store((u32)frame, std::memory_order_seq_cst);
+
+  if(header->waiting_readers.load(std::memory_order_seq_cst) != 0) {
+    SharedFrameBuffer::Wake(header->frame_signal);
+  }
+
+  input_device->Update();
+}
+
+} // namespace nba
@@ -5,6 +5,7 @@
  * Refer to the included LICENSE file.
  */
 
+#include <algorithm>
 #include <platform/emulator_thread.hpp>
 
 namespace nba {
@@ -12,7 +13,7 @@ namespace nba {
 EmulatorThread::EmulatorThread(
   std::unique_ptr<CoreBase>& core
 )   : core(core) {
-  frame_limiter.Reset(59.7275);
+  frame_limiter.Reset(kFrameRate);
 }
 
 EmulatorThread::~EmulatorThread() {
@@ -47,23 +48,46 @@ void EmulatorThread::SetPerFrameCallback(std::function<void()> callback) {
   per_frame_cb = callback;
 }
 
+void EmulatorThread::SetFrameTimingsCallback(std::function<void(FrameTimings const&)> callback) {
+  frame_timings_cb = callback;
+}
+
+int EmulatorThread::GetRunAheadFrames() const {
+  return run_ahead_frames;
+}
+
+void EmulatorThread::SetRunAheadFrames(int frames) {
+  run_ahead_frames = std::clamp(frames, 0, kMaxRunAheadFrames);
+}
+
 void EmulatorThread::Start() {
   if(!running) {
     running = true;
+
+    // The core may have been modified while the thread was stopped (e.g. a save state was loaded).
+    run_ahead_state_valid = false;
+
+    {
+      std::lock_guard lock{tasks_mutex};
+      accept_tasks = true;
+    }
+
     thread = std::thread{[this]() {
       frame_limiter.Reset();
 
       while(running.load()) {
         frame_limiter.Run([this]() {
+          RunTasks();
+
           if(!paused) {
-            per_frame_cb();
-            core->RunForOneFrame();
+            RunFrame();
           }
         }, [this](float fps) {
           if(paused) {
             fps = 0;
           }
           frame_rate_cb(fps);
+          ReportFrameTimings();
         });
       }
     }};
@@ -74,7 +98,117 @@ void EmulatorThread::Stop() {
   if(IsRunning()) {
     running = false;
     thread.join();
+
+    // Tasks which were submitted during the last frame are run on the calling thread.
+    {
+      std::lock_guard lock{tasks_mutex};
+      accept_tasks = false;
+    }
+
+    RunTasks();
   }
 }
 
+void EmulatorThread::Invoke(std::function<void()> task) {
+  {
+    std::lock_guard lock{tasks_mutex};
+
+    if(accept_tasks) {
+      tasks.push_back(std::move(task));
+      return;
+    }
+  }
+
+  task();
+}
+
+void EmulatorThread::RunTasks() {
+  std::vector<std::function<void()>> tasks_to_run;
+
+  {
+    std::lock_guard lock{tasks_mutex};
+    std::swap(tasks_to_run, tasks);
+  }
+
+  for(auto& task : tasks_to_run) {
+    task();
+  }
+}
+
+void EmulatorThread::RunFrame() {
+  const auto t0 = Clock::now();
+
+  per_frame_cb();
+
+  const int run_ahead = run_ahead_frames.load();
+
+  if(run_ahead > 0) {
+    RunFrameWithRunAhead(run_ahead);
+  } else {
+    run_ahead_state_valid = false;
+    core->RunForOneFrame();
+  }
+
+  const double frame_time = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+
+  frame_timings.frames++;
+  frame_timings.frame_time += frame_time;
+  frame_timings.frame_time_max = std::max(frame_timings.frame_time_max, frame_time);
+}
+
+/**
+ * Emulates the real frame with the video output disabled and takes a snapshot afterwards.
+ * Then `run_ahead_frames` frames are emulated speculatively with the latest input, the last of which is presented.
+ * Finally the snapshot is restored, so that the speculative frames have no lasting effect.
+ * This includes the MP2K HLE mixer, which the speculative frames advance as well.
+ * Since the same snapshot buffer is used every frame, only the memory pages which changed need to be copied.
+ */
+void EmulatorThread::RunFrameWithRunAhead(int run_ahead_frames) {
+  if(!run_ahead_state) {
+    run_ahead_state = MakeSnapshotData();
+  }
+
+  core->SetVideoOutputEnable(false);
+  core->RunForOneFrame();
+
+  const auto t0 = Clock::now();
+  core->Snapshot(run_ahead_state.get(), CoreBase::kSnapshotSize, run_ahead_state_valid);
+  const auto t1 = Clock::now();
+
+  run_ahead_state_valid = true;
+
+  core->SetAudioOutputEnable(false);
+
+  for(int i = 0; i < run_ahead_frames; i++) {
+    core->SetVideoOutputEnable(i == run_ahead_frames - 1);
+    core->RunForOneFrame();
+  }
+
+  const auto t2 = Clock::now();
+  core->Restore(run_ahead_state.get(), CoreBase::kSnapshotSize, true);
+  const auto t3 = Clock::now();
+
+  core->SetAudioOutputEnable(true);
+  core->SetVideoOutputEnable(true);
+
+  frame_timings.snapshot_time += std::chrono::duration<double, std::milli>(t1 - t0).count();
+  frame_timings.restore_time  += std::chrono::duration<double, std::milli>(t3 - t2).count();
+}
+
+void EmulatorThread::ReportFrameTimings() {
+  FrameTimings timings{};
+
+  const int frames = std::max(frame_timings.frames, 1);
+
+  timings.run_ahead_frames = run_ahead_frames;
+  timings.frame_time = (float)(frame_timings.frame_time / frames);
+  timings.frame_time_max = (float)frame_timings.frame_time_max;
+  timings.snapshot_time = (float)(frame_timings.snapshot_time / frames);
+  timings.restore_time = (float)(frame_timings.restore_time / frames);
+  timings.frame_time_budget = 1000.0f / kFrameRate;
+
+  frame_timings = {};
+  frame_timings_cb(timings);
+}
+
 } // namespace nba
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <platform/file_lock.hpp>
+
+#ifdef _WIN32
+  #define WIN32_LEAN_AND_MEAN
+  #include <windows.h>
+#else
+  #include <cerrno>
+  #include <fcntl.h>
+  #include <sys/file.h>
+  #include <unistd.h>
+#endif
+
+namespace nba {
+
+#ifdef _WIN32
+
+FileLock::~FileLock() {
+  OVERLAPPED overlapped{};
+
+  UnlockFileEx(file_handle, 0, MAXDWORD, MAXDWORD, &overlapped);
+  CloseHandle(file_handle);
+}
+
+auto FileLock::Acquire(fs::path const& path) -> std::unique_ptr<FileLock> {
+  HANDLE file_handle = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE,
+    FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+  if(file_handle == INVALID_HANDLE_VALUE) {
+    return nullptr;
+  }
+
+  OVERLAPPED overlapped{};
+
+  if(!LockFileEx(file_handle, LOCKFILE_EXCLUSIVE_LOCK, 0, MAXDWORD, MAXDWORD, &overlapped)) {
+    CloseHandle(file_handle);
+    return nullptr;
+  }
+
+  std::unique_ptr<FileLock> lock{new FileLock{}};
+
+  lock->file_handle = file_handle;
+  return lock;
+}
+
+#else
+
+FileLock::~FileLock() {
+  // Closing the file releases the lock.
+  close(fd);
+}
+
+auto FileLock::Acquire(fs::path const& path) -> std::unique_ptr<FileLock> {
+  int fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0666);
+
+  if(fd == -1) {
+    return nullptr;
+  }
+
+  while(flock(fd, LOCK_EX) != 0) {
+    if(errno != EINTR) {
+      close(fd);
+      return nullptr;
+    }
+  }
+
+  std::unique_ptr<FileLock> lock{new FileLock{}};
+
+  lock->fd = fd;
+  return lock;
+}
+
+#endif
+
+} // namespace nba
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <cstring>
+#include <platform/loader/movie.hpp>
+#include <platform/mapped_file.hpp>
+
+namespace nba {
+
+static constexpr size_t kHeaderSize = 48;
+
+template<typename T>
+static auto Read(u8 const* data, size_t offset) -> T {
+  T value;
+
+  std::memcpy(&value, &data[offset], sizeof(T));
+  return value;
+}
+
+auto MovieLoader::Load(
+  Movie& movie,
+  fs::path const& path
+) -> Result {
+  if(!fs::exists(path)) {
+    return Result::CannotFindFile;
+  }
+
+  auto file = MappedFile::Open(path);
+
+  if(!file) {
+    return Result::CannotOpenFile;
+  }
+
+  const u8* data = file->Data();
+  const size_t size = file->Size();
+
+  if(size < kHeaderSize || Read<u32>(data, 0) != Movie::kMagicNumber) {
+    return Result::BadImage;
+  }
+
+  if(Read<u32>(data, 4) != Movie::kFormatVersion) {
+    return Result::UnsupportedVersion;
+  }
+
+  const u64 frame_count = Read<u64>(data, 24);
+  const u64 checkpoint_count = Read<u32>(data, 32);
+  const u64 start_state_size = Read<u32>(data, 36);
+  const u64 start_backup_size = Read<u32>(data, 40);
+
+  // Guard against overflow in the size calculation below.
+  if(frame_count > size) {
+    return Result::BadImage;
+  }
+
+  if(size != kHeaderSize + start_state_size + start_backup_size + frame_count * sizeof(u16) + checkpoint_count * sizeof(u64) * 2) {
+    return Result::BadImage;
+  }
+
+  movie = {};
+  movie.skip_bios = Read<u32>(data, 8) & 1;
+  movie.rom_crc32 = Read<u32>(data, 12);
+  movie.rtc_seed = Read<s64>(data, 16);
+
+  size_t offset = kHeaderSize;
+
+  movie.start_state.assign(&data[offset], &data[offset + start_state_size]);
+  offset += start_state_size;
+
+  movie.start_backup.assign(&data[offset], &data[offset + start_backup_size]);
+  offset += start_backup_size;
+
+  movie.frames.resize(frame_count);
+
+  for(auto& keys : movie.frames) {
+    keys = Read<u16>(data, offset);
+    offset += sizeof(u16);
+  }
+
+  movie.checkpoints.resize(checkpoint_count);
+
+  for(auto& checkpoint : movie.checkpoints) {
+    checkpoint.frame = Read<u64>(data, offset);
+    checkpoint.state_hash = Read<u64>(data, offset + sizeof(u64));
+    offset += sizeof(u64) * 2;
+  }
+
+  return Result::Success;
+}
+
+} // namespace nba
@@ -5,16 +5,19 @@
  * Refer to the included LICENSE file.
  */
 
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
+#include <map>
+#include <mutex>
 #include <platform/loader/rom.hpp>
+#include <platform/mapped_file.hpp>
 #include <nba/rom/backup/eeprom.hpp>
 #include <nba/rom/backup/flash.hpp>
 #include <nba/rom/backup/sram.hpp>
 #include <nba/rom/header.hpp>
 #include <nba/rom/rom.hpp>
 #include <nba/log.hpp>
-#include <string_view>
 #include <utility>
 #include <unarr.h>
 
@@ -24,15 +27,19 @@ using BackupType = Config::BackupType;
 
 static constexpr size_t kMaxROMSize = 32 * 1024 * 1024; // 32 MiB
 
+std::atomic<bool> ROMLoader::map_rom_files{false};
+
 auto ROMLoader::Load(
   std::unique_ptr<CoreBase>& core,
   fs::path const& path,
   Config::BackupType backup_type,
-  GPIODeviceType force_gpio
+  GPIODeviceType force_gpio,
+  ROMAnalysisCache* analysis_cache,
+  ArchiveCache* archive_cache
 ) -> Result {
   const auto save_path = fs::path{path}.replace_extension(".sav");
 
-  return Load(core, path, save_path, backup_type, force_gpio);
+  return Load(core, path, save_path, backup_type, force_gpio, analysis_cache, archive_cache);
 }
 
 auto ROMLoader::Load(
@@ -40,28 +47,31 @@ auto ROMLoader::Load(
   fs::path const& rom_path,
   fs::path const& save_path,
   BackupType backup_type,
-  GPIODeviceType force_gpio
+  GPIODeviceType force_gpio,
+  ROMAnalysisCache* analysis_cache,
+  ArchiveCache* archive_cache
 ) -> Result {
-  auto file_data = std::vector<u8>{};
-  auto read_status = ReadFile(rom_path, file_data);
+  auto file_data = std::shared_ptr<MemorySpan const>{};
+  auto read_status = ReadFile(rom_path, file_data, archive_cache);
 
   if(read_status != Result::Success) {
     return read_status;
   }
 
-  auto size = file_data.size();
+  auto size = file_data->size;
   
   if(size < sizeof(Header) || size > kMaxROMSize) {
     return Result::BadImage;
   }
 
-  auto game_info = GetGameInfo(file_data);
+  auto game_info = GetGameInfo(*file_data);
+  auto analysis = analysis_cache ? analysis_cache->Get(*file_data) : AnalyzeROM(*file_data);
 
   if(backup_type == BackupType::Detect) {
     if(game_info.backup_type != BackupType::Detect) {
       backup_type = game_info.backup_type;
     } else {
-      backup_type = GetBackupType(file_data);
+      backup_type = analysis.backup_type;
       if(backup_type == BackupType::Detect) {
         Log<Warn>("ROMLoader: failed to detect backup type!");
         backup_type = BackupType::SRAM;
@@ -92,16 +102,23 @@ auto ROMLoader::Load(
     rom_mask = u32(RoundSizeToPowerOfTwo(size) - 1);
   }
 
-  core->Attach(ROM{
+  auto rom = ROM{
     std::move(file_data),
     std::move(backup),
     std::move(gpio),
     rom_mask
-  });
+  };
+
+  rom.SetAnalysis(analysis);
+  core->Attach(std::move(rom));
   return Result::Success;
 }
 
-auto ROMLoader::ReadFile(fs::path const& path, std::vector<u8>& file_data) -> Result {
+auto ROMLoader::ReadFile(
+  fs::path const& path,
+  std::shared_ptr<MemorySpan const>& file_data,
+  ArchiveCache* archive_cache
+) -> Result {
   if(!fs::exists(path)) {
     return Result::CannotFindFile;
   }
@@ -110,30 +127,144 @@ auto ROMLoader::ReadFile(fs::path const& path, std::vector<u8>& file_data) -> Re
     return Result::CannotOpenFile;
   }
 
-  auto archive_result = ReadFileFromArchive(path, file_data);
+  if(archive_cache) {
+    auto extracted_path = fs::path{};
+
+    switch(archive_cache->Get(path, extracted_path)) {
+      case ArchiveCache::Result::Success: {
+        file_data = OpenFile(extracted_path, true);
+        if(file_data) {
+          return Result::Success;
+        }
+        break;
+      }
+      case ArchiveCache::Result::NotAnArchive: {
+        file_data = OpenFile(path, map_rom_files);
+        if(!file_data) {
+          return Result::CannotOpenFile;
+        }
+        return Result::Success;
+      }
+      case ArchiveCache::Result::NoROM: {
+        return Result::BadImage;
+      }
+      case ArchiveCache::Result::Failed: {
+        // Decompress the archive into memory instead.
+        break;
+      }
+    }
+  }
+
+  auto archive_data = std::vector<u8>{};
+  auto archive_result = ReadFileFromArchive(path, archive_data);
 
   /* Forward result form ReadFileFromArchive() if the archive could be loaded,
    * and the GBA file was found and loaded or there was no GBA file.
    */
+  if(archive_result == Result::Success) {
+    file_data = ROM::MakeShared(std::move(archive_data));
+  }
+
   if(archive_result == Result::BadImage ||
       archive_result == Result::Success) {
     return archive_result;
   }
 
-  auto file_stream = std::ifstream{path, std::ios::binary};
+  file_data = OpenFile(path, map_rom_files);
 
-  if(!file_stream.good()) {
+  if(!file_data) {
     return Result::CannotOpenFile;
   }
+  return Result::Success;
+}
 
-  auto file_size = fs::file_size(path);
+void ROMLoader::SetMapROMFiles(bool map_rom_files) {
+  ROMLoader::map_rom_files = map_rom_files;
+}
 
-  file_data.resize(file_size);
-  file_stream.read((char*)file_data.data(), file_size);
-  return Result::Success;
+auto ROMLoader::OpenFile(fs::path const& path, bool map) -> std::shared_ptr<MemorySpan const> {
+  struct MappedROM : MemorySpan {
+    std::unique_ptr<MappedFile> file;
+  };
+
+  struct CacheEntry {
+    fs::file_time_type write_time;
+    std::uintmax_t size;
+    bool mapped;
+    std::weak_ptr<MemorySpan const> rom;
+  };
+
+  static std::mutex mutex;
+  static std::map<fs::path, CacheEntry> cache;
+
+  std::error_code error;
+
+  const auto key = fs::canonical(path, error);
+  const auto write_time = fs::last_write_time(path, error);
+  const auto size = fs::file_size(path, error);
+
+  std::lock_guard lock{mutex};
+
+  // Forget ROMs that are no longer used by any core.
+  for(auto it = cache.begin(); it != cache.end();) {
+    if(it->second.rom.expired()) {
+      it = cache.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  // A file that has been modified since it was opened is opened again.
+  if(!error) {
+    auto match = cache.find(key);
+
+    if(match != cache.end() && match->second.write_time == write_time &&
+        match->second.size == size && match->second.mapped == map) {
+      return match->second.rom.lock();
+    }
+  }
+
+  auto rom = std::shared_ptr<MemorySpan const>{};
+
+  if(map) {
+    auto file = MappedFile::Open(path);
+
+    if(!file) {
+      return {};
+    }
+
+    auto mapped_rom = std::make_shared<MappedROM>();
+
+    mapped_rom->data = file->Data();
+    mapped_rom->size = file->Size();
+    mapped_rom->file = std::move(file);
+    rom = std::move(mapped_rom);
+  } else {
+    auto file = std::ifstream{path, std::ios::binary};
+
+    if(!file.good()) {
+      return {};
+    }
+
+    // Anything beyond the maximum ROM size only has to be seen to reject the file.
+    auto data = std::vector<u8>(std::min<std::uintmax_t>(error ? 0 : size, kMaxROMSize + 1));
+
+    file.read((char*)data.data(), data.size());
+    data.resize((size_t)file.gcount());
+    rom = ROM::MakeShared(std::move(data));
+  }
+
+  if(!error) {
+    cache[key] = {write_time, size, map, rom};
+  }
+  return rom;
 }
 
-auto ROMLoader::ReadFileFromArchive(fs::path const& path, std::vector<u8>& file_data) -> Result {
+auto ROMLoader::ReadFileFromArchive(
+  fs::path const& path,
+  std::vector<u8>& file_data,
+  std::string* entry_name
+) -> Result {
   auto stream = ar_open_file(path.u8string().c_str());
 
   if(!stream) {
@@ -152,15 +283,22 @@ auto ROMLoader::ReadFileFromArchive(fs::path const& path, std::vector<u8>& file_
   }
 
   auto result = Result::BadImage;
+  const bool find_by_name = entry_name && !entry_name->empty();
 
   while(ar_parse_entry(archive)) {
     auto filename = ar_entry_get_name(archive);
     auto extension = fs::path{filename}.extension();
 
-    if(extension == ".gba" || extension == ".GBA") {
+    if(find_by_name ? *entry_name == filename : (extension == ".gba" || extension == ".GBA")) {
       auto size = ar_entry_get_size(archive);
       file_data.resize(size);
-      ar_entry_uncompress(archive, file_data.data(), size);
+      if(!ar_entry_uncompress(archive, file_data.data(), size)) {
+        file_data.clear();
+        break;
+      }
+      if(entry_name) {
+        *entry_name = filename;
+      }
       result = Result::Success;
       break;
     }
@@ -172,9 +310,9 @@ auto ROMLoader::ReadFileFromArchive(fs::path const& path, std::vector<u8>& file_
 }
 
 auto ROMLoader::GetGameInfo(
-  std::vector<u8>& file_data
+  MemorySpan const& file_data
 ) -> GameInfo {
-  auto header = reinterpret_cast<Header*>(file_data.data());
+  auto header = reinterpret_cast<Header const*>(file_data.data);
   auto game_code = std::string{};
   game_code.assign(header->game.code, 4);
 
@@ -186,32 +324,6 @@ auto ROMLoader::GetGameInfo(
   return GameInfo{};
 }
 
-auto ROMLoader::GetBackupType(
-  std::vector<u8>& file_data
-) -> BackupType {
-  static constexpr std::pair<std::string_view, BackupType> signatures[6] {
-    { "EEPROM_V",   BackupType::EEPROM_DETECT },
-    { "SRAM_V",     BackupType::SRAM },
-    { "SRAM_F_V",   BackupType::SRAM },
-    { "FLASH_V",    BackupType::FLASH_64 },
-    { "FLASH512_V", BackupType::FLASH_64 },
-    { "FLASH1M_V",  BackupType::FLASH_128 }
-  };
-
-  const auto size = file_data.size();
-
-  for(int i = 0; i < size; i += sizeof(u32)) {
-    for(auto const& [signature, type] : signatures) {
-      if((i + signature.size()) <= size &&
-          std::memcmp(&file_data[i], signature.data(), signature.size()) == 0) {
-        return type;
-      }
-    }
-  }
-
-  return BackupType::Detect;
-}
-
 auto ROMLoader::CreateBackup(
   std::unique_ptr<CoreBase>& core,
   fs::path const& save_path,
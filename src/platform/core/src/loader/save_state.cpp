@@ -6,7 +6,7 @@
  */
 
 #include <filesystem>
-#include <fstream>
+#include <memory>
 #include <platform/loader/save_state.hpp>
 
 namespace nba {
@@ -19,36 +19,41 @@ auto SaveStateLoader::Load(
     return Result::CannotFindFile;
   }
 
-  if(!fs::is_regular_file(path)) {
-    return Result::CannotOpenFile;
-  }
+  std::unique_ptr<SaveStateFile> file;
 
-  auto file_size = fs::file_size(path);
+  auto open_result = SaveStateFile::Open(path, file);
 
-  if(file_size != sizeof(SaveState)) {
-    return Result::BadImage;
+  if(open_result != SaveStateFile::Result::Success) {
+    return ConvertResult(open_result);
   }
 
-  SaveState save_state;
+  auto save_state = MakeSaveState();
 
-  std::ifstream file_stream{path.c_str(), std::ios::binary};
+  auto decode_result = file->DecodeAll(*save_state);
 
-  if(!file_stream.good()) {
-    return Result::CannotOpenFile;
+  if(decode_result != SaveStateFile::Result::Success) {
+    return ConvertResult(decode_result);
   }
 
-  file_stream.read((char*)&save_state, sizeof(SaveState));
-
-  auto validate_result = Validate(save_state);
+  auto validate_result = Validate(*save_state);
 
   if(validate_result != Result::Success) {
     return validate_result;
   }
 
-  core->LoadState(save_state);
+  core->LoadState(*save_state);
   return Result::Success;
 }
 
+auto SaveStateLoader::ConvertResult(SaveStateFile::Result result) -> Result {
+  switch(result) {
+    case SaveStateFile::Result::CannotOpenFile:     return Result::CannotOpenFile;
+    case SaveStateFile::Result::BadImage:           return Result::BadImage;
+    case SaveStateFile::Result::UnsupportedVersion: return Result::UnsupportedVersion;
+    default:                                        return Result::Success;
+  }
+}
+
 auto SaveStateLoader::Validate(SaveState const& save_state) -> Result {
   if(save_state.magic != SaveState::kMagicNumber) {
     return Result::BadImage;
@@ -0,0 +1,209 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <algorithm>
+#include <fmt/format.h>
+#include <platform/lockstep_checker.hpp>
+#include <tuple>
+
+namespace nba {
+
+// Limits the report for a single memory region or register block.
+static constexpr int kMaxDifferencesPerBlock = 8;
+
+LockstepChecker::LockstepChecker(CoreBase& core_a, CoreBase& core_b, u32 components)
+    : core_a(core_a)
+    , core_b(core_b)
+    , components(components)
+    , state_a(MakeSaveState())
+    , state_b(MakeSaveState()) {
+}
+
+bool LockstepChecker::Step(int cycles) {
+  if(diverged) {
+    return false;
+  }
+
+  core_a.Run(cycles);
+  core_b.Run(cycles);
+  step_count++;
+
+  if(components == Component::All && core_a.StateHash() == core_b.StateHash()) {
+    return true;
+  }
+
+  Compare();
+  return !diverged;
+}
+
+void LockstepChecker::Compare() {
+  auto& a = *state_a;
+  auto& b = *state_b;
+
+  core_a.CopyState(a);
+  core_b.CopyState(b);
+
+  if(!(components & Component::Scheduler)) {
+    // UIDs of scheduler events are not meaningful if the cores may schedule different events.
+    for(int i = 0; i < 4; i++) {
+      a.timer[i].event_uid = b.timer[i].event_uid = 0;
+      a.dma.channels[i].event_uid = b.dma.channels[i].event_uid = 0;
+    }
+  }
+
+  divergence.differences.clear();
+
+  if(components & Component::CPU) {
+    DiffCPU();
+  }
+
+  if(components & Component::Scheduler) {
+    DiffScheduler();
+  }
+
+  if(components & Component::Memory) {
+    DiffBytes("EWRAM", 0x02000000, a.bus.memory.wram.data(), b.bus.memory.wram.data(), a.bus.memory.wram.size());
+    DiffBytes("IWRAM", 0x03000000, a.bus.memory.iram.data(), b.bus.memory.iram.data(), a.bus.memory.iram.size());
+    DiffBytes("PRAM",  0x05000000, a.bus.memory.pram, b.bus.memory.pram, sizeof(a.bus.memory.pram));
+    DiffBytes("VRAM",  0x06000000, a.bus.memory.vram, b.bus.memory.vram, sizeof(a.bus.memory.vram));
+    DiffBytes("OAM",   0x07000000, a.bus.memory.oam,  b.bus.memory.oam,  sizeof(a.bus.memory.oam));
+  }
+
+  if(components & Component::IO) {
+    // Everything in the bus state after the memories: open bus latch, I/O registers and prefetch buffer.
+    const auto bus_offset = (u8 const*)&a.bus.memory.latch - (u8 const*)&a.bus;
+
+    DiffBytes("Bus", 0, &a.bus.memory.latch, &b.bus.memory.latch, sizeof(a.bus) - bus_offset);
+    DiffBytes("IRQ", a.irq, b.irq);
+    DiffBytes("PPU", a.ppu, b.ppu);
+    DiffBytes("Timer", a.timer, b.timer);
+    DiffBytes("DMA", a.dma, b.dma);
+    DiffBytes("KEYCNT", a.keycnt, b.keycnt);
+  }
+
+  if(components & Component::Audio) {
+    DiffBytes("APU", a.apu, b.apu);
+  }
+
+  // Should not happen, but do not report a false positive silently.
+  if(components == Component::All && divergence.differences.empty()) {
+    divergence.differences.push_back("state hashes differ, but no difference was found in the compared state");
+  }
+
+  if(!divergence.differences.empty()) {
+    diverged = true;
+    divergence.step = step_count;
+    divergence.timestamp = a.timestamp;
+  }
+}
+
+void LockstepChecker::DiffCPU() {
+  auto& regs_a = state_a->arm.regs;
+  auto& regs_b = state_b->arm.regs;
+  auto& differences = divergence.differences;
+
+  const auto diff = [&](std::string const& name, u32 value_a, u32 value_b) {
+    if(value_a != value_b) {
+      differences.push_back(fmt::format("{}: 0x{:08X} != 0x{:08X}", name, value_a, value_b));
+    }
+  };
+
+  for(int i = 0; i < 16; i++) {
+    diff(fmt::format("r{}", i), regs_a.gpr[i], regs_b.gpr[i]);
+  }
+
+  diff("cpsr", regs_a.cpsr, regs_b.cpsr);
+
+  for(int bank = 0; bank < 6; bank++) {
+    diff(fmt::format("spsr[{}]", bank), regs_a.spsr[bank], regs_b.spsr[bank]);
+
+    for(int i = 0; i < 7; i++) {
+      diff(fmt::format("bank[{}][{}]", bank, i), regs_a.bank[bank][i], regs_b.bank[bank][i]);
+    }
+  }
+
+  auto& arm_a = state_a->arm;
+  auto& arm_b = state_b->arm;
+
+  diff("pipe.opcode[0]", arm_a.pipe.opcode[0], arm_b.pipe.opcode[0]);
+  diff("pipe.opcode[1]", arm_a.pipe.opcode[1], arm_b.pipe.opcode[1]);
+  diff("pipe.access", arm_a.pipe.access, arm_b.pipe.access);
+  diff("irq_line", arm_a.irq_line, arm_b.irq_line);
+}
+
+void LockstepChecker::DiffScheduler() {
+  auto& differences = divergence.differences;
+
+  if(state_a->timestamp != state_b->timestamp) {
+    differences.push_back(fmt::format("timestamp: {} != {}", state_a->timestamp, state_b->timestamp));
+  }
+
+  using Event = std::tuple<u64, u16, u64, u64>; // key, class, user data, UID
+
+  // The order of events in the heap depends on the order in which they were scheduled.
+  const auto get_events = [](SaveState const& state) {
+    std::vector<Event> events;
+
+    for(int i = 0; i < state.scheduler.event_count; i++) {
+      auto& event = state.scheduler.events[i];
+
+      events.emplace_back(event.key, event.event_class, event.user_data, event.uid);
+    }
+
+    std::sort(events.begin(), events.end());
+    return events;
+  };
+
+  const auto events_a = get_events(*state_a);
+  const auto events_b = get_events(*state_b);
+
+  if(events_a.size() != events_b.size()) {
+    differences.push_back(fmt::format("event count: {} != {}", events_a.size(), events_b.size()));
+  }
+
+  for(size_t i = 0; i < std::min(events_a.size(), events_b.size()); i++) {
+    if(events_a[i] != events_b[i]) {
+      const auto [key_a, class_a, user_data_a, uid_a] = events_a[i];
+      const auto [key_b, class_b, user_data_b, uid_b] = events_b[i];
+
+      // The lower two bits of the key hold the priority of the event.
+      differences.push_back(fmt::format(
+        "event #{}: class {} at {} (uid {}, user data {}) != class {} at {} (uid {}, user data {})",
+        i, class_a, key_a >> 2, uid_a, user_data_a, class_b, key_b >> 2, uid_b, user_data_b));
+      break;
+    }
+  }
+
+  if(state_a->scheduler.next_uid != state_b->scheduler.next_uid) {
+    differences.push_back(fmt::format("next uid: {} != {}", state_a->scheduler.next_uid, state_b->scheduler.next_uid));
+  }
+}
+
+void LockstepChecker::DiffBytes(std::string const& name, u32 base_address, void const* data_a, void const* data_b, size_t size) {
+  auto bytes_a = (u8 const*)data_a;
+  auto bytes_b = (u8 const*)data_b;
+  auto& differences = divergence.differences;
+
+  size_t count = 0;
+
+  for(size_t i = 0; i < size; i++) {
+    if(bytes_a[i] != bytes_b[i]) {
+      if(count++ < kMaxDifferencesPerBlock) {
+        // Register blocks have no base address, their differences are reported by offset into the SaveState structure.
+        const auto location = base_address != 0 ? fmt::format("0x{:08X}", base_address + i) : fmt::format("+0x{:X}", i);
+
+        differences.push_back(fmt::format("{} {}: 0x{:02X} != 0x{:02X}", name, location, bytes_a[i], bytes_b[i]));
+      }
+    }
+  }
+
+  if(count > kMaxDifferencesPerBlock) {
+    differences.push_back(fmt::format("{}: {} bytes differ in total", name, count));
+  }
+}
+
+} // namespace nba
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <platform/mapped_file.hpp>
+
+#ifdef _WIN32
+  #define WIN32_LEAN_AND_MEAN
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace nba {
+
+#ifdef _WIN32
+
+MappedFile::~MappedFile() {
+  if(data) UnmapViewOfFile(data);
+  if(mapping_handle) CloseHandle(mapping_handle);
+  if(file_handle) CloseHandle(file_handle);
+}
+
+auto MappedFile::Open(fs::path const& path) -> std::unique_ptr<MappedFile> {
+  std::unique_ptr<MappedFile> file{new MappedFile{}};
+
+  // Allow the file to be deleted or replaced by a rename while it is mapped, like on POSIX.
+  HANDLE file_handle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+  if(file_handle == INVALID_HANDLE_VALUE) {
+    return nullptr;
+  }
+
+  file->file_handle = file_handle;
+
+  LARGE_INTEGER size;
+
+  if(!GetFileSizeEx(file_handle, &size)) {
+    return nullptr;
+  }
+
+  file->size = (size_t)size.QuadPart;
+
+  // Empty files cannot be mapped.
+  if(file->size == 0) {
+    return file;
+  }
+
+  file->mapping_handle = CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+  if(!file->mapping_handle) {
+    return nullptr;
+  }
+
+  file->data = (u8 const*)MapViewOfFile(file->mapping_handle, FILE_MAP_READ, 0, 0, 0);
+
+  if(!file->data) {
+    return nullptr;
+  }
+
+  return file;
+}
+
+#else
+
+MappedFile::~MappedFile() {
+  if(data) {
+    munmap((void*)data, size);
+  }
+}
+
+auto MappedFile::Open(fs::path const& path) -> std::unique_ptr<MappedFile> {
+  std::unique_ptr<MappedFile> file{new MappedFile{}};
+
+  int fd = open(path.c_str(), O_RDONLY);
+
+  if(fd == -1) {
+    return nullptr;
+  }
+
+  struct stat stat_buffer;
+
+  if(fstat(fd, &stat_buffer) == -1 || !S_ISREG(stat_buffer.st_mode)) {
+    close(fd);
+    return nullptr;
+  }
+
+  file->size = (size_t)stat_buffer.st_size;
+
+  // Empty files cannot be mapped.
+  if(file->size != 0) {
+    void* data = mmap(nullptr, file->size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    if(data == MAP_FAILED) {
+      close(fd);
+      return nullptr;
+    }
+
+    file->data = (u8 const*)data;
+  }
+
+  // The mapping stays valid after the file descriptor has been closed.
+  close(fd);
+  return file;
+}
+
+#endif
+
+} // namespace nba
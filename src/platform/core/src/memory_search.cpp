@@ -0,0 +1,303 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <algorithm>
+#include <bitset>
+#include <cstring>
+#include <nba/common/compiler.hpp>
+#include <platform/memory_search.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  #define MEMORY_SEARCH_SSE2
+#endif
+
+namespace nba {
+
+using Condition = MemorySearch::Condition;
+
+template<int width>
+static auto Load(u8 const* data) -> u32 {
+  u32 value = 0;
+
+  for(int i = 0; i < width; i++) {
+    value |= data[i] << (i * 8);
+  }
+  return value;
+}
+
+template<int width>
+static constexpr auto Truncate(u32 value) -> u32 {
+  return width == 4 ? value : value & ((1u << (width * 8)) - 1);
+}
+
+#ifdef MEMORY_SEARCH_SSE2
+
+template<int width>
+static auto ALWAYS_INLINE Set1(u32 value) -> __m128i {
+  if constexpr(width == 1) return _mm_set1_epi8((char)value);
+  if constexpr(width == 2) return _mm_set1_epi16((short)value);
+  if constexpr(width == 4) return _mm_set1_epi32((int)value);
+}
+
+template<int width>
+static auto ALWAYS_INLINE Add(__m128i a, __m128i b) -> __m128i {
+  if constexpr(width == 1) return _mm_add_epi8(a, b);
+  if constexpr(width == 2) return _mm_add_epi16(a, b);
+  if constexpr(width == 4) return _mm_add_epi32(a, b);
+}
+
+template<int width>
+static auto ALWAYS_INLINE CompareEqual(__m128i a, __m128i b) -> __m128i {
+  if constexpr(width == 1) return _mm_cmpeq_epi8(a, b);
+  if constexpr(width == 2) return _mm_cmpeq_epi16(a, b);
+  if constexpr(width == 4) return _mm_cmpeq_epi32(a, b);
+}
+
+// SSE2 only has signed comparisons, flipping the sign bit of both operands gives an unsigned comparison.
+template<int width>
+static auto ALWAYS_INLINE CompareGreater(__m128i a, __m128i b) -> __m128i {
+  const __m128i sign = Set1<width>(1u << (width * 8 - 1));
+
+  a = _mm_xor_si128(a, sign);
+  b = _mm_xor_si128(b, sign);
+
+  if constexpr(width == 1) return _mm_cmpgt_epi8(a, b);
+  if constexpr(width == 2) return _mm_cmpgt_epi16(a, b);
+  if constexpr(width == 4) return _mm_cmpgt_epi32(a, b);
+}
+
+template<int width>
+static auto ALWAYS_INLINE Evaluate(__m128i value, __m128i previous, Condition condition, __m128i a, __m128i b) -> __m128i {
+  const __m128i ones = _mm_set1_epi32(-1);
+
+  switch(condition) {
+    case Condition::Equal:       return CompareEqual<width>(value, a);
+    case Condition::NotEqual:    return _mm_xor_si128(CompareEqual<width>(value, a), ones);
+    case Condition::Changed:     return _mm_xor_si128(CompareEqual<width>(value, previous), ones);
+    case Condition::Unchanged:   return CompareEqual<width>(value, previous);
+    case Condition::Increased:   return CompareGreater<width>(value, previous);
+    case Condition::Decreased:   return CompareGreater<width>(previous, value);
+    case Condition::IncreasedBy: return CompareEqual<width>(value, Add<width>(previous, a));
+    case Condition::DecreasedBy: return CompareEqual<width>(value, Add<width>(previous, a));
+    case Condition::InRange: {
+      return _mm_xor_si128(_mm_or_si128(CompareGreater<width>(a, value), CompareGreater<width>(value, b)), ones);
+    }
+  }
+
+  return _mm_setzero_si128();
+}
+
+// Evaluates 16 values and returns one bit per value.
+template<int width>
+static auto ALWAYS_INLINE Compare16(u8 const* current, u8 const* previous, Condition condition, __m128i a, __m128i b) -> u32 {
+  __m128i mask[width];
+
+  for(int i = 0; i < width; i++) {
+    const __m128i value_current = _mm_loadu_si128((__m128i const*)&current[i * 16]);
+    const __m128i value_previous = _mm_loadu_si128((__m128i const*)&previous[i * 16]);
+
+    mask[i] = Evaluate<width>(value_current, value_previous, condition, a, b);
+  }
+
+  // Narrow the lane masks down to one byte per value. Saturation keeps all-ones lanes at all-ones.
+  if constexpr(width == 1) {
+    return (u32)_mm_movemask_epi8(mask[0]);
+  }
+
+  if constexpr(width == 2) {
+    return (u32)_mm_movemask_epi8(_mm_packs_epi16(mask[0], mask[1]));
+  }
+
+  if constexpr(width == 4) {
+    return (u32)_mm_movemask_epi8(_mm_packs_epi16(_mm_packs_epi32(mask[0], mask[1]), _mm_packs_epi32(mask[2], mask[3])));
+  }
+}
+
+// Evaluates 64 values and returns one bit per value.
+template<int width>
+static auto CompareWord(u8 const* current, u8 const* previous, Condition condition, u32 a, u32 b) -> u64 {
+  // Subtraction is done by adding the two's complement.
+  const __m128i vector_a = Set1<width>(condition == Condition::DecreasedBy ? 0u - a : a);
+  const __m128i vector_b = Set1<width>(b);
+
+  u64 bits = 0;
+
+  for(int i = 0; i < 4; i++) {
+    bits |= (u64)Compare16<width>(&current[i * 16 * width], &previous[i * 16 * width], condition, vector_a, vector_b) << (i * 16);
+  }
+  return bits;
+}
+
+#else
+
+template<int width>
+static auto Evaluate(u32 value, u32 previous, Condition condition, u32 a, u32 b) -> bool {
+  switch(condition) {
+    case Condition::Equal:       return value == a;
+    case Condition::NotEqual:    return value != a;
+    case Condition::Changed:     return value != previous;
+    case Condition::Unchanged:   return value == previous;
+    case Condition::Increased:   return value > previous;
+    case Condition::Decreased:   return value < previous;
+    case Condition::IncreasedBy: return value == Truncate<width>(previous + a);
+    case Condition::DecreasedBy: return value == Truncate<width>(previous - a);
+    case Condition::InRange:     return value >= a && value <= b;
+  }
+
+  return false;
+}
+
+template<int width>
+static auto CompareWord(u8 const* current, u8 const* previous, Condition condition, u32 a, u32 b) -> u64 {
+  u64 bits = 0;
+
+  for(int i = 0; i < 64; i++) {
+    if(Evaluate<width>(Load<width>(&current[i * width]), Load<width>(&previous[i * width]), condition, a, b)) {
+      bits |= 1ULL << i;
+    }
+  }
+  return bits;
+}
+
+#endif
+
+void MemorySearch::Start(CoreBase& core, Width width) {
+  const auto wram = core.GetMemorySpan(CoreBase::MemoryRegion::WRAM);
+  const auto iram = core.GetMemorySpan(CoreBase::MemoryRegion::IRAM);
+
+  this->width = width;
+
+  previous.resize(kWRAMSize + kIRAMSize);
+  std::memcpy(&previous[0], wram.data, kWRAMSize);
+  std::memcpy(&previous[kWRAMSize], iram.data, kIRAMSize);
+
+  const u32 block_count = (u32)(previous.size() / (int)width / kBlockSize);
+
+  blocks.resize(block_count);
+
+  for(u32 i = 0; i < block_count; i++) {
+    blocks[i].index = i;
+    std::fill(std::begin(blocks[i].bits), std::end(blocks[i].bits), ~0ULL);
+  }
+}
+
+void MemorySearch::Filter(CoreBase& core, Condition condition, u32 a, u32 b) {
+  using CompareFunction = u64 (*)(u8 const*, u8 const*, Condition, u32, u32);
+
+  const int size = (int)width;
+  const u32 max_value = size == 4 ? 0xFFFF'FFFF : (1u << (size * 8)) - 1;
+
+  // Operands that do not fit into the search width are clamped for range checks and truncated otherwise.
+  if(condition == Condition::InRange) {
+    if(a > max_value) {
+      blocks.clear();
+      return;
+    }
+    b = std::min(b, max_value);
+  } else {
+    a &= max_value;
+  }
+
+  CompareFunction compare;
+
+  switch(width) {
+    case Width::Byte: compare = CompareWord<1>; break;
+    case Width::Half: compare = CompareWord<2>; break;
+    default:          compare = CompareWord<4>; break;
+  }
+
+  const size_t block_bytes = kBlockSize * size;
+  const size_t word_bytes = 64 * size;
+
+  size_t kept = 0;
+
+  for(auto& block : blocks) {
+    u8 const* current = GetBlockMemory(core, block.index);
+    u8* previous_block = &previous[block.index * block_bytes];
+    u64 any = 0;
+
+    for(int i = 0; i < kBlockSize / 64; i++) {
+      if(block.bits[i] != 0) {
+        block.bits[i] &= compare(&current[i * word_bytes], &previous_block[i * word_bytes], condition, a, b);
+        any |= block.bits[i];
+      }
+    }
+
+    std::memcpy(previous_block, current, block_bytes);
+
+    if(any != 0) {
+      blocks[kept++] = block;
+    }
+  }
+
+  blocks.resize(kept);
+}
+
+auto MemorySearch::GetCandidateCount() const -> size_t {
+  size_t count = 0;
+
+  for(auto& block : blocks) {
+    for(u64 bits : block.bits) {
+      count += std::bitset<64>{bits}.count();
+    }
+  }
+  return count;
+}
+
+auto MemorySearch::GetCandidates(size_t max_count) const -> std::vector<Candidate> {
+  std::vector<Candidate> candidates;
+
+  for(auto& block : blocks) {
+    for(int i = 0; i < kBlockSize / 64; i++) {
+      const u64 bits = block.bits[i];
+
+      for(int bit = 0; bit < 64 && (bits >> bit) != 0; bit++) {
+        if(candidates.size() == max_count) {
+          return candidates;
+        }
+
+        if(bits & (1ULL << bit)) {
+          const size_t candidate = (size_t)block.index * kBlockSize + i * 64 + bit;
+          u8 const* data = &previous[candidate * (int)width];
+          u32 value;
+
+          switch(width) {
+            case Width::Byte: value = Load<1>(data); break;
+            case Width::Half: value = Load<2>(data); break;
+            default:          value = Load<4>(data); break;
+          }
+
+          candidates.push_back({GetAddress(candidate), value});
+        }
+      }
+    }
+  }
+
+  return candidates;
+}
+
+auto MemorySearch::GetBlockMemory(CoreBase& core, u32 index) const -> u8 const* {
+  const size_t offset = (size_t)index * kBlockSize * (int)width;
+
+  // Blocks never cross the end of EWRAM, since its size is a multiple of the block size.
+  if(offset < kWRAMSize) {
+    return core.GetMemorySpan(CoreBase::MemoryRegion::WRAM).data + offset;
+  }
+  return core.GetMemorySpan(CoreBase::MemoryRegion::IRAM).data + offset - kWRAMSize;
+}
+
+auto MemorySearch::GetAddress(size_t candidate) const -> u32 {
+  const size_t offset = candidate * (int)width;
+
+  if(offset < kWRAMSize) {
+    return 0x0200'0000 + (u32)offset;
+  }
+  return 0x0300'0000 + (u32)(offset - kWRAMSize);
+}
+
+} // namespace nba
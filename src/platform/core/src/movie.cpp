@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <nba/common/crc32.hpp>
+#include <platform/movie.hpp>
+#include <platform/save_state_file.hpp>
+
+namespace nba {
+
+static auto GetROMCRC32(CoreBase& core) -> u32 {
+  const auto rom = core.GetROM().GetRawROM();
+
+  return crc32(rom.data, rom.size);
+}
+
+// Replaces the contents of the backup memory through a save state, like loading a state would.
+static void LoadBackup(CoreBase& core, std::vector<u8> const& backup) {
+  auto state = MakeSaveState();
+
+  core.CopyState(*state);
+  std::memcpy(state->backup.data, backup.data(), std::min(backup.size(), sizeof(state->backup.data)));
+  core.LoadState(*state);
+}
+
+MovieRecorder::MovieRecorder(
+  CoreBase& core,
+  std::shared_ptr<Config> config,
+  MovieInputDevice& input,
+  int checkpoint_interval
+)   : core(core)
+    , config(config)
+    , input(input)
+    , checkpoint_interval(std::max(checkpoint_interval, 1)) {
+}
+
+void MovieRecorder::Start(bool from_power_on) {
+  movie = {};
+
+  if(config->rtc_seed == 0) {
+    config->rtc_seed = (s64)std::time(nullptr);
+  }
+
+  movie.rom_crc32 = GetROMCRC32(core);
+  movie.rtc_seed = config->rtc_seed;
+  movie.skip_bios = config->skip_bios;
+
+  if(from_power_on) {
+    core.Reset();
+
+    // The game reads the save file at power-on, which the movie itself is going to change.
+    const auto backup = core.GetROM().GetBackupMemory();
+
+    movie.start_backup.assign(backup.data, backup.data + backup.size);
+
+    // Restore the backup in the same way as on playback.
+    LoadBackup(core, movie.start_backup);
+  } else {
+    auto state = MakeSaveState();
+
+    core.CopyState(*state);
+    SaveStateFile::Encode(*state, movie.start_state);
+
+    // Reload the state, so that the core is in the same condition as on playback.
+    core.LoadState(*state);
+  }
+}
+
+void MovieRecorder::RunFrame(u16 keys) {
+  input.SetKeys(keys);
+  core.RunForOneFrame();
+
+  movie.frames.push_back(keys);
+
+  const u64 frame = movie.frames.size();
+
+  if(frame % checkpoint_interval == 0) {
+    movie.checkpoints.push_back({frame, core.StateHash()});
+  }
+}
+
+MoviePlayer::MoviePlayer(
+  CoreBase& core,
+  std::shared_ptr<Config> config,
+  MovieInputDevice& input,
+  Movie const& movie
+)   : core(core)
+    , config(config)
+    , input(input)
+    , movie(movie) {
+}
+
+auto MoviePlayer::Start() -> Result {
+  if(GetROMCRC32(core) != movie.rom_crc32) {
+    return Result::ROMMismatch;
+  }
+
+  config->rtc_seed = movie.rtc_seed;
+  config->skip_bios = movie.skip_bios;
+
+  if(movie.start_state.empty()) {
+    core.Reset();
+
+    if(movie.start_backup.size() != core.GetROM().GetBackupMemory().size) {
+      return Result::BadImage;
+    }
+
+    LoadBackup(core, movie.start_backup);
+  } else {
+    std::unique_ptr<SaveStateFile> file;
+
+    if(SaveStateFile::Open(std::vector<u8>{movie.start_state}, file) != SaveStateFile::Result::Success) {
+      return Result::BadImage;
+    }
+
+    auto state = MakeSaveState();
+
+    if(file->DecodeAll(*state) != SaveStateFile::Result::Success) {
+      return Result::BadImage;
+    }
+
+    core.LoadState(*state);
+  }
+
+  frame = 0;
+  next_checkpoint = 0;
+  desync_frame = 0;
+  status = Status::Playing;
+  return Result::Success;
+}
+
+auto MoviePlayer::RunFrame() -> Status {
+  if(status != Status::Playing) {
+    return status;
+  }
+
+  if(frame == movie.frames.size()) {
+    status = Status::Finished;
+    return status;
+  }
+
+  input.SetKeys(movie.frames[frame++]);
+  core.RunForOneFrame();
+
+  if(next_checkpoint < movie.checkpoints.size()) {
+    auto& checkpoint = movie.checkpoints[next_checkpoint];
+
+    if(checkpoint.frame == frame) {
+      next_checkpoint++;
+
+      if(core.StateHash() != checkpoint.state_hash) {
+        desync_frame = frame;
+        status = Status::Desync;
+      }
+    }
+  }
+
+  return status;
+}
+
+auto MoviePlayer::RunToEnd() -> Status {
+  while(RunFrame() == Status::Playing) {
+  }
+
+  return status;
+}
+
+} // namespace nba
@@ -0,0 +1,222 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <nba/common/punning.hpp>
+#include <platform/rewind_buffer.hpp>
+
+namespace nba {
+
+static constexpr size_t kWordCount = sizeof(SnapshotData) / sizeof(u64);
+
+static_assert(sizeof(SnapshotData) % sizeof(u64) == 0, "Snapshot size must be a multiple of eight bytes");
+
+static void WriteVarInt(std::vector<u8>& output, u64 value) {
+  while(value >= 0x80) {
+    output.push_back((u8)(value | 0x80));
+    value >>= 7;
+  }
+  output.push_back((u8)value);
+}
+
+static auto ReadVarInt(u8 const*& input) -> u64 {
+  u64 value = 0;
+  int shift = 0;
+
+  while(*input & 0x80) {
+    value |= (u64)(*input++ & 0x7F) << shift;
+    shift += 7;
+  }
+  value |= (u64)*input++ << shift;
+  return value;
+}
+
+RewindBuffer::RewindBuffer(
+  size_t memory_budget,
+  int snapshot_interval,
+  int keyframe_interval
+)   : memory_budget(memory_budget)
+    , snapshot_interval(std::max(snapshot_interval, 1))
+    , keyframe_interval(std::max(keyframe_interval, 1))
+    , previous(MakeSnapshotData())
+    , current(MakeSnapshotData()) {
+  scratch.reserve(sizeof(SnapshotData) + sizeof(SnapshotData) / 64);
+}
+
+void RewindBuffer::Reset() {
+  frame = 0;
+  memory_usage = 0;
+  snapshots_since_keyframe = 0;
+  snapshots.clear();
+}
+
+void RewindBuffer::Push(CoreBase& core) {
+  if(++frame % snapshot_interval == 0) {
+    Capture(core);
+  }
+}
+
+bool RewindBuffer::StepBack(CoreBase& core, int frames) {
+  if(frames <= 0 || (u64)frames > GetFrameCount()) {
+    return false;
+  }
+
+  const u64 target_frame = frame - frames;
+
+  // Snapshots after the target frame are discarded, since emulation continues from the restored snapshot.
+  while(snapshots.back().frame > target_frame) {
+    memory_usage -= snapshots.back().data.size() + sizeof(Snapshot);
+    snapshots.pop_back();
+  }
+
+  snapshots_since_keyframe = 0;
+
+  for(auto snapshot = snapshots.rbegin(); snapshot != snapshots.rend(); ++snapshot) {
+    snapshots_since_keyframe++;
+    if(snapshot->keyframe) break;
+  }
+
+  Decode(snapshots.size() - 1, (u8*)previous.get());
+  core.Restore(previous.get(), CoreBase::kSnapshotSize);
+
+  frame = snapshots.back().frame;
+  return true;
+}
+
+auto RewindBuffer::GetFrameCount() const -> u64 {
+  if(snapshots.empty()) {
+    return 0;
+  }
+
+  return frame - snapshots.front().frame;
+}
+
+void RewindBuffer::Capture(CoreBase& core) {
+  const bool keyframe = snapshots.empty() || snapshots_since_keyframe >= keyframe_interval;
+
+  core.Snapshot(current.get(), CoreBase::kSnapshotSize);
+
+  Encode((u8 const*)current.get(), keyframe ? nullptr : (u8 const*)previous.get(), scratch);
+
+  snapshots.push_back({frame, keyframe, {scratch.begin(), scratch.end()}});
+  memory_usage += scratch.size() + sizeof(Snapshot);
+  snapshots_since_keyframe = keyframe ? 1 : snapshots_since_keyframe + 1;
+
+  std::swap(previous, current);
+
+  Evict();
+}
+
+void RewindBuffer::Decode(size_t index, u8* state) {
+  size_t keyframe_index = index;
+
+  while(!snapshots[keyframe_index].keyframe) {
+    keyframe_index--;
+  }
+
+  std::memset(state, 0, sizeof(SnapshotData));
+
+  for(size_t i = keyframe_index; i <= index; i++) {
+    Decode(snapshots[i].data, state);
+  }
+}
+
+void RewindBuffer::Evict() {
+  while(memory_usage > memory_budget && snapshots.size() > 1) {
+    auto next_keyframe = std::find_if(snapshots.begin() + 1, snapshots.end(), [](Snapshot const& snapshot) {
+      return snapshot.keyframe;
+    });
+
+    // The deltas cannot be decoded without their keyframe, so the second snapshot must become a keyframe
+    // before the first one can be dropped. `current` is free to use, it is only needed while capturing.
+    if(next_keyframe == snapshots.end()) {
+      auto& snapshot = snapshots[1];
+
+      Decode(1, (u8*)current.get());
+      Encode((u8 const*)current.get(), nullptr, scratch);
+
+      memory_usage -= snapshot.data.size();
+      memory_usage += scratch.size();
+      snapshot.data.assign(scratch.begin(), scratch.end());
+      snapshot.keyframe = true;
+      next_keyframe = snapshots.begin() + 1;
+    }
+
+    for(auto snapshot = snapshots.begin(); snapshot != next_keyframe; ++snapshot) {
+      memory_usage -= snapshot->data.size() + sizeof(Snapshot);
+    }
+
+    snapshots.erase(snapshots.begin(), next_keyframe);
+  }
+}
+
+/**
+ * The (XOR-ed) state is encoded as a sequence of (zero run, literal run) pairs.
+ * Both run lengths are counted in 64-bit words and stored as variable-length integers,
+ * the literal words follow the lengths. Keyframes are encoded against an all-zero state.
+ */
+void RewindBuffer::Encode(u8 const* current, u8 const* previous, std::vector<u8>& output) {
+  const auto get_word = [&](size_t index) {
+    u64 word = read<u64>(current, index * sizeof(u64));
+
+    if(previous) {
+      word ^= read<u64>(previous, index * sizeof(u64));
+    }
+    return word;
+  };
+
+  output.clear();
+
+  size_t index = 0;
+
+  while(index < kWordCount) {
+    const size_t zero_run_begin = index;
+
+    while(index < kWordCount && get_word(index) == 0) {
+      index++;
+    }
+
+    const size_t literal_run_begin = index;
+
+    while(index < kWordCount && get_word(index) != 0) {
+      index++;
+    }
+
+    WriteVarInt(output, literal_run_begin - zero_run_begin);
+    WriteVarInt(output, index - literal_run_begin);
+
+    const size_t offset = output.size();
+
+    output.resize(offset + (index - literal_run_begin) * sizeof(u64));
+
+    for(size_t i = literal_run_begin; i < index; i++) {
+      write<u64>(output.data(), offset + (i - literal_run_begin) * sizeof(u64), get_word(i));
+    }
+  }
+}
+
+void RewindBuffer::Decode(std::vector<u8> const& input, u8* state) {
+  u8 const* data = input.data();
+  u8 const* data_end = data + input.size();
+
+  size_t offset = 0;
+
+  while(data < data_end) {
+    offset += ReadVarInt(data) * sizeof(u64);
+
+    const u64 literal_words = ReadVarInt(data);
+
+    for(u64 i = 0; i < literal_words; i++) {
+      write<u64>(state, offset, read<u64>(state, offset) ^ read<u64>(data, 0));
+      data += sizeof(u64);
+      offset += sizeof(u64);
+    }
+  }
+}
+
+} // namespace nba
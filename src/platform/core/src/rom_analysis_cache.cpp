@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <cstring>
+#include <fstream>
+#include <nba/common/atomic_write.hpp>
+#include <nba/common/crc32.hpp>
+#include <nba/common/hash.hpp>
+#include <nba/log.hpp>
+#include <platform/rom_analysis_cache.hpp>
+
+namespace nba {
+
+ROMAnalysisCache::ROMAnalysisCache(fs::path const& path) : path(path) {
+  Read();
+}
+
+auto ROMAnalysisCache::Get(MemorySpan rom) -> ROMAnalysis {
+  // Different ROMs with the same CRC32 and size are easy to construct (e.g. romhacks that patch a
+  // checksum back), it is far less likely that they also share an independent 64-bit hash.
+  const u64 hash = hash64(rom.data, rom.size);
+  const u32 crc = crc32(rom.data, rom.size);
+  const u32 size = (u32)rom.size;
+
+  {
+    std::lock_guard lock{mutex};
+
+    if(auto entry = Find(hash, crc, size); entry) {
+      return {entry->sound_main_ram, (Config::BackupType)entry->backup_type};
+    }
+  }
+
+  // Scan without holding the lock, so that other ROMs can be looked up in the meantime.
+  const auto analysis = AnalyzeROM(rom);
+
+  std::lock_guard lock{mutex};
+
+  // Another thread may have analyzed the same ROM in the meantime.
+  if(Find(hash, crc, size)) {
+    return analysis;
+  }
+
+  entries.push_back({hash, crc, size, analysis.sound_main_ram, (u32)analysis.backup_type});
+  Write();
+  return analysis;
+}
+
+auto ROMAnalysisCache::Find(u64 hash, u32 crc, u32 size) -> Entry* {
+  for(auto& entry : entries) {
+    if(entry.hash == hash && entry.crc32 == crc && entry.size == size) {
+      return &entry;
+    }
+  }
+
+  return nullptr;
+}
+
+void ROMAnalysisCache::Read() {
+  auto file = std::ifstream{path, std::ios::binary};
+
+  if(!file.good()) {
+    return;
+  }
+
+  u32 header[3];
+
+  file.read((char*)header, sizeof(header));
+
+  std::error_code error;
+
+  const auto file_size = fs::file_size(path, error);
+
+  if(!file.good() || header[0] != kMagicNumber || header[1] != kFormatVersion ||
+      error || file_size != sizeof(header) + (std::uintmax_t)header[2] * sizeof(Entry)) {
+    Log<Warn>("ROMAnalysisCache: ignoring invalid cache file: {}", path.string());
+    return;
+  }
+
+  entries.resize(header[2]);
+  file.read((char*)entries.data(), entries.size() * sizeof(Entry));
+
+  if(!file.good()) {
+    Log<Warn>("ROMAnalysisCache: failed to read the cache file: {}", path.string());
+    entries.clear();
+  }
+}
+
+void ROMAnalysisCache::Write() {
+  const u32 header[3] { kMagicNumber, kFormatVersion, (u32)entries.size() };
+
+  auto data = std::vector<u8>(sizeof(header) + entries.size() * sizeof(Entry));
+
+  std::memcpy(data.data(), header, sizeof(header));
+  std::memcpy(data.data() + sizeof(header), entries.data(), entries.size() * sizeof(Entry));
+
+  if(WriteFileAtomic(path, data.data(), data.size()) != WriteFileResult::Success) {
+    Log<Warn>("ROMAnalysisCache: failed to write the cache file: {}", path.string());
+  }
+}
+
+} // namespace nba
@@ -0,0 +1,706 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <nba/common/crc32.hpp>
+#include <nba/common/punning.hpp>
+#include <platform/save_state_file.hpp>
+#include <type_traits>
+#include <utility>
+
+namespace nba {
+
+using Section = SaveStateFile::Section;
+using Result = SaveStateFile::Result;
+
+static constexpr size_t kHeaderSize = 16;
+static constexpr size_t kSectionEntrySize = 24;
+static constexpr u32 kSectionCompressed = 1;
+
+// The core section holds the top-level fields: timestamp (u64), ROM address latch (u32) and KEYCNT (u16).
+static constexpr size_t kCoreSectionSize = 14;
+
+static constexpr auto Tag(char const (&name)[5]) -> u32 {
+  return (u32)name[0] | (u32)name[1] << 8 | (u32)name[2] << 16 | (u32)name[3] << 24;
+}
+
+static constexpr u32 g_section_tags[(int)Section::Count] {
+  Tag("CORE"),
+  Tag("ARM "),
+  Tag("BUS "),
+  Tag("IRQ "),
+  Tag("PPU "),
+  Tag("APU "),
+  Tag("TMR "),
+  Tag("DMA "),
+  Tag("BKUP"),
+  Tag("GPIO"),
+  Tag("SCHD")
+};
+
+static auto GetSectionSpan(Section section, SaveState& state) -> std::pair<u8*, size_t> {
+  switch(section) {
+    case Section::ARM:       return {(u8*)&state.arm, sizeof(state.arm)};
+    case Section::Bus:       return {(u8*)&state.bus, sizeof(state.bus)};
+    case Section::IRQ:       return {(u8*)&state.irq, sizeof(state.irq)};
+    case Section::PPU:       return {(u8*)&state.ppu, sizeof(state.ppu)};
+    case Section::APU:       return {(u8*)&state.apu, sizeof(state.apu)};
+    case Section::Timer:     return {(u8*)&state.timer, sizeof(state.timer)};
+    case Section::DMA:       return {(u8*)&state.dma, sizeof(state.dma)};
+    case Section::Backup:    return {(u8*)&state.backup, sizeof(state.backup)};
+    case Section::GPIO:      return {(u8*)&state.gpio, sizeof(state.gpio)};
+    case Section::Scheduler: return {(u8*)&state.scheduler, sizeof(state.scheduler)};
+    default:                 return {nullptr, 0};
+  }
+}
+
+/**
+ * The APU section of version 9. Every PSG channel was driven by a scheduler event,
+ * which was replaced by the synthesis clock in version 10.
+ */
+struct APUVersion9 {
+  using PSGVersion10 = SaveState::APU::IO::PSG;
+
+  struct IO {
+    struct PSG {
+      bool enabled;
+      u8 step;
+      PSGVersion10::Length length;
+      PSGVersion10::Envelope envelope;
+      PSGVersion10::Sweep sweep;
+      u64 event_uid;
+    };
+
+    // The channels used to derive from PSG, which places their fields after it.
+    struct QuadChannel {
+      PSG psg;
+      bool dac_enable;
+      u8 phase;
+      u8 wave_duty;
+      s8 sample;
+    } quad[2];
+
+    struct WaveChannel {
+      PSG psg;
+      bool playing;
+      bool force_volume;
+      u8 phase;
+      u8 volume;
+      u16 frequency;
+      u8 dimension;
+      u8 wave_bank;
+      u8 wave_ram[2][16];
+    } wave;
+
+    struct NoiseChannel {
+      PSG psg;
+      bool dac_enable;
+      u8 frequency_shift;
+      u8 frequency_ratio;
+      u8 width;
+    } noise;
+
+    u32 soundcnt;
+    u16 soundbias;
+  } io;
+
+  SaveState::APU::FIFO fifo[2];
+  u8 resolution_old;
+};
+
+// The timer section of version 9, which did not store the prescaler phase.
+struct TimerVersion9 {
+  u16 counter;
+  u16 reload;
+  u16 control;
+  SaveState::Timer::Pending pending;
+  u64 event_uid;
+};
+
+/**
+ * The layout of raw SaveState images of version 9, the last version that was written before this format.
+ * The other sections are unchanged since version 9. If one of them is changed, its old layout must be added here.
+ */
+struct SaveStateVersion9 {
+  u32 magic;
+  u32 version;
+  u64 timestamp;
+  SaveState::ARM arm;
+  SaveState::Bus bus;
+  SaveState::IRQ irq;
+  SaveState::PPU ppu;
+  APUVersion9 apu;
+  TimerVersion9 timer[4];
+  SaveState::DMA dma;
+  u32 rom_address_latch;
+  SaveState::Backup backup;
+  SaveState::GPIO gpio;
+  u16 keycnt;
+  SaveState::Scheduler scheduler;
+};
+
+static_assert(std::is_standard_layout_v<SaveStateVersion9>, "SaveStateVersion9 must be standard-layout for offsetof()");
+
+static auto GetVersion9SectionSpan(Section section) -> std::pair<size_t, size_t> {
+  using S = SaveStateVersion9;
+
+  switch(section) {
+    case Section::ARM:       return {offsetof(S, arm), sizeof(S::arm)};
+    case Section::Bus:       return {offsetof(S, bus), sizeof(S::bus)};
+    case Section::IRQ:       return {offsetof(S, irq), sizeof(S::irq)};
+    case Section::PPU:       return {offsetof(S, ppu), sizeof(S::ppu)};
+    case Section::APU:       return {offsetof(S, apu), sizeof(S::apu)};
+    case Section::Timer:     return {offsetof(S, timer), sizeof(S::timer)};
+    case Section::DMA:       return {offsetof(S, dma), sizeof(S::dma)};
+    case Section::Backup:    return {offsetof(S, backup), sizeof(S::backup)};
+    case Section::GPIO:      return {offsetof(S, gpio), sizeof(S::gpio)};
+    case Section::Scheduler: return {offsetof(S, scheduler), sizeof(S::scheduler)};
+    default:                 return {0, 0};
+  }
+}
+
+// In version 9 the event classes 14 to 17 belonged to the PSG channels, the classes after them are now four lower.
+static constexpr u16 kVersion9FirstPSGEventClass = 14;
+static constexpr u16 kVersion9PSGEventClassCount = 4;
+
+/**
+ * Upgrade routines convert the data of one section from `from_version` to `from_version + 1`.
+ * When the layout of SaveState changes, kCurrentVersion must be bumped and a routine
+ * must be added here for every section whose contents changed.
+ * Scheduler events used to be referenced by their UID from other sections, so the routines
+ * also get the scheduler section of the state as it was stored, if they need it.
+ */
+static_assert(SaveState::kCurrentVersion == 10, "SaveState was changed, add an upgrade routine for the new version");
+
+static void UpgradePSGFromVersion9(
+  APUVersion9::IO::PSG const& old_psg,
+  SaveState::APU::IO::PSG& psg,
+  SaveState::Scheduler const& scheduler
+) {
+  psg.enabled = old_psg.enabled;
+  psg.step = old_psg.step;
+  psg.length = old_psg.length;
+  psg.envelope = old_psg.envelope;
+  psg.sweep = old_psg.sweep;
+
+  // The next synthesis step happens when the channel's event would have fired.
+  psg.clock.running = false;
+  psg.clock.timestamp_next = 0;
+
+  const int event_count = std::min<int>(scheduler.event_count, std::size(scheduler.events));
+
+  for(int i = 0; i < event_count && old_psg.event_uid != 0; i++) {
+    if(scheduler.events[i].uid == old_psg.event_uid) {
+      psg.clock.running = true;
+      psg.clock.timestamp_next = scheduler.events[i].key >> 2;
+      break;
+    }
+  }
+}
+
+static void UpgradeAPUFromVersion9(std::vector<u8>& data, SaveState::Scheduler const& scheduler) {
+  APUVersion9 old_apu;
+  SaveState::APU apu{};
+
+  std::memcpy(&old_apu, data.data(), sizeof(old_apu));
+
+  auto& old_io = old_apu.io;
+  auto& io = apu.io;
+
+  for(int i = 0; i < 2; i++) {
+    UpgradePSGFromVersion9(old_io.quad[i].psg, io.quad[i], scheduler);
+    io.quad[i].dac_enable = old_io.quad[i].dac_enable;
+    io.quad[i].phase = old_io.quad[i].phase;
+    io.quad[i].wave_duty = old_io.quad[i].wave_duty;
+    io.quad[i].sample = old_io.quad[i].sample;
+  }
+
+  UpgradePSGFromVersion9(old_io.wave.psg, io.wave, scheduler);
+  io.wave.playing = old_io.wave.playing;
+  io.wave.force_volume = old_io.wave.force_volume;
+  io.wave.phase = old_io.wave.phase;
+  io.wave.volume = old_io.wave.volume;
+  io.wave.frequency = old_io.wave.frequency;
+  io.wave.dimension = old_io.wave.dimension;
+  io.wave.wave_bank = old_io.wave.wave_bank;
+  std::memcpy(io.wave.wave_ram, old_io.wave.wave_ram, sizeof(io.wave.wave_ram));
+
+  UpgradePSGFromVersion9(old_io.noise.psg, io.noise, scheduler);
+  io.noise.dac_enable = old_io.noise.dac_enable;
+  io.noise.frequency_shift = old_io.noise.frequency_shift;
+  io.noise.frequency_ratio = old_io.noise.frequency_ratio;
+  io.noise.width = old_io.noise.width;
+
+  io.soundcnt = old_io.soundcnt;
+  io.soundbias = old_io.soundbias;
+
+  /* Version 9 did not store the SOUNDCNT_X master enable bit, so this upgrade is lossy.
+   * Loading such a state used to keep the bit of the running game, and games enable sound
+   * at boot and leave it enabled. So the bit is assumed to be set: a wrongly set bit only
+   * accepts writes that the game does not make, while a wrongly cleared bit mutes the game.
+   */
+  io.master_enable = true;
+
+  std::memcpy(apu.fifo, old_apu.fifo, sizeof(apu.fifo));
+  apu.resolution_old = old_apu.resolution_old;
+
+  data.resize(sizeof(apu));
+  std::memcpy(data.data(), &apu, sizeof(apu));
+}
+
+static void UpgradeTimerFromVersion9(std::vector<u8>& data, SaveState::Scheduler const&) {
+  TimerVersion9 old_timer[4];
+  SaveState::Timer timer[4]{};
+
+  std::memcpy(old_timer, data.data(), sizeof(old_timer));
+
+  for(int i = 0; i < 4; i++) {
+    timer[i].counter = old_timer[i].counter;
+    timer[i].reload = old_timer[i].reload;
+    timer[i].control = old_timer[i].control;
+    timer[i].pending = old_timer[i].pending;
+    timer[i].event_uid = old_timer[i].event_uid;
+
+    // Version 9 did not store the prescaler phase, assume that the prescalers were aligned.
+    timer[i].prescaler_phase = 0;
+  }
+
+  data.resize(sizeof(timer));
+  std::memcpy(data.data(), timer, sizeof(timer));
+}
+
+static void UpgradeSchedulerFromVersion9(std::vector<u8>& data, SaveState::Scheduler const&) {
+  SaveState::Scheduler scheduler;
+
+  std::memcpy(&scheduler, data.data(), sizeof(scheduler));
+
+  const int event_count = std::min<int>(scheduler.event_count, std::size(scheduler.events));
+  int new_event_count = 0;
+
+  // The events of the PSG channels were converted into their synthesis clocks by the APU upgrade.
+  for(int i = 0; i < event_count; i++) {
+    auto event = scheduler.events[i];
+
+    if(event.event_class >= kVersion9FirstPSGEventClass + kVersion9PSGEventClassCount) {
+      event.event_class -= kVersion9PSGEventClassCount;
+    } else if(event.event_class >= kVersion9FirstPSGEventClass) {
+      continue;
+    }
+
+    scheduler.events[new_event_count++] = event;
+  }
+
+  scheduler.event_count = (u8)new_event_count;
+
+  std::memcpy(data.data(), &scheduler, sizeof(scheduler));
+}
+
+static const struct Upgrade {
+  u32 from_version;
+  Section section;
+  size_t size;
+  bool uses_scheduler;
+  void (*function)(std::vector<u8>& data, SaveState::Scheduler const& scheduler);
+} g_upgrades[] {
+  {9, Section::APU, sizeof(SaveStateVersion9::apu), true, UpgradeAPUFromVersion9},
+  {9, Section::Timer, sizeof(SaveStateVersion9::timer), false, UpgradeTimerFromVersion9},
+  {9, Section::Scheduler, sizeof(SaveStateVersion9::scheduler), false, UpgradeSchedulerFromVersion9}
+};
+
+static void WriteVarInt(std::vector<u8>& output, u64 value) {
+  while(value >= 0x80) {
+    output.push_back((u8)(value | 0x80));
+    value >>= 7;
+  }
+  output.push_back((u8)value);
+}
+
+static bool ReadVarInt(u8 const*& input, u8 const* input_end, u64& value) {
+  value = 0;
+
+  for(int shift = 0; input < input_end && shift < 64; shift += 7) {
+    const u8 byte = *input++;
+
+    value |= (u64)(byte & 0x7F) << shift;
+
+    if(!(byte & 0x80)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * Sections are compressed with a byte-wise run-length encoding. Each token starts with a variable-length integer:
+ * bit 0 clear means a literal run of (n >> 1) + 1 bytes that follow the token,
+ * bit 0 set means (n >> 1) + kMinRunLength repetitions of the byte that follows the token.
+ * This is cheap and works well on the large zero-filled regions of the state (backup memory, VRAM, scheduler).
+ */
+static constexpr size_t kMinRunLength = 4;
+
+static void Compress(u8 const* input, size_t size, std::vector<u8>& output) {
+  output.clear();
+
+  size_t index = 0;
+  size_t literal_begin = 0;
+
+  const auto flush_literals = [&](size_t literal_end) {
+    if(literal_end > literal_begin) {
+      WriteVarInt(output, (literal_end - literal_begin - 1) << 1);
+      output.insert(output.end(), input + literal_begin, input + literal_end);
+    }
+  };
+
+  while(index < size) {
+    size_t run_end = index + 1;
+
+    while(run_end < size && input[run_end] == input[index]) {
+      run_end++;
+    }
+
+    if(run_end - index >= kMinRunLength) {
+      flush_literals(index);
+      WriteVarInt(output, (run_end - index - kMinRunLength) << 1 | 1);
+      output.push_back(input[index]);
+      literal_begin = run_end;
+      index = run_end;
+    } else {
+      index++;
+    }
+  }
+
+  flush_literals(size);
+}
+
+static bool Decompress(u8 const* input, size_t input_size, u8* output, size_t size) {
+  u8 const* input_end = input + input_size;
+  size_t offset = 0;
+
+  while(input < input_end) {
+    u64 token;
+
+    if(!ReadVarInt(input, input_end, token)) {
+      return false;
+    }
+
+    const u64 length = (token >> 1) + ((token & 1) ? kMinRunLength : 1);
+
+    if(length > size - offset) {
+      return false;
+    }
+
+    if(token & 1) {
+      if(input == input_end) return false;
+      std::memset(output + offset, *input++, length);
+    } else {
+      if(length > (u64)(input_end - input)) return false;
+      std::memcpy(output + offset, input, length);
+      input += length;
+    }
+
+    offset += length;
+  }
+
+  return offset == size;
+}
+
+void SaveStateFile::Encode(SaveState const& save_state, std::vector<u8>& output) {
+  auto& state = const_cast<SaveState&>(save_state);
+
+  constexpr int section_count = (int)Section::Count;
+
+  std::vector<u8> compressed;
+
+  output.clear();
+  output.resize(kHeaderSize + section_count * kSectionEntrySize);
+
+  write<u32>(output.data(), 0, kMagicNumber);
+  write<u32>(output.data(), 4, kFormatVersion);
+  write<u32>(output.data(), 8, save_state.version);
+  write<u32>(output.data(), 12, section_count);
+
+  for(int i = 0; i < section_count; i++) {
+    const auto section = (Section)i;
+
+    u8 core_data[kCoreSectionSize];
+    u8 const* data;
+    size_t size;
+
+    if(section == Section::Core) {
+      write<u64>(core_data, 0, save_state.timestamp);
+      write<u32>(core_data, 8, save_state.rom_address_latch);
+      write<u16>(core_data, 12, save_state.keycnt);
+      data = core_data;
+      size = kCoreSectionSize;
+    } else {
+      std::tie(data, size) = GetSectionSpan(section, state);
+    }
+
+    Compress(data, size, compressed);
+
+    const bool use_compression = compressed.size() < size;
+    const size_t stored_size = use_compression ? compressed.size() : size;
+    const size_t entry = kHeaderSize + i * kSectionEntrySize;
+
+    write<u32>(output.data(), entry +  0, g_section_tags[i]);
+    write<u32>(output.data(), entry +  4, use_compression ? kSectionCompressed : 0);
+    write<u32>(output.data(), entry +  8, (u32)size);
+    write<u32>(output.data(), entry + 12, (u32)stored_size);
+    write<u32>(output.data(), entry + 16, (u32)output.size());
+    write<u32>(output.data(), entry + 20, crc32(data, size));
+
+    if(use_compression) {
+      output.insert(output.end(), compressed.begin(), compressed.end());
+    } else {
+      output.insert(output.end(), data, data + size);
+    }
+  }
+}
+
+auto SaveStateFile::Open(
+  fs::path const& path,
+  std::unique_ptr<SaveStateFile>& file
+) -> Result {
+  auto mapped_file = MappedFile::Open(path);
+
+  if(!mapped_file) {
+    return Result::CannotOpenFile;
+  }
+
+  // The constructor is private, so std::make_unique cannot be used.
+  auto state_file = std::unique_ptr<SaveStateFile>{new SaveStateFile{}};
+
+  state_file->image = mapped_file->Data();
+  state_file->image_size = mapped_file->Size();
+  state_file->mapped_file = std::move(mapped_file);
+
+  return Open(std::move(state_file), file);
+}
+
+auto SaveStateFile::Open(
+  std::vector<u8>&& data,
+  std::unique_ptr<SaveStateFile>& file
+) -> Result {
+  auto state_file = std::unique_ptr<SaveStateFile>{new SaveStateFile{}};
+
+  state_file->buffer = std::move(data);
+  state_file->image = state_file->buffer.data();
+  state_file->image_size = state_file->buffer.size();
+
+  return Open(std::move(state_file), file);
+}
+
+auto SaveStateFile::Open(
+  std::unique_ptr<SaveStateFile> state_file,
+  std::unique_ptr<SaveStateFile>& file
+) -> Result {
+  const auto data = state_file->image;
+  const auto size = state_file->image_size;
+
+  if(size >= kHeaderSize && read<u32>(data, 0) == kMagicNumber) {
+    if(read<u32>(data, 4) != kFormatVersion) {
+      return Result::UnsupportedVersion;
+    }
+
+    state_file->version = read<u32>(data, 8);
+
+    auto result = state_file->ParseSectionTable();
+
+    if(result != Result::Success) {
+      return result;
+    }
+  } else if(size >= 8 && read<u32>(data, 0) == SaveState::kMagicNumber) {
+    // Raw SaveState image from before the section-based format, which were only read back to version 9.
+    state_file->version = read<u32>(data, 4);
+    state_file->raw_image = true;
+
+    if(state_file->version != 9) {
+      return Result::UnsupportedVersion;
+    }
+
+    if(size != sizeof(SaveStateVersion9)) {
+      return Result::BadImage;
+    }
+  } else {
+    return Result::BadImage;
+  }
+
+  if(state_file->version < kOldestSupportedVersion || state_file->version > SaveState::kCurrentVersion) {
+    return Result::UnsupportedVersion;
+  }
+
+  file = std::move(state_file);
+  return Result::Success;
+}
+
+auto SaveStateFile::ParseSectionTable() -> Result {
+  const auto section_count = (u64)read<u32>(image, 12);
+
+  if(kHeaderSize + section_count * kSectionEntrySize > (u64)image_size) {
+    return Result::BadImage;
+  }
+
+  for(u64 i = 0; i < section_count; i++) {
+    const uint entry = (uint)(kHeaderSize + i * kSectionEntrySize);
+    const u32 tag = read<u32>(image, entry);
+
+    // Sections that are unknown to this version are skipped.
+    for(int j = 0; j < (int)Section::Count; j++) {
+      if(g_section_tags[j] != tag) {
+        continue;
+      }
+
+      auto& section = sections[j];
+
+      section.present = true;
+      section.compressed = read<u32>(image, entry + 4) & kSectionCompressed;
+      section.size = read<u32>(image, entry + 8);
+      section.stored_size = read<u32>(image, entry + 12);
+      section.offset = read<u32>(image, entry + 16);
+      section.checksum = read<u32>(image, entry + 20);
+
+      if((u64)section.offset + section.stored_size > (u64)image_size) {
+        return Result::BadImage;
+      }
+
+      if(!section.compressed && section.stored_size != section.size) {
+        return Result::BadImage;
+      }
+    }
+  }
+
+  return Result::Success;
+}
+
+auto SaveStateFile::ReadSection(Section section, std::vector<u8>& output) const -> Result {
+  auto& entry = sections[(int)section];
+
+  if(!entry.present) {
+    return Result::BadImage;
+  }
+
+  u8 const* stored_data = image + entry.offset;
+
+  output.resize(entry.size);
+
+  if(entry.compressed) {
+    if(!Decompress(stored_data, entry.stored_size, output.data(), output.size())) {
+      return Result::BadImage;
+    }
+  } else {
+    std::memcpy(output.data(), stored_data, entry.size);
+  }
+
+  if(crc32(output.data(), output.size()) != entry.checksum) {
+    return Result::BadImage;
+  }
+
+  return Result::Success;
+}
+
+void SaveStateFile::ReadRawSection(Section section, std::vector<u8>& output) const {
+  using S = SaveStateVersion9;
+
+  if(section == Section::Core) {
+    output.resize(kCoreSectionSize);
+    std::memcpy(&output[0],  image + offsetof(S, timestamp), sizeof(u64));
+    std::memcpy(&output[8],  image + offsetof(S, rom_address_latch), sizeof(u32));
+    std::memcpy(&output[12], image + offsetof(S, keycnt), sizeof(u16));
+  } else {
+    const auto [offset, size] = GetVersion9SectionSpan(section);
+
+    output.assign(image + offset, image + offset + size);
+  }
+}
+
+auto SaveStateFile::ReadStoredSection(Section section, std::vector<u8>& output) const -> Result {
+  if(raw_image) {
+    ReadRawSection(section, output);
+    return Result::Success;
+  }
+  return ReadSection(section, output);
+}
+
+auto SaveStateFile::Decode(Section section, SaveState& save_state) const -> Result {
+  std::vector<u8> data;
+
+  auto result = ReadStoredSection(section, data);
+
+  if(result != Result::Success) {
+    return result;
+  }
+
+  std::vector<u8> scheduler_data;
+
+  for(auto& upgrade : g_upgrades) {
+    if(upgrade.section == section && upgrade.from_version >= version) {
+      if(data.size() != upgrade.size) {
+        return Result::BadImage;
+      }
+
+      SaveState::Scheduler scheduler{};
+
+      if(upgrade.uses_scheduler) {
+        if(scheduler_data.empty()) {
+          result = ReadStoredSection(Section::Scheduler, scheduler_data);
+
+          if(result != Result::Success) {
+            return result;
+          }
+        }
+
+        if(scheduler_data.size() != sizeof(scheduler)) {
+          return Result::BadImage;
+        }
+
+        std::memcpy(&scheduler, scheduler_data.data(), sizeof(scheduler));
+      }
+
+      upgrade.function(data, scheduler);
+    }
+  }
+
+  if(section == Section::Core) {
+    if(data.size() != kCoreSectionSize) {
+      return Result::BadImage;
+    }
+
+    save_state.timestamp = read<u64>(data.data(), 0);
+    save_state.rom_address_latch = read<u32>(data.data(), 8);
+    save_state.keycnt = read<u16>(data.data(), 12);
+  } else {
+    const auto [section_data, size] = GetSectionSpan(section, save_state);
+
+    if(data.size() != size) {
+      return Result::BadImage;
+    }
+
+    std::memcpy(section_data, data.data(), size);
+  }
+
+  return Result::Success;
+}
+
+auto SaveStateFile::DecodeAll(SaveState& save_state) const -> Result {
+  for(int i = 0; i < (int)Section::Count; i++) {
+    auto result = Decode((Section)i, save_state);
+
+    if(result != Result::Success) {
+      return result;
+    }
+  }
+
+  save_state.magic = SaveState::kMagicNumber;
+  save_state.version = SaveState::kCurrentVersion;
+  return Result::Success;
+}
+
+} // namespace nba
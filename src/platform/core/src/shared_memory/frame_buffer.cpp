@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <climits>
+#include <platform/shared_memory/frame_buffer.hpp>
+
+#ifdef __linux__
+  #include <linux/futex.h>
+  #include <sys/syscall.h>
+  #include <time.h>
+  #include <unistd.h>
+#else
+  #include <chrono>
+  #include <thread>
+#endif
+
+namespace nba {
+
+#ifdef __linux__
+
+// The word lives in memory that is shared between processes, so the private futex operations cannot be used.
+void SharedFrameBuffer::Wait(std::atomic<u32>& word, u32 expected, int timeout_us) {
+  timespec timeout;
+
+  timeout.tv_sec = timeout_us / 1000000;
+  timeout.tv_nsec = (timeout_us % 1000000) * 1000;
+
+  syscall(SYS_futex, (u32*)&word, FUTEX_WAIT, expected, &timeout, nullptr, 0);
+}
+
+void SharedFrameBuffer::Wake(std::atomic<u32>& word) {
+  syscall(SYS_futex, (u32*)&word, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+#else
+
+void SharedFrameBuffer::Wait(std::atomic<u32>& word, u32 expected, int timeout_us) {
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds{timeout_us};
+
+  while(word.load(std::memory_order_acquire) == expected && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::microseconds{50});
+  }
+}
+
+void SharedFrameBuffer::Wake(std::atomic<u32>& word) {
+  (void)word;
+}
+
+#endif
+
+} // namespace nba
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <chrono>
+#include <platform/shared_memory/reader.hpp>
+
+namespace nba {
+
+auto SharedFrameReader::Open(std::string const& name) -> std::unique_ptr<SharedFrameReader> {
+  auto region = SharedMemoryRegion::Open(name);
+
+  if(!region || region->Size() < sizeof(SharedFrameBuffer::Header)) {
+    return nullptr;
+  }
+
+  auto header = (SharedFrameBuffer::Header*)region->Data();
+
+  if(header->magic != SharedFrameBuffer::kMagicNumber ||
+     header->version != SharedFrameBuffer::kVersion ||
+     header->slot_size != sizeof(SharedFrameBuffer::Slot) ||
+     header->slot_count == 0 ||
+     region->Size() < SharedFrameBuffer::GetSize(header->slot_count)) {
+    return nullptr;
+  }
+
+  auto reader = std::unique_ptr<SharedFrameReader>{new SharedFrameReader{}};
+
+  reader->region = std::move(region);
+  reader->header = header;
+  return reader;
+}
+
+auto SharedFrameReader::GetLatestFrame() const -> u64 {
+  return header->latest_frame.load(std::memory_order_acquire);
+}
+
+auto SharedFrameReader::WaitForFrame(u64 frame, int timeout_us) -> u64 {
+  using Clock = std::chrono::steady_clock;
+
+  const auto deadline = Clock::now() + std::chrono::microseconds{timeout_us};
+
+  while(true) {
+    // Read the signal word first, so that a frame published after the check below ends the wait immediately.
+    const u32 signal = header->frame_signal.load(std::memory_order_acquire);
+    const u64 latest_frame = GetLatestFrame();
+
+    if(latest_frame > frame) {
+      return latest_frame;
+    }
+
+    const auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(deadline - Clock::now()).count();
+
+    if(remaining <= 0) {
+      return 0;
+    }
+
+    header->waiting_readers.fetch_add(1, std::memory_order_seq_cst);
+
+    if(header->frame_signal.load(std::memory_order_seq_cst) == signal) {
+      SharedFrameBuffer::Wait(header->frame_signal, signal, (int)remaining);
+    }
+
+    header->waiting_readers.fetch_sub(1, std::memory_order_relaxed);
+  }
+}
+
+auto SharedFrameReader::Acquire(u64 frame, Frame& view) const -> bool {
+  auto slot = SharedFrameBuffer::GetSlot(header, frame);
+
+  const u32 sequence = slot->sequence.load(std::memory_order_acquire);
+
+  if(sequence & 1) {
+    return false;
+  }
+
+  view.pixels = slot->pixels;
+  view.frame = slot->frame;
+  view.publish_time = slot->publish_time;
+  view.sequence = sequence;
+
+  return view.frame == frame && Validate(view);
+}
+
+auto SharedFrameReader::Validate(Frame const& view) const -> bool {
+  auto slot = SharedFrameBuffer::GetSlot(header, view.frame);
+
+  std::atomic_thread_fence(std::memory_order_acquire);
+
+  return slot->sequence.load(std::memory_order_relaxed) == view.sequence;
+}
+
+void SharedFrameReader::SetKeys(u16 keys) {
+  header->keys.store(keys, std::memory_order_release);
+}
+
+} // namespace nba
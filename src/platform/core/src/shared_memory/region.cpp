@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <fcntl.h>
+#include <platform/shared_memory/region.hpp>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace nba {
+
+SharedMemoryRegion::~SharedMemoryRegion() {
+  if(data) {
+    munmap(data, size);
+  }
+
+  if(owner) {
+    shm_unlink(name.c_str());
+  }
+}
+
+auto SharedMemoryRegion::Create(std::string const& name, size_t size) -> std::unique_ptr<SharedMemoryRegion> {
+  // Remove an object that was left behind by a process that did not exit cleanly.
+  shm_unlink(name.c_str());
+
+  const int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+
+  if(fd == -1) {
+    return nullptr;
+  }
+
+  auto region = std::unique_ptr<SharedMemoryRegion>{new SharedMemoryRegion{}};
+
+  region->name = name;
+  region->owner = true;
+
+  if(ftruncate(fd, (off_t)size) != 0) {
+    close(fd);
+    return nullptr;
+  }
+
+  void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+  close(fd);
+
+  if(data == MAP_FAILED) {
+    return nullptr;
+  }
+
+  region->data = data;
+  region->size = size;
+  return region;
+}
+
+auto SharedMemoryRegion::Open(std::string const& name) -> std::unique_ptr<SharedMemoryRegion> {
+  const int fd = shm_open(name.c_str(), O_RDWR, 0);
+
+  if(fd == -1) {
+    return nullptr;
+  }
+
+  struct stat stat;
+
+  if(fstat(fd, &stat) != 0 || stat.st_size == 0) {
+    close(fd);
+    return nullptr;
+  }
+
+  void* data = mmap(nullptr, (size_t)stat.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+  close(fd);
+
+  if(data == MAP_FAILED) {
+    return nullptr;
+  }
+
+  auto region = std::unique_ptr<SharedMemoryRegion>{new SharedMemoryRegion{}};
+
+  region->name = name;
+  region->data = data;
+  region->size = (size_t)stat.st_size;
+  return region;
+}
+
+} // namespace nba
@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <nba/common/punning.hpp>
+#include <platform/stem_compare.hpp>
+#include <platform/writer/stems.hpp>
+#include <vector>
+
+namespace nba {
+
+// Reads the frames of a stem capture across its blocks, along with the sample rate of each frame.
+struct StemReader {
+  auto Open(fs::path const& path) -> StemComparator::Result {
+    file_stream.open(path.c_str(), std::ios::binary);
+
+    if(!file_stream.good()) {
+      return StemComparator::Result::CannotOpenFile;
+    }
+
+    u8 header[StemWriter::kHeaderSize];
+
+    file_stream.read((char*)header, sizeof(header));
+
+    if(!file_stream.good() ||
+        read<u32>(header, 0) != StemWriter::kMagicNumber ||
+        read<u32>(header, 4) != StemWriter::kCurrentVersion ||
+        read<u32>(header, 8) != StemCapture::kStemCount) {
+      return StemComparator::Result::BadImage;
+    }
+
+    dropped_frames = read<u64>(header, 12);
+    return StemComparator::Result::Success;
+  }
+
+  /**
+   * Reads up to `max_frames` frames and returns the number of frames read,
+   * which is only less than `max_frames` at the end of the file. Returns -1 if the file is truncated.
+   */
+  auto Read(float* samples, u32* sample_rates, int max_frames) -> int {
+    constexpr int kStemCount = StemCapture::kStemCount;
+
+    int frames = 0;
+
+    while(frames < max_frames) {
+      if(block_remaining == 0) {
+        u8 block_header[8];
+
+        file_stream.read((char*)block_header, sizeof(block_header));
+
+        if(file_stream.gcount() == 0) {
+          break;
+        }
+
+        if(!file_stream.good()) {
+          return -1;
+        }
+
+        block_sample_rate = read<u32>(block_header, 0);
+        block_remaining = read<u32>(block_header, 4);
+        continue;
+      }
+
+      const int count = (int)std::min<u32>(block_remaining, max_frames - frames);
+
+      file_stream.read((char*)&samples[frames * kStemCount], count * kStemCount * sizeof(float));
+
+      if(!file_stream.good()) {
+        return -1;
+      }
+
+      std::fill_n(&sample_rates[frames], count, block_sample_rate);
+      block_remaining -= count;
+      frames += count;
+    }
+
+    return frames;
+  }
+
+  std::ifstream file_stream;
+  u64 dropped_frames = 0;
+  u32 block_sample_rate = 0;
+  u32 block_remaining = 0;
+};
+
+auto StemComparator::Compare(
+  fs::path const& golden_path,
+  fs::path const& actual_path,
+  StemComparison& comparison,
+  int block_size
+) -> Result {
+  constexpr int kStemCount = StemCapture::kStemCount;
+
+  StemReader golden_reader;
+  StemReader actual_reader;
+
+  if(auto result = golden_reader.Open(golden_path); result != Result::Success) {
+    return result;
+  }
+
+  if(auto result = actual_reader.Open(actual_path); result != Result::Success) {
+    return result;
+  }
+
+  comparison = {};
+  comparison.golden_dropped_frames = golden_reader.dropped_frames;
+  comparison.actual_dropped_frames = actual_reader.dropped_frames;
+
+  std::vector<float> golden(block_size * kStemCount);
+  std::vector<float> actual(block_size * kStemCount);
+  std::vector<u32> golden_sample_rates(block_size);
+  std::vector<u32> actual_sample_rates(block_size);
+
+  double square_sum[kStemCount] {};
+
+  while(true) {
+    const int golden_frames = golden_reader.Read(golden.data(), golden_sample_rates.data(), block_size);
+    const int actual_frames = actual_reader.Read(actual.data(), actual_sample_rates.data(), block_size);
+
+    if(golden_frames < 0 || actual_frames < 0) {
+      return Result::BadImage;
+    }
+
+    const int frames = std::min(golden_frames, actual_frames);
+
+    for(int i = 0; i < frames; i++) {
+      if(golden_sample_rates[i] != actual_sample_rates[i]) {
+        comparison.sample_rate_mismatch = true;
+      }
+
+      for(int stem = 0; stem < kStemCount; stem++) {
+        auto& result = comparison.stems[stem];
+        auto difference = std::abs((double)golden[i * kStemCount + stem] - actual[i * kStemCount + stem]);
+
+        square_sum[stem] += difference * difference;
+
+        if(difference > result.peak_difference) {
+          result.peak_difference = difference;
+          result.peak_frame = comparison.frame_count + i;
+        }
+      }
+    }
+
+    comparison.frame_count += frames;
+
+    if(golden_frames != actual_frames) {
+      comparison.length_mismatch = true;
+      break;
+    }
+
+    if(frames < block_size) {
+      break;
+    }
+  }
+
+  if(comparison.frame_count > 0) {
+    for(int stem = 0; stem < kStemCount; stem++) {
+      comparison.stems[stem].rms_difference = std::sqrt(square_sum[stem] / comparison.frame_count);
+    }
+  }
+
+  return Result::Success;
+}
+
+} // namespace nba
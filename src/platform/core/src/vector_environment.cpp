@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <platform/vector_environment.hpp>
+#include <stdexcept>
+
+namespace nba {
+
+static auto IsValidObservation(VectorEnvironment::Observation const& observation) -> bool {
+  const int size = observation.size;
+
+  return size == 1 || size == 2 || size == 4;
+}
+
+void VectorEnvironment::FrameCaptureDevice::Draw(u32* buffer) {
+  if(target) {
+    std::memcpy(target, buffer, kFrameSize * sizeof(u32));
+  }
+}
+
+VectorEnvironment::VectorEnvironment(CoreBase& core, int count, Options const& options)
+    : options(options)
+    , runner(options.thread_count)
+    , initial_state(MakeSnapshotData()) {
+  for(auto& observation : options.observations) {
+    if(!IsValidObservation(observation)) {
+      throw std::runtime_error("VectorEnvironment: observations must be 1, 2 or 4 bytes");
+    }
+  }
+
+  if(options.done_condition.has_value() && !IsValidObservation(options.done_condition->value)) {
+    throw std::runtime_error("VectorEnvironment: the done condition must be 1, 2 or 4 bytes");
+  }
+
+  reads = options.observations;
+
+  if(options.done_condition.has_value()) {
+    reads.push_back(options.done_condition->value);
+  }
+
+  values.resize(reads.size());
+
+  this->options.frame_skip = std::max(options.frame_skip, 1);
+
+  core.Snapshot(initial_state.get(), CoreBase::kSnapshotSize);
+
+  for(int i = 0; i < count; i++) {
+    auto& instance = instances.emplace_back();
+    auto config = options.config ? std::make_shared<Config>(*options.config) : std::make_shared<Config>();
+
+    instance.input = std::make_shared<MovieInputDevice>();
+    instance.video = std::make_shared<FrameCaptureDevice>();
+
+    config->audio_dev = std::make_shared<NullAudioDevice>();
+    config->input_dev = instance.input;
+    config->video_dev = instance.video;
+    config->stem_capture = nullptr;
+
+    runner.Add(core.Clone(config));
+  }
+}
+
+void VectorEnvironment::Step(u16 const* keys, u32* frames, u32* observations, u8* dones) {
+  const int count = GetCount();
+  const int observation_count = GetObservationCount();
+
+  for(int i = 0; i < count; i++) {
+    auto& instance = instances[i];
+
+    if(instance.done && options.auto_reset) {
+      GetCore(i).Restore(initial_state.get(), CoreBase::kSnapshotSize);
+      instance.done = false;
+    }
+
+    instance.input->SetKeys(keys[i]);
+  }
+
+  // Only the last frame is captured, skipped frames are not copied.
+  if(options.frame_skip > 1) {
+    runner.RunFrames(options.frame_skip - 1);
+  }
+
+  if(frames) {
+    for(int i = 0; i < count; i++) {
+      instances[i].video->target = &frames[i * kFrameSize];
+    }
+  }
+
+  runner.RunFrames(1);
+
+  for(int i = 0; i < count; i++) {
+    auto& instance = instances[i];
+    auto& core = GetCore(i);
+
+    instance.video->target = nullptr;
+
+    core.Gather(reads.data(), values.data(), reads.size());
+
+    if(observations) {
+      std::copy_n(values.begin(), observation_count, &observations[i * observation_count]);
+    }
+
+    if(options.done_condition.has_value()) {
+      auto& condition = options.done_condition.value();
+
+      instance.done = (values.back() & condition.mask) == condition.expected;
+    }
+
+    if(dones) {
+      dones[i] = instance.done ? 1 : 0;
+    }
+  }
+}
+
+void VectorEnvironment::Reset() {
+  for(int i = 0; i < GetCount(); i++) {
+    GetCore(i).Restore(initial_state.get(), CoreBase::kSnapshotSize);
+    instances[i].done = false;
+  }
+}
+
+} // namespace nba
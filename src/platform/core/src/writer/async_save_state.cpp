@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <platform/writer/async_save_state.hpp>
+
+namespace nba {
+
+AsyncSaveStateWriter::AsyncSaveStateWriter() {
+  thread = std::thread{[this]() { WorkerThread(); }};
+}
+
+AsyncSaveStateWriter::~AsyncSaveStateWriter() {
+  {
+    std::lock_guard lock{mutex};
+    quit = true;
+  }
+
+  cv_work.notify_one();
+  thread.join();
+}
+
+void AsyncSaveStateWriter::Write(CoreBase& core, fs::path const& path, Callback callback) {
+  std::unique_ptr<SaveState> save_state;
+
+  {
+    std::lock_guard lock{mutex};
+
+    if(!free_buffers.empty()) {
+      save_state = std::move(free_buffers.back());
+      free_buffers.pop_back();
+    }
+  }
+
+  if(!save_state) {
+    save_state = MakeSaveState();
+  }
+
+  core.CopyState(*save_state);
+
+  {
+    std::lock_guard lock{mutex};
+    jobs.push_back({std::move(save_state), path, std::move(callback)});
+  }
+
+  cv_work.notify_one();
+}
+
+void AsyncSaveStateWriter::Flush() {
+  std::unique_lock lock{mutex};
+
+  cv_idle.wait(lock, [this]() { return jobs.empty() && !busy; });
+}
+
+void AsyncSaveStateWriter::WorkerThread() {
+  std::unique_lock lock{mutex};
+
+  while(true) {
+    cv_work.wait(lock, [this]() { return quit || !jobs.empty(); });
+
+    // Pending save states are still written on exit, the user expects them on the disk.
+    if(jobs.empty()) {
+      break;
+    }
+
+    auto job = std::move(jobs.front());
+    jobs.pop_front();
+    busy = true;
+
+    lock.unlock();
+
+    const auto result = SaveStateWriter::Write(*job.save_state, job.path);
+
+    if(job.callback) {
+      job.callback(job.path, result);
+    }
+
+    lock.lock();
+
+    free_buffers.push_back(std::move(job.save_state));
+    busy = false;
+
+    if(jobs.empty()) {
+      cv_idle.notify_all();
+    }
+  }
+}
+
+} // namespace nba
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <cstring>
+#include <fstream>
+#include <platform/writer/movie.hpp>
+#include <vector>
+
+namespace nba {
+
+template<typename T>
+static void Append(std::vector<u8>& data, T value) {
+  const size_t offset = data.size();
+
+  data.resize(offset + sizeof(T));
+  std::memcpy(&data[offset], &value, sizeof(T));
+}
+
+auto MovieWriter::Write(
+  Movie const& movie,
+  fs::path const& path
+) -> Result {
+  std::vector<u8> data;
+
+  /**
+   * Header (48 bytes):
+   *   u32 magic, u32 version, u32 flags, u32 ROM CRC32, s64 RTC seed,
+   *   u64 frame count, u32 checkpoint count, u32 start state size, u32 start backup size, u32 reserved
+   * followed by the start state, the start backup, the key mask of each frame (u16)
+   * and the checkpoints (u64 frame, u64 state hash).
+   */
+  Append<u32>(data, Movie::kMagicNumber);
+  Append<u32>(data, Movie::kFormatVersion);
+  Append<u32>(data, movie.skip_bios ? 1 : 0);
+  Append<u32>(data, movie.rom_crc32);
+  Append<s64>(data, movie.rtc_seed);
+  Append<u64>(data, movie.frames.size());
+  Append<u32>(data, (u32)movie.checkpoints.size());
+  Append<u32>(data, (u32)movie.start_state.size());
+  Append<u32>(data, (u32)movie.start_backup.size());
+  Append<u32>(data, 0);
+
+  data.insert(data.end(), movie.start_state.begin(), movie.start_state.end());
+  data.insert(data.end(), movie.start_backup.begin(), movie.start_backup.end());
+
+  for(u16 keys : movie.frames) {
+    Append<u16>(data, keys);
+  }
+
+  for(auto& checkpoint : movie.checkpoints) {
+    Append<u64>(data, checkpoint.frame);
+    Append<u64>(data, checkpoint.state_hash);
+  }
+
+  std::ofstream file_stream{path.c_str(), std::ios::binary};
+
+  if(!file_stream.good()) {
+    return Result::CannotOpenFile;
+  }
+
+  file_stream.write((const char*)data.data(), data.size());
+  file_stream.flush();
+
+  if(!file_stream.good()) {
+    return Result::CannotWrite;
+  }
+
+  return Result::Success;
+}
+
+} // namespace nba
@@ -5,8 +5,11 @@
  * Refer to the included LICENSE file.
  */
 
-#include <fstream>
+#include <memory>
+#include <nba/common/atomic_write.hpp>
+#include <platform/save_state_file.hpp>
 #include <platform/writer/save_state.hpp>
+#include <vector>
 
 namespace nba {
 
@@ -14,22 +17,26 @@ auto SaveStateWriter::Write(
   std::unique_ptr<CoreBase>& core,
   fs::path const& path
 ) -> Result {
-  std::ofstream file_stream{path.c_str(), std::ios::binary};
+  auto save_state = MakeSaveState();
+  core->CopyState(*save_state);
 
-  if(!file_stream.good()) {
-    return Result::CannotOpenFile;
-  }
+  return Write(*save_state, path);
+}
 
-  SaveState save_state;
-  core->CopyState(save_state);
+auto SaveStateWriter::Write(
+  SaveState const& save_state,
+  fs::path const& path
+) -> Result {
+  std::vector<u8> data;
 
-  file_stream.write((const char*)&save_state, sizeof(SaveState));
-  
-  if(!file_stream.good()) {
-    return Result::CannotWrite;
-  }
+  SaveStateFile::Encode(save_state, data);
 
-  return Result::Success;
+  switch(WriteFileAtomic(path, data.data(), data.size())) {
+    case WriteFileResult::CannotOpenFile:    return Result::CannotOpenFile;
+    case WriteFileResult::CannotWrite:       return Result::CannotWrite;
+    case WriteFileResult::CannotReplaceFile: return Result::CannotReplaceFile;
+    default:                                 return Result::Success;
+  }
 }
 
-} // namespace nba
\ No newline at end of file
+} // namespace nba
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <nba/common/punning.hpp>
+#include <platform/writer/stems.hpp>
+
+namespace nba {
+
+auto StemWriter::Open(fs::path const& path) -> Result {
+  file_stream.open(path.c_str(), std::ios::binary | std::ios::trunc);
+
+  if(!file_stream.good()) {
+    return Result::CannotOpenFile;
+  }
+
+  dropped_frames = 0;
+  return WriteHeader();
+}
+
+auto StemWriter::Drain(StemCapture& capture) -> Result {
+  const int available = capture.Available();
+
+  dropped_frames = capture.GetDroppedFrameCount();
+
+  if(available == 0) {
+    return Result::Success;
+  }
+
+  frames.resize(available);
+  sample_rates.resize(available);
+
+  for(int i = 0; i < available; i++) {
+    capture.Read(frames[i], sample_rates[i]);
+  }
+
+  size_t begin = 0;
+
+  for(size_t i = 1; i <= frames.size(); i++) {
+    if(i == frames.size() || sample_rates[i] != sample_rates[begin]) {
+      WriteBlock(sample_rates[begin], begin, i);
+      begin = i;
+    }
+  }
+
+  if(!file_stream.good()) {
+    return Result::CannotWrite;
+  }
+
+  return Result::Success;
+}
+
+auto StemWriter::Close() -> Result {
+  // Patch the header now that the number of dropped frames is known.
+  file_stream.seekp(0);
+
+  auto result = WriteHeader();
+
+  file_stream.close();
+  return result;
+}
+
+auto StemWriter::WriteHeader() -> Result {
+  u8 header[kHeaderSize];
+
+  write<u32>(header,  0, kMagicNumber);
+  write<u32>(header,  4, kCurrentVersion);
+  write<u32>(header,  8, StemCapture::kStemCount);
+  write<u64>(header, 12, dropped_frames);
+
+  file_stream.write((char const*)header, sizeof(header));
+
+  if(!file_stream.good()) {
+    return Result::CannotWrite;
+  }
+
+  return Result::Success;
+}
+
+void StemWriter::WriteBlock(int sample_rate, size_t begin, size_t end) {
+  u8 block_header[8];
+
+  write<u32>(block_header, 0, (u32)sample_rate);
+  write<u32>(block_header, 4, (u32)(end - begin));
+
+  file_stream.write((char const*)block_header, sizeof(block_header));
+  file_stream.write((char const*)&frames[begin], (end - begin) * sizeof(StemCapture::Frame));
+}
+
+} // namespace nba
@@ -97,6 +97,16 @@ struct QtConfig final : nba::PlatformConfig {
     nba::PlatformConfig::Save(config_path);
   }
 
+  // The ROM analysis cache lives next to the configuration file.
+  auto GetROMAnalysisCachePath() const -> std::string {
+    return (fs::path{config_path}.parent_path() / "rom_analysis.bin").string();
+  }
+
+  // So does the directory of ROMs extracted from archives.
+  auto GetArchiveCachePath() const -> std::string {
+    return (fs::path{config_path}.parent_path() / "archive_cache").string();
+  }
+
   void UpdateRecentFiles(std::u16string const& path) {
     const auto absolute_path = fs::absolute((fs::path)path).string();
 
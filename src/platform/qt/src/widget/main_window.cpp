@@ -45,6 +45,23 @@ MainWindow::MainWindow(
 
   config->Load();
 
+  rom_analysis_cache = std::make_unique<nba::ROMAnalysisCache>(config->GetROMAnalysisCachePath());
+
+  if(config->archive_cache.enable) {
+    archive_cache = std::make_unique<nba::ArchiveCache>(
+      config->GetArchiveCachePath(), (u64)std::max(config->archive_cache.size_limit_mib, 0) << 20);
+
+    if(config->archive_cache.prefetch_recent) {
+      auto archive_paths = std::vector<fs::path>{};
+
+      for(auto& path : config->recent_files) {
+        archive_paths.push_back(QString::fromStdString(path).toStdU16String());
+      }
+
+      archive_cache->Prefetch(archive_paths);
+    }
+  }
+
   auto menu_bar = new QMenuBar(this);
   setMenuBar(menu_bar);
 
@@ -58,6 +75,7 @@ MainWindow::MainWindow(
   config->input_dev = input_device;
   core = nba::CreateCore(config);
   emu_thread = std::make_unique<nba::EmulatorThread>(core);
+  emu_thread->SetRunAheadFrames(config->run_ahead_frames);
 
   app->installEventFilter(this);
 
@@ -77,6 +95,19 @@ MainWindow::MainWindow(
     }
   }, Qt::QueuedConnection);
 
+  connect(this, &MainWindow::SaveStateWritten, this, [this](int result) {
+    if((nba::SaveStateWriter::Result)result != nba::SaveStateWriter::Result::Success) {
+      QMessageBox box {this};
+      box.setIcon(QMessageBox::Critical);
+      box.setText(tr("Sorry, the save state could not be written to the disk. Make sure that you have sufficient disk space and permissions."));
+      box.setWindowTitle(tr("Failed to write to the disk"));
+      box.exec();
+    }
+
+    // The save state slots show the modification date of the files.
+    RenderSaveStateMenus();
+  }, Qt::QueuedConnection);
+
   UpdateWindowSize();
 }
 
@@ -86,6 +117,7 @@ MainWindow::~MainWindow() {
   (new QMainWindow{})->setCentralWidget(screen.get());
 
   emu_thread->Stop();
+  save_state_writer.Flush();
 
   delete controller_manager;
 }
@@ -399,6 +431,15 @@ void MainWindow::CreateToolsMenu() {
 
     background_viewer_window->show();
   });
+
+  connect(tools_menu->addAction(tr("Memory Search")), &QAction::triggered, [this]() {
+    if(!memory_search_window) {
+      memory_search_window = new MemorySearchWindow{core.get(), this};
+      connect(screen.get(), &Screen::RequestDraw, memory_search_window, &MemorySearchWindow::Update);
+    }
+
+    memory_search_window->show();
+  });
 }
 
 void MainWindow::CreateHelpMenu() {
@@ -506,7 +547,6 @@ void MainWindow::RenderSaveStateMenus() {
 
       connect(action_save, &QAction::triggered, [=]() {
         SaveState(slot_filename);
-        RenderSaveStateMenus();
       });
     }
   }
@@ -773,7 +813,7 @@ void MainWindow::LoadROM(std::u16string const& path) {
   auto save_path = GetSavePath(fs::path{path}, ".sav");
   auto save_type = config->cartridge.backup_type;
 
-  auto result = nba::ROMLoader::Load(core, path, save_path, save_type, force_gpio);
+  auto result = nba::ROMLoader::Load(core, path, save_path, save_type, force_gpio, rom_analysis_cache.get(), archive_cache.get());
 
   switch(result) {
     case nba::ROMLoader::Result::CannotFindFile: {
@@ -861,25 +901,13 @@ auto MainWindow::LoadState(std::u16string const& path) -> nba::SaveStateLoader::
   return result;
 }
 
-auto MainWindow::SaveState(std::u16string const& path) -> nba::SaveStateWriter::Result {
-  bool was_running = emu_thread->IsRunning();
-  emu_thread->Stop();
-
-  auto result = nba::SaveStateWriter::Write(core, path);
-
-  if(result != nba::SaveStateWriter::Result::Success) {
-    QMessageBox box {this};
-    box.setIcon(QMessageBox::Critical);
-    box.setText(tr("Sorry, the save state could not be written to the disk. Make sure that you have sufficient disk space and permissions."));
-    box.setWindowTitle(tr("Failed to write to the disk"));
-    box.exec();
-  }
-
-  if(was_running) {
-    emu_thread->Start();
-  }
-
-  return result;
+void MainWindow::SaveState(std::u16string const& path) {
+  // Only the state is captured on the emulator thread, the file is written in the background.
+  emu_thread->Invoke([this, path]() {
+    save_state_writer.Write(*core, path, [this](fs::path const& path, nba::SaveStateWriter::Result result) {
+      emit SaveStateWritten((int)result);
+    });
+  });
 }
 
 auto MainWindow::GetSavePath(fs::path const& rom_path, fs::path const& extension) -> fs::path {
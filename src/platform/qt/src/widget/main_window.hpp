@@ -13,8 +13,11 @@
 #include <filesystem>
 #include <nba/core.hpp>
 #include <platform/loader/save_state.hpp>
+#include <platform/writer/async_save_state.hpp>
 #include <platform/writer/save_state.hpp>
+#include <platform/archive_cache.hpp>
 #include <platform/emulator_thread.hpp>
+#include <platform/rom_analysis_cache.hpp>
 #include <memory>
 #include <QMainWindow>
 #include <QActionGroup>
@@ -25,6 +28,7 @@
 #include "widget/background_viewer_window.hpp"
 #include "widget/controller_manager.hpp"
 #include "widget/input_window.hpp"
+#include "widget/memory_search_window.hpp"
 #include "widget/palette_viewer_window.hpp"
 #include "widget/screen.hpp"
 #include "config.hpp"
@@ -41,6 +45,7 @@ struct MainWindow : QMainWindow {
 
 signals:
   void UpdateFrameRate(int fps);
+  void SaveStateWritten(int result);
 
 private slots:
   void FileOpen();
@@ -125,7 +130,7 @@ private:
   void UpdateSolarSensorLevel();
 
   auto LoadState(std::u16string const& path) -> nba::SaveStateLoader::Result;
-  auto SaveState(std::u16string const& path) -> nba::SaveStateWriter::Result;
+  void SaveState(std::u16string const& path);
 
   auto GetSavePath(fs::path const& rom_path, fs::path const& extension) -> fs::path;
 
@@ -134,6 +139,9 @@ private:
   std::shared_ptr<QtConfig> config = std::make_shared<QtConfig>();
   std::unique_ptr<nba::CoreBase> core;
   std::unique_ptr<nba::EmulatorThread> emu_thread;
+  nba::AsyncSaveStateWriter save_state_writer;
+  std::unique_ptr<nba::ROMAnalysisCache> rom_analysis_cache;
+  std::unique_ptr<nba::ArchiveCache> archive_cache;
   bool key_input[2][nba::InputDevice::kKeyCount] {false};
   bool fast_forward[2] {false};
   ControllerManager* controller_manager;
@@ -152,6 +160,7 @@ private:
 
   PaletteViewerWindow* palette_viewer_window;
   BackgroundViewerWindow* background_viewer_window;
+  MemorySearchWindow* memory_search_window = nullptr;
 
   QString base_window_title;
 
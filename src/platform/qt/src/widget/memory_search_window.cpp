@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <fmt/format.h>
+#include <QFontDatabase>
+#include <QGridLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QVBoxLayout>
+
+#include "memory_search_window.hpp"
+
+using Width = nba::MemorySearch::Width;
+using Condition = nba::MemorySearch::Condition;
+
+MemorySearchWindow::MemorySearchWindow(nba::CoreBase* core, QWidget* parent) : QDialog(parent), core(core) {
+  const auto vbox = new QVBoxLayout{};
+
+  width_combo_box = new QComboBox{};
+  width_combo_box->addItem(tr("8-bit"),  (int)Width::Byte);
+  width_combo_box->addItem(tr("16-bit"), (int)Width::Half);
+  width_combo_box->addItem(tr("32-bit"), (int)Width::Word);
+
+  // The order matches nba::MemorySearch::Condition.
+  condition_combo_box = new QComboBox{};
+  condition_combo_box->addItem(tr("Equal to A"));
+  condition_combo_box->addItem(tr("Not equal to A"));
+  condition_combo_box->addItem(tr("Changed"));
+  condition_combo_box->addItem(tr("Unchanged"));
+  condition_combo_box->addItem(tr("Increased"));
+  condition_combo_box->addItem(tr("Decreased"));
+  condition_combo_box->addItem(tr("Increased by A"));
+  condition_combo_box->addItem(tr("Decreased by A"));
+  condition_combo_box->addItem(tr("In range A to B"));
+
+  connect(condition_combo_box, QOverload<int>::of(&QComboBox::currentIndexChanged), [this](int) {
+    UpdateOperandInputs();
+  });
+
+  operand_a_edit = new QLineEdit{};
+  operand_b_edit = new QLineEdit{};
+  operand_a_edit->setPlaceholderText(tr("e.g. 100 or 0x64"));
+  operand_b_edit->setPlaceholderText(tr("e.g. 100 or 0x64"));
+
+  const auto grid = new QGridLayout{};
+  grid->addWidget(new QLabel{tr("Width:")}, 0, 0);
+  grid->addWidget(width_combo_box, 0, 1);
+  grid->addWidget(new QLabel{tr("Condition:")}, 1, 0);
+  grid->addWidget(condition_combo_box, 1, 1);
+  grid->addWidget(new QLabel{tr("A:")}, 2, 0);
+  grid->addWidget(operand_a_edit, 2, 1);
+  grid->addWidget(new QLabel{tr("B:")}, 3, 0);
+  grid->addWidget(operand_b_edit, 3, 1);
+  grid->setColumnStretch(1, 1);
+
+  const auto start_button = new QPushButton{tr("New Search")};
+  filter_button = new QPushButton{tr("Filter")};
+  filter_button->setEnabled(false);
+
+  connect(start_button, &QPushButton::clicked, [this]() { StartSearch(); });
+  connect(filter_button, &QPushButton::clicked, [this]() { FilterSearch(); });
+
+  const auto buttons_hbox = new QHBoxLayout{};
+  buttons_hbox->addWidget(start_button);
+  buttons_hbox->addWidget(filter_button);
+
+  status_label = new QLabel{tr("Start a new search to snapshot EWRAM and IWRAM.")};
+
+  candidate_table = new QTableWidget{0, 3};
+  candidate_table->setHorizontalHeaderLabels({tr("Address"), tr("Previous"), tr("Current")});
+  candidate_table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+  candidate_table->verticalHeader()->hide();
+  candidate_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+  candidate_table->setSelectionBehavior(QAbstractItemView::SelectRows);
+  candidate_table->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+  candidate_table->setMinimumSize(360, 300);
+
+  vbox->addLayout(grid);
+  vbox->addLayout(buttons_hbox);
+  vbox->addWidget(status_label);
+  vbox->addWidget(candidate_table);
+
+  setLayout(vbox);
+  setWindowTitle(tr("Memory Search"));
+  setWindowFlags(windowFlags() & ~Qt::WindowContextHelpButtonHint);
+
+  UpdateOperandInputs();
+}
+
+void MemorySearchWindow::Update() {
+  if(!isVisible() || candidates.empty()) {
+    return;
+  }
+
+  core->Gather(reads.data(), values.data(), reads.size());
+
+  const int digits = (int)search.GetWidth() * 2;
+
+  for(size_t i = 0; i < candidates.size(); i++) {
+    candidate_table->item((int)i, 2)->setText(QString::fromStdString(fmt::format("0x{:0{}X}", values[i], digits)));
+  }
+}
+
+void MemorySearchWindow::StartSearch() {
+  search.Start(*core, (Width)width_combo_box->currentData().toInt());
+  filter_button->setEnabled(true);
+  UpdateCandidateList();
+}
+
+void MemorySearchWindow::FilterSearch() {
+  const auto condition = (Condition)condition_combo_box->currentIndex();
+
+  u32 a = 0;
+  u32 b = 0;
+
+  if(operand_a_edit->isEnabled() && !ParseOperand(operand_a_edit, a)) {
+    status_label->setText(tr("Operand A is not a valid number."));
+    return;
+  }
+
+  if(operand_b_edit->isEnabled() && !ParseOperand(operand_b_edit, b)) {
+    status_label->setText(tr("Operand B is not a valid number."));
+    return;
+  }
+
+  search.Filter(*core, condition, a, b);
+  UpdateCandidateList();
+}
+
+void MemorySearchWindow::UpdateCandidateList() {
+  const size_t count = search.GetCandidateCount();
+  const int size = (int)search.GetWidth();
+  const int digits = size * 2;
+
+  candidates = search.GetCandidates(kMaxDisplayedCandidates);
+  reads.clear();
+
+  for(auto& candidate : candidates) {
+    reads.push_back({candidate.address, size});
+  }
+
+  values.resize(reads.size());
+  core->Gather(reads.data(), values.data(), reads.size());
+
+  candidate_table->setRowCount((int)candidates.size());
+
+  for(size_t i = 0; i < candidates.size(); i++) {
+    const int row = (int)i;
+
+    candidate_table->setItem(row, 0, new QTableWidgetItem{QString::fromStdString(fmt::format("0x{:08X}", candidates[i].address))});
+    candidate_table->setItem(row, 1, new QTableWidgetItem{QString::fromStdString(fmt::format("0x{:0{}X}", candidates[i].previous_value, digits))});
+    candidate_table->setItem(row, 2, new QTableWidgetItem{QString::fromStdString(fmt::format("0x{:0{}X}", values[i], digits))});
+  }
+
+  if(count > candidates.size()) {
+    status_label->setText(tr("%1 candidates (showing the first %2)").arg(count).arg(candidates.size()));
+  } else {
+    status_label->setText(tr("%1 candidates").arg(count));
+  }
+}
+
+void MemorySearchWindow::UpdateOperandInputs() {
+  switch((Condition)condition_combo_box->currentIndex()) {
+    case Condition::Equal:
+    case Condition::NotEqual:
+    case Condition::IncreasedBy:
+    case Condition::DecreasedBy:
+      operand_a_edit->setEnabled(true);
+      operand_b_edit->setEnabled(false);
+      break;
+    case Condition::InRange:
+      operand_a_edit->setEnabled(true);
+      operand_b_edit->setEnabled(true);
+      break;
+    default:
+      operand_a_edit->setEnabled(false);
+      operand_b_edit->setEnabled(false);
+      break;
+  }
+}
+
+auto MemorySearchWindow::ParseOperand(QLineEdit* edit, u32& value) -> bool {
+  bool ok;
+
+  // Base 0 accepts decimal as well as hexadecimal with a 0x prefix.
+  value = edit->text().trimmed().toUInt(&ok, 0);
+  return ok;
+}
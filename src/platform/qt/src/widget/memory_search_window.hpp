@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <nba/core.hpp>
+#include <platform/memory_search.hpp>
+#include <QComboBox>
+#include <QDialog>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QTableWidget>
+#include <vector>
+
+struct MemorySearchWindow : QDialog {
+  MemorySearchWindow(nba::CoreBase* core, QWidget* parent = nullptr);
+
+public slots:
+  void Update();
+
+private:
+  static constexpr int kMaxDisplayedCandidates = 1000;
+
+  void StartSearch();
+  void FilterSearch();
+  void UpdateCandidateList();
+  void UpdateOperandInputs();
+
+  auto ParseOperand(QLineEdit* edit, u32& value) -> bool;
+
+  nba::CoreBase* core;
+  nba::MemorySearch search;
+
+  std::vector<nba::MemorySearch::Candidate> candidates;
+  std::vector<nba::CoreBase::MemoryRead> reads;
+  std::vector<u32> values;
+
+  QComboBox* width_combo_box;
+  QComboBox* condition_combo_box;
+  QLineEdit* operand_a_edit;
+  QLineEdit* operand_b_edit;
+  QPushButton* filter_button;
+  QLabel* status_label;
+  QTableWidget* candidate_table;
+
+  Q_OBJECT
+};
@@ -0,0 +1,209 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fmt/format.h>
+#include <memory>
+#include <platform/loader/bios.hpp>
+#include <platform/loader/rom.hpp>
+#include <platform/lockstep_checker.hpp>
+#include <random>
+#include <string>
+
+using namespace nba;
+
+static void PrintUsage() {
+  fmt::print(
+    "Usage: nba-lockstep <rom> [options]\n"
+    "Runs two instances of the core with identical input and reports the first divergence.\n\n"
+    "  --bios <path>          BIOS image, the boot screen is skipped if none is given\n"
+    "  --frames <n>           number of frames to emulate (default: 3600)\n"
+    "  --interval <cycles>    compare every <cycles> cycles instead of every frame\n"
+    "  --compare <list>       compared components: cpu,memory,io,audio,scheduler (default: all)\n"
+    "  --input-seed <n>       seed for the random input, 0 disables input (default: 1)\n"
+    "  --b-mp2k-hle           enable MP2K HLE audio in the second instance\n"
+    "  --b-interpolation <n>  interpolation of the second instance: cosine, cubic, sinc32, sinc64, sinc128, sinc256\n"
+    "  --b-no-coalescing      disable timer overflow coalescing in the second instance,\n"
+    "                         the scheduler is only compared if it is listed in --compare\n"
+  );
+}
+
+static auto ParseComponents(std::string const& list) -> u32 {
+  u32 components = 0;
+  size_t begin = 0;
+
+  while(begin <= list.size()) {
+    size_t end = list.find(',', begin);
+
+    if(end == std::string::npos) {
+      end = list.size();
+    }
+
+    const auto name = list.substr(begin, end - begin);
+
+    if(name == "cpu") components |= LockstepChecker::CPU;
+    else if(name == "memory") components |= LockstepChecker::Memory;
+    else if(name == "io") components |= LockstepChecker::IO;
+    else if(name == "audio") components |= LockstepChecker::Audio;
+    else if(name == "scheduler") components |= LockstepChecker::Scheduler;
+    else if(name == "all") components |= LockstepChecker::All;
+    else {
+      fmt::print("unknown component: {}\n", name);
+      std::exit(EXIT_FAILURE);
+    }
+
+    begin = end + 1;
+  }
+
+  return components;
+}
+
+static auto ParseInterpolation(std::string const& name) -> Config::Audio::Interpolation {
+  using Interpolation = Config::Audio::Interpolation;
+
+  if(name == "cosine") return Interpolation::Cosine;
+  if(name == "cubic") return Interpolation::Cubic;
+  if(name == "sinc32") return Interpolation::Sinc_32;
+  if(name == "sinc64") return Interpolation::Sinc_64;
+  if(name == "sinc128") return Interpolation::Sinc_128;
+  if(name == "sinc256") return Interpolation::Sinc_256;
+
+  fmt::print("unknown interpolation: {}\n", name);
+  std::exit(EXIT_FAILURE);
+}
+
+int main(int argc, char** argv) {
+  if(argc < 2 || std::strcmp(argv[1], "--help") == 0) {
+    PrintUsage();
+    return argc < 2 ? EXIT_FAILURE : EXIT_SUCCESS;
+  }
+
+  const char* rom_path = argv[1];
+  const char* bios_path = nullptr;
+  u64 frames = 3600;
+  int interval = CoreBase::kCyclesPerFrame;
+  u32 components = LockstepChecker::All;
+  bool scheduler_requested = false;
+  u32 input_seed = 1;
+
+  auto config_a = std::make_shared<Config>();
+  auto config_b = std::make_shared<Config>();
+
+  for(int i = 2; i < argc; i++) {
+    const std::string option = argv[i];
+    const bool has_value = i + 1 < argc;
+
+    if(option == "--bios" && has_value) {
+      bios_path = argv[++i];
+    } else if(option == "--frames" && has_value) {
+      frames = std::strtoull(argv[++i], nullptr, 0);
+    } else if(option == "--interval" && has_value) {
+      interval = std::max(std::atoi(argv[++i]), 1);
+    } else if(option == "--compare" && has_value) {
+      const std::string list = argv[++i];
+
+      components = ParseComponents(list);
+      scheduler_requested = list.find("scheduler") != std::string::npos;
+    } else if(option == "--input-seed" && has_value) {
+      input_seed = (u32)std::strtoul(argv[++i], nullptr, 0);
+    } else if(option == "--b-mp2k-hle") {
+      config_b->audio.mp2k_hle_enable = true;
+    } else if(option == "--b-interpolation" && has_value) {
+      config_b->audio.interpolation = ParseInterpolation(argv[++i]);
+    } else if(option == "--b-no-coalescing") {
+      config_b->timer_coalescing = false;
+    } else {
+      PrintUsage();
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Coalesced timer overflows are not scheduled as individual events, so the pending events always differ.
+  if(config_a->timer_coalescing != config_b->timer_coalescing && (components & LockstepChecker::Scheduler)) {
+    if(scheduler_requested) {
+      fmt::print("warning: the scheduler always diverges if only one instance coalesces timer overflows\n");
+    } else {
+      components &= ~LockstepChecker::Scheduler;
+    }
+  }
+
+  auto input_a = std::make_shared<BasicInputDevice>();
+  auto input_b = std::make_shared<BasicInputDevice>();
+
+  config_a->input_dev = input_a;
+  config_b->input_dev = input_b;
+
+  /**
+   * Both instances are cloned from a core that is never run. This gives them the exact same initial state,
+   * and their backup memory is kept in memory, so that neither instance writes to the save file.
+   */
+  auto config = std::make_shared<Config>();
+
+  config->skip_bios = bios_path == nullptr;
+
+  std::unique_ptr<CoreBase> core = CreateCore(config);
+
+  if(bios_path && BIOSLoader::Load(core, bios_path) != BIOSLoader::Result::Success) {
+    fmt::print("cannot load BIOS: {}\n", bios_path);
+    return EXIT_FAILURE;
+  }
+
+  if(ROMLoader::Load(core, rom_path) != ROMLoader::Result::Success) {
+    fmt::print("cannot load ROM: {}\n", rom_path);
+    return EXIT_FAILURE;
+  }
+
+  core->Reset();
+
+  auto core_a = core->Clone(config_a);
+  auto core_b = core->Clone(config_b);
+
+  LockstepChecker checker{*core_a, *core_b, components};
+
+  std::mt19937 random{input_seed};
+
+  const u64 cycles = frames * CoreBase::kCyclesPerFrame;
+  u64 cycles_run = 0;
+  u64 next_input_change = 0;
+
+  while(cycles_run < cycles) {
+    // Change the input every 8 frames, so that games see both key presses and releases.
+    if(input_seed != 0 && cycles_run >= next_input_change) {
+      const u32 keys = random();
+
+      for(int key = 0; key < InputDevice::kKeyCount; key++) {
+        const bool pressed = (keys >> key) & 1;
+
+        input_a->SetKeyStatus((InputDevice::Key)key, pressed);
+        input_b->SetKeyStatus((InputDevice::Key)key, pressed);
+      }
+
+      next_input_change += 8 * CoreBase::kCyclesPerFrame;
+    }
+
+    const int step_cycles = (int)std::min<u64>(interval, cycles - cycles_run);
+
+    if(!checker.Step(step_cycles)) {
+      auto& divergence = checker.GetDivergence();
+
+      fmt::print("divergence in step {} (cycle {}, frame {}):\n",
+        divergence.step, divergence.timestamp, divergence.timestamp / CoreBase::kCyclesPerFrame);
+
+      for(auto& difference : divergence.differences) {
+        fmt::print("  {}\n", difference);
+      }
+      return EXIT_FAILURE;
+    }
+
+    cycles_run += step_cycles;
+  }
+
+  fmt::print("no divergence in {} steps ({} frames)\n", checker.GetStepCount(), frames);
+  return EXIT_SUCCESS;
+}
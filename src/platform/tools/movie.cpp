@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fmt/format.h>
+#include <memory>
+#include <platform/loader/bios.hpp>
+#include <platform/loader/movie.hpp>
+#include <platform/loader/rom.hpp>
+#include <platform/writer/movie.hpp>
+#include <random>
+#include <string>
+
+using namespace nba;
+
+namespace fs = std::filesystem;
+
+// Removes the save file once it is no longer used, i.e. it must outlive the core that uses it.
+struct ThrowawaySaveFile {
+  fs::path path;
+
+  ~ThrowawaySaveFile() {
+    std::error_code error;
+    fs::remove(path, error);
+  }
+};
+
+static void PrintUsage() {
+  fmt::print(
+    "Usage: nba-movie record <rom> <movie> [options]\n"
+    "       nba-movie play <rom> <movie> [options]\n"
+    "Records a movie with random input, or plays a movie back as fast as possible and checks it for desyncs.\n"
+    "The save file of the game is neither read nor written, recordings start without save data.\n\n"
+    "  --bios <path>          BIOS image, the boot screen is skipped if none is given\n"
+    "  --frames <n>           number of frames to record (default: 3600)\n"
+    "  --input-seed <n>       seed for the random input, 0 disables input (default: 1)\n"
+    "  --rtc-seed <n>         RTC time at power-on in seconds since the epoch (default: current time)\n"
+    "  --checkpoint <n>       frames between state hash checkpoints (default: 60)\n"
+  );
+}
+
+int main(int argc, char** argv) {
+  if(argc < 4) {
+    PrintUsage();
+    return EXIT_FAILURE;
+  }
+
+  const std::string mode = argv[1];
+  const char* rom_path = argv[2];
+  const char* movie_path = argv[3];
+  const char* bios_path = nullptr;
+  u64 frames = 3600;
+  u32 input_seed = 1;
+  int checkpoint_interval = 60;
+
+  auto config = std::make_shared<Config>();
+  auto input = std::make_shared<MovieInputDevice>();
+
+  config->input_dev = input;
+
+  if(mode != "record" && mode != "play") {
+    PrintUsage();
+    return EXIT_FAILURE;
+  }
+
+  for(int i = 4; i < argc; i++) {
+    const std::string option = argv[i];
+    const bool has_value = i + 1 < argc;
+
+    if(option == "--bios" && has_value) {
+      bios_path = argv[++i];
+    } else if(option == "--frames" && has_value) {
+      frames = std::strtoull(argv[++i], nullptr, 0);
+    } else if(option == "--input-seed" && has_value) {
+      input_seed = (u32)std::strtoul(argv[++i], nullptr, 0);
+    } else if(option == "--rtc-seed" && has_value) {
+      config->rtc_seed = std::strtoll(argv[++i], nullptr, 0);
+    } else if(option == "--checkpoint" && has_value) {
+      checkpoint_interval = std::atoi(argv[++i]);
+    } else {
+      PrintUsage();
+      return EXIT_FAILURE;
+    }
+  }
+
+  config->skip_bios = bios_path == nullptr;
+
+  // Playing a movie restores its own backup memory, which the core would write to the save file of the game.
+  ThrowawaySaveFile save_file{
+    fs::temp_directory_path() / fmt::format("nba-movie-{:08x}.sav", std::random_device{}())
+  };
+
+  std::unique_ptr<CoreBase> core = CreateCore(config);
+
+  if(bios_path && BIOSLoader::Load(core, bios_path) != BIOSLoader::Result::Success) {
+    fmt::print("cannot load BIOS: {}\n", bios_path);
+    return EXIT_FAILURE;
+  }
+
+  if(ROMLoader::Load(core, rom_path, save_file.path) != ROMLoader::Result::Success) {
+    fmt::print("cannot load ROM: {}\n", rom_path);
+    return EXIT_FAILURE;
+  }
+
+  if(mode == "record") {
+    MovieRecorder recorder{*core, config, *input, checkpoint_interval};
+    std::mt19937 random{input_seed};
+    u16 keys = 0;
+
+    recorder.Start(true);
+
+    for(u64 frame = 0; frame < frames; frame++) {
+      // Change the input every 8 frames, so that games see both key presses and releases.
+      if(input_seed != 0 && frame % 8 == 0) {
+        keys = (u16)(random() & ((1 << InputDevice::kKeyCount) - 1));
+      }
+
+      recorder.RunFrame(keys);
+    }
+
+    if(MovieWriter::Write(recorder.GetMovie(), movie_path) != MovieWriter::Result::Success) {
+      fmt::print("cannot write movie: {}\n", movie_path);
+      return EXIT_FAILURE;
+    }
+
+    fmt::print("recorded {} frames\n", frames);
+    return EXIT_SUCCESS;
+  }
+
+  Movie movie;
+
+  if(MovieLoader::Load(movie, movie_path) != MovieLoader::Result::Success) {
+    fmt::print("cannot load movie: {}\n", movie_path);
+    return EXIT_FAILURE;
+  }
+
+  if(movie.skip_bios != config->skip_bios) {
+    fmt::print("warning: the movie was recorded {} a BIOS image\n", movie.skip_bios ? "without" : "with");
+  }
+
+  MoviePlayer player{*core, config, *input, movie};
+
+  if(player.Start() != MoviePlayer::Result::Success) {
+    fmt::print("cannot play movie: the ROM does not match or the start state is invalid\n");
+    return EXIT_FAILURE;
+  }
+
+  const auto t0 = std::chrono::steady_clock::now();
+  const auto status = player.RunToEnd();
+  const auto t1 = std::chrono::steady_clock::now();
+
+  const double seconds = std::chrono::duration<double>(t1 - t0).count();
+
+  if(status == MoviePlayer::Status::Desync) {
+    fmt::print("desync at frame {}\n", player.GetDesyncFrame());
+    return EXIT_FAILURE;
+  }
+
+  fmt::print("played {} frames in {:.3f} s ({:.1f} fps), {} checkpoints matched\n",
+    player.GetFrame(), seconds, player.GetFrame() / seconds, movie.checkpoints.size());
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,203 @@
+/*
+ * Copyright (C) 2023 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <cstdlib>
+#include <fmt/format.h>
+#include <memory>
+#include <platform/loader/bios.hpp>
+#include <platform/loader/rom.hpp>
+#include <platform/stem_compare.hpp>
+#include <platform/writer/stems.hpp>
+#include <random>
+#include <string>
+
+using namespace nba;
+
+static void PrintUsage() {
+  fmt::print(
+    "Usage: nba-stems record <rom> <stems> [options]\n"
+    "       nba-stems compare <golden> <actual> [options]\n"
+    "Captures the output of each audio channel before it is mixed, or compares two captures.\n\n"
+    "  --bios <path>          BIOS image, the boot screen is skipped if none is given\n"
+    "  --frames <n>           number of frames to record (default: 3600)\n"
+    "  --input-seed <n>       seed for the random input, 0 disables input (default: 0)\n"
+    "  --mp2k-hle             enable MP2K HLE audio\n"
+    "  --tolerance <x>        largest peak difference for captures to match (default: 0)\n"
+  );
+}
+
+static auto Record(
+  const char* rom_path,
+  const char* stems_path,
+  const char* bios_path,
+  u64 frames,
+  u32 input_seed,
+  bool mp2k_hle
+) -> int {
+  auto config = std::make_shared<Config>();
+
+  config->skip_bios = bios_path == nullptr;
+
+  std::unique_ptr<CoreBase> core = CreateCore(config);
+
+  if(bios_path && BIOSLoader::Load(core, bios_path) != BIOSLoader::Result::Success) {
+    fmt::print("cannot load BIOS: {}\n", bios_path);
+    return EXIT_FAILURE;
+  }
+
+  if(ROMLoader::Load(core, rom_path) != ROMLoader::Result::Success) {
+    fmt::print("cannot load ROM: {}\n", rom_path);
+    return EXIT_FAILURE;
+  }
+
+  core->Reset();
+
+  auto input = std::make_shared<BasicInputDevice>();
+  auto capture = std::make_shared<StemCapture>();
+  auto capture_config = std::make_shared<Config>(*config);
+
+  capture_config->input_dev = input;
+  capture_config->stem_capture = capture;
+  capture_config->audio.mp2k_hle_enable = mp2k_hle;
+
+  // The clone keeps its backup memory in memory, so that recording never writes to the save file.
+  auto capture_core = core->Clone(capture_config);
+
+  StemWriter writer;
+
+  if(writer.Open(stems_path) != StemWriter::Result::Success) {
+    fmt::print("cannot open stems file: {}\n", stems_path);
+    return EXIT_FAILURE;
+  }
+
+  std::mt19937 random{input_seed};
+
+  for(u64 frame = 0; frame < frames; frame++) {
+    // Change the input every 8 frames, so that games see both key presses and releases.
+    if(input_seed != 0 && frame % 8 == 0) {
+      const u32 keys = random();
+
+      for(int key = 0; key < InputDevice::kKeyCount; key++) {
+        input->SetKeyStatus((InputDevice::Key)key, (keys >> key) & 1);
+      }
+    }
+
+    capture_core->RunForOneFrame();
+
+    if(writer.Drain(*capture) != StemWriter::Result::Success) {
+      fmt::print("cannot write stems file: {}\n", stems_path);
+      return EXIT_FAILURE;
+    }
+  }
+
+  if(writer.Close() != StemWriter::Result::Success) {
+    fmt::print("cannot write stems file: {}\n", stems_path);
+    return EXIT_FAILURE;
+  }
+
+  if(capture->GetDroppedFrameCount() != 0) {
+    fmt::print("the capture is incomplete, {} frames were dropped\n", capture->GetDroppedFrameCount());
+    return EXIT_FAILURE;
+  }
+
+  fmt::print("recorded {} frames\n", frames);
+  return EXIT_SUCCESS;
+}
+
+static auto Compare(const char* golden_path, const char* actual_path, double tolerance) -> int {
+  static constexpr const char* kStemNames[StemCapture::kStemCount] {
+    "PSG1", "PSG2", "PSG3", "PSG4", "FIFO A", "FIFO B"
+  };
+
+  StemComparison comparison;
+
+  switch(StemComparator::Compare(golden_path, actual_path, comparison)) {
+    case StemComparator::Result::Success: break;
+    case StemComparator::Result::CannotOpenFile: {
+      fmt::print("cannot open the stems files\n");
+      return EXIT_FAILURE;
+    }
+    default: {
+      fmt::print("the stems files are invalid or truncated\n");
+      return EXIT_FAILURE;
+    }
+  }
+
+  fmt::print("compared {} frames\n", comparison.frame_count);
+
+  for(int stem = 0; stem < StemCapture::kStemCount; stem++) {
+    auto& result = comparison.stems[stem];
+
+    fmt::print("  {:<6}  rms {:.6f}  peak {:.6f} (frame {})\n",
+      kStemNames[stem], result.rms_difference, result.peak_difference, result.peak_frame);
+  }
+
+  if(comparison.golden_dropped_frames != 0 || comparison.actual_dropped_frames != 0) {
+    fmt::print("dropped frames: {} (golden), {} (actual)\n", comparison.golden_dropped_frames, comparison.actual_dropped_frames);
+  }
+
+  if(comparison.length_mismatch) {
+    fmt::print("the captures differ in length\n");
+  }
+
+  if(comparison.sample_rate_mismatch) {
+    fmt::print("the captures differ in sample rate\n");
+  }
+
+  if(!comparison.Matches(tolerance)) {
+    fmt::print("mismatch\n");
+    return EXIT_FAILURE;
+  }
+
+  fmt::print("match\n");
+  return EXIT_SUCCESS;
+}
+
+int main(int argc, char** argv) {
+  if(argc < 4) {
+    PrintUsage();
+    return EXIT_FAILURE;
+  }
+
+  const std::string mode = argv[1];
+  const char* bios_path = nullptr;
+  u64 frames = 3600;
+  u32 input_seed = 0;
+  bool mp2k_hle = false;
+  double tolerance = 0;
+
+  if(mode != "record" && mode != "compare") {
+    PrintUsage();
+    return EXIT_FAILURE;
+  }
+
+  for(int i = 4; i < argc; i++) {
+    const std::string option = argv[i];
+    const bool has_value = i + 1 < argc;
+
+    if(option == "--bios" && has_value) {
+      bios_path = argv[++i];
+    } else if(option == "--frames" && has_value) {
+      frames = std::strtoull(argv[++i], nullptr, 0);
+    } else if(option == "--input-seed" && has_value) {
+      input_seed = (u32)std::strtoul(argv[++i], nullptr, 0);
+    } else if(option == "--mp2k-hle") {
+      mp2k_hle = true;
+    } else if(option == "--tolerance" && has_value) {
+      tolerance = std::strtod(argv[++i], nullptr);
+    } else {
+      PrintUsage();
+      return EXIT_FAILURE;
+    }
+  }
+
+  if(mode == "record") {
+    return Record(argv[2], argv[3], bios_path, frames, input_seed, mp2k_hle);
+  }
+
+  return Compare(argv[2], argv[3], tolerance);
+}